@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// access_trace.cpp
+//
+// Identification: src/buffer/access_trace.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#include "buffer/access_trace.h"
+
+#include <array>
+#include <sstream>
+#include <string>
+
+#include "common/exception.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+namespace {
+
+// Indexed by AccessType.
+constexpr std::array<const char *, 3> ACCESS_TYPE_NAMES = {"unknown", "get", "scan"};
+
+}  // namespace
+
+void WriteAccessTrace(std::ostream &out, const std::vector<PageAccess> &trace) {
+  for (const auto &access : trace) {
+    out << access.page_id_ << ' ' << ACCESS_TYPE_NAMES[static_cast<size_t>(access.access_type_)] << '\n';
+  }
+}
+
+auto ReadAccessTrace(std::istream &in) -> std::vector<PageAccess> {
+  std::vector<PageAccess> trace;
+  std::string line;
+  for (size_t line_number = 1; std::getline(in, line); ++line_number) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream fields(line);
+    page_id_t page_id;
+    std::string type_name;
+    if (!(fields >> page_id >> type_name) || page_id < 0) {
+      throw Exception(fmt::format("malformed access trace line {}: {}", line_number, line));
+    }
+    size_t type = 0;
+    while (type < ACCESS_TYPE_NAMES.size() && type_name != ACCESS_TYPE_NAMES[type]) {
+      type++;
+    }
+    if (type == ACCESS_TYPE_NAMES.size()) {
+      throw Exception(fmt::format("unknown access type on access trace line {}: {}", line_number, type_name));
+    }
+    trace.push_back({page_id, static_cast<AccessType>(type)});
+  }
+  return trace;
+}
+
+}  // namespace bustub
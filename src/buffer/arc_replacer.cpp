@@ -0,0 +1,172 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.cpp
+//
+// Identification: src/buffer/arc_replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#include "buffer/arc_replacer.h"
+
+#include <algorithm>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+ArcReplacer::ArcReplacer(size_t num_frames)
+    : nodes_(num_frames), t1_heap_(num_frames), t2_heap_(num_frames), capacity_(num_frames) {}
+
+auto ArcReplacer::EvictFromT1() const -> bool { return !t1_heap_.Empty() && (t1_size_ > target_ || t2_heap_.Empty()); }
+
+void ArcReplacer::TrimGhosts() {
+  while (b1_.Size() > 0 && t1_size_ + b1_.Size() > capacity_) {
+    b1_.PopFront();
+  }
+  while (t1_size_ + t2_size_ + b1_.Size() + b2_.Size() > 2 * capacity_) {
+    (b2_.Size() > 0 ? b2_ : b1_).PopFront();
+  }
+}
+
+auto ArcReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::lock_guard<std::mutex> my_lock(latch_);
+  bool from_t1 = EvictFromT1();
+  if (!from_t1 && t2_heap_.Empty()) {
+    return false;
+  }
+  FrameHeap &heap = from_t1 ? t1_heap_ : t2_heap_;
+  *frame_id = heap.Top();
+  heap.Erase(*frame_id);
+  auto &node = nodes_[*frame_id];
+  if (from_t1) {
+    t1_size_--;
+  } else {
+    t2_size_--;
+  }
+  if (node.page_id_ != INVALID_PAGE_ID) {
+    (from_t1 ? b1_ : b2_).PushBack(node.page_id_);
+    TrimGhosts();
+  }
+  node = ArcNode();
+  evictable_size_--;
+  return true;
+}
+
+void ArcReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type, page_id_t page_id) {
+  std::lock_guard<std::mutex> my_lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < nodes_.size(), "invalid frame id");
+  auto &node = nodes_[frame_id];
+  node.last_access_ = current_timestamp_++;
+  if (node.list_ == List::None) {
+    node.page_id_ = page_id;
+    node.list_ = List::T1;
+    if (access_type != AccessType::Scan && page_id != INVALID_PAGE_ID) {
+      if (b1_.Contains(page_id)) {
+        // T1 was too small to keep this page: grow it.
+        target_ = std::min(capacity_, target_ + std::max<size_t>(b2_.Size() / b1_.Size(), 1));
+        b1_.Erase(page_id);
+        node.list_ = List::T2;
+      } else if (b2_.Contains(page_id)) {
+        // T2 was too small to keep this page: shrink T1.
+        target_ -= std::min(target_, std::max<size_t>(b1_.Size() / b2_.Size(), 1));
+        b2_.Erase(page_id);
+        node.list_ = List::T2;
+      }
+    }
+    if (node.list_ == List::T1) {
+      t1_size_++;
+    } else {
+      t2_size_++;
+    }
+    TrimGhosts();
+    return;
+  }
+  if (node.list_ == List::T1 && access_type != AccessType::Scan) {
+    // A second access makes the page frequent.
+    if (node.is_evictable_) {
+      t1_heap_.Erase(frame_id);
+      t2_heap_.Push(frame_id, node.last_access_);
+    }
+    node.list_ = List::T2;
+    t1_size_--;
+    t2_size_++;
+    return;
+  }
+  if (node.is_evictable_) {
+    HeapOf(node).Update(frame_id, node.last_access_);
+  }
+}
+
+void ArcReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::lock_guard<std::mutex> my_lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < nodes_.size(), "invalid frame id");
+  auto &node = nodes_[frame_id];
+  if (node.list_ == List::None || node.is_evictable_ == set_evictable) {
+    return;
+  }
+  node.is_evictable_ = set_evictable;
+  if (set_evictable) {
+    HeapOf(node).Push(frame_id, node.last_access_);
+    evictable_size_++;
+  } else {
+    HeapOf(node).Erase(frame_id);
+    evictable_size_--;
+  }
+}
+
+void ArcReplacer::Remove(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> my_lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < nodes_.size(), "invalid frame id");
+  auto &node = nodes_[frame_id];
+  if (node.list_ == List::None) {
+    return;
+  }
+  if (node.is_evictable_) {
+    HeapOf(node).Erase(frame_id);
+    evictable_size_--;
+  }
+  if (node.list_ == List::T1) {
+    t1_size_--;
+  } else {
+    t2_size_--;
+  }
+  node = ArcNode();
+}
+
+auto ArcReplacer::Size() -> size_t {
+  std::lock_guard<std::mutex> my_lock(latch_);
+  return evictable_size_;
+}
+
+auto ArcReplacer::EvictionCandidates(size_t max_count) -> std::vector<frame_id_t> {
+  std::lock_guard<std::mutex> my_lock(latch_);
+  // Evictions may switch lists as T1 shrinks, so the order is only exact for the first candidate.
+  std::vector<frame_id_t> candidates;
+  bool from_t1 = EvictFromT1();
+  (from_t1 ? t1_heap_ : t2_heap_).Smallest(max_count, &candidates);
+  (from_t1 ? t2_heap_ : t1_heap_).Smallest(max_count - candidates.size(), &candidates);
+  return candidates;
+}
+
+void ArcReplacer::Resize(size_t num_frames) {
+  std::lock_guard<std::mutex> my_lock(latch_);
+  for (size_t frame_id = num_frames; frame_id < nodes_.size(); ++frame_id) {
+    BUSTUB_ASSERT(nodes_[frame_id].list_ == List::None, "a frame that is cut off is still tracked");
+  }
+  nodes_.resize(num_frames);
+  t1_heap_.Resize(num_frames);
+  t2_heap_.Resize(num_frames);
+  capacity_ = num_frames;
+  target_ = std::min(target_, capacity_);
+  TrimGhosts();
+}
+
+auto ArcReplacer::GetTarget() -> size_t {
+  std::lock_guard<std::mutex> my_lock(latch_);
+  return target_;
+}
+
+}  // namespace bustub
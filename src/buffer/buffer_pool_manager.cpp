@@ -10,7 +10,13 @@
 //
 //===----------------------------------------------------------------------===//
 #include "buffer/buffer_pool_manager.h"
-#include <iostream>
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <new>
 
 #include "common/exception.h"
 #include "common/macros.h"
@@ -19,172 +25,970 @@
 namespace bustub {
 
 BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, size_t replacer_k,
-                                     LogManager *log_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
-  // TODO(students): remove this line after you have implemented the buffer pool manager
-  // std::cout << "BUfferPoolManager Constructor!" << '\n';
-  // std::cout << "replacer_k:" << replacer_k << '\n';
-  // we allocate a consecutive memory space for the buffer pool
-  pages_ = new Page[pool_size_];
-  replacer_ = std::make_unique<LRUKReplacer>(pool_size, replacer_k);
-  // Initially, every page is in the free list.
+                                     LogManager *log_manager, size_t num_instances)
+    : pool_size_(pool_size),
+      max_pool_size_(pool_size * BUFFER_POOL_MAX_GROWTH),
+      frame_allocation_(frame_allocation),
+      replacement_policy_(replacement_policy),
+      disk_manager_(disk_manager),
+      log_manager_(log_manager),
+      swip_chunks_(MAX_SWIP_CHUNKS) {
+  BUSTUB_ENSURE(num_instances > 0 && num_instances <= pool_size_, "invalid number of buffer pool instances");
+  if (frame_allocation_ != FrameAllocation::PerPage) {
+    AllocateArena();
+  }
+  // we allocate a consecutive memory space for the page metadata, the frames live in the arena or are per page.
+  // Room is made for the largest size the pool can grow to, so that frames never move.
+  pages_ = static_cast<Page *>(::operator new[](max_pool_size_ * sizeof(Page)));
+  ConstructFrames(pool_size_);
+  for (size_t i = 0; i < num_instances; ++i) {
+    size_t num_frames = (pool_size_ - i + num_instances - 1) / num_instances;
+    partitions_.emplace_back(std::make_unique<Partition>(i, num_frames, replacement_policy_, replacer_k));
+  }
+  // Initially, every page is in the free list of the partition that owns it.
   for (size_t i = 0; i < pool_size_; ++i) {
-    free_list_.emplace_back(static_cast<int>(i));
+    partitions_[i % num_instances]->free_list_.emplace_back(static_cast<int>(i));
   }
+  async_disk_manager_ = std::make_unique<AsyncDiskManager>(disk_manager_);
 }
 
-BufferPoolManager::~BufferPoolManager() { delete[] pages_; }
+BufferPoolManager::~BufferPoolManager() {
+  stop_warm_load_ = true;
+  WaitWarmLoad();
+  StopReadAhead();
+  StopPageCleaner();
+  for (size_t i = 0; i < constructed_frames_; ++i) {
+    pages_[i].~Page();
+  }
+  ::operator delete[](pages_);
+  for (auto &chunk : swip_chunks_) {
+    delete[] chunk.load();
+  }
+  if (arena_mapping_ != nullptr) {
+    munmap(arena_mapping_, arena_mapping_size_);
+  }
+}
 
-auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * {
-  std::lock_guard<std::mutex> my_lock(latch_);
-  // std::cout << "Start NewPage!" << '\n';
-  if (free_list_.empty() && replacer_->Size() == 0) {
-    return nullptr;
+void BufferPoolManager::AllocateArena() {
+  // Only the address space is reserved for frames the pool may grow into, the kernel backs pages on first touch.
+  size_t size = max_pool_size_ * BUSTUB_PAGE_SIZE;
+  size_t alignment = BUSTUB_PAGE_SIZE;
+  if (frame_allocation_ == FrameAllocation::HugePageArena) {
+    alignment = HUGE_PAGE_SIZE;
+    size = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
   }
-  // all places are occupied and non-evictable
-  frame_id_t frame_id = -1;
-  if (!free_list_.empty()) {
-    frame_id = free_list_.front();
-    free_list_.pop_front();
+  // mmap only aligns to the OS page size, so map one alignment more and align the arena inside the mapping.
+  arena_mapping_size_ = size + alignment;
+  arena_mapping_ = mmap(nullptr, arena_mapping_size_, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (arena_mapping_ == MAP_FAILED) {
+    arena_mapping_ = nullptr;
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot map the buffer pool arena");
+  }
+  auto address = reinterpret_cast<uintptr_t>(arena_mapping_);
+  arena_ = reinterpret_cast<char *>((address + alignment - 1) / alignment * alignment);
+#ifdef MADV_HUGEPAGE
+  if (frame_allocation_ == FrameAllocation::HugePageArena) {
+    // Only a hint, the arena works the same if the kernel does not back it with huge pages.
+    madvise(arena_, size, MADV_HUGEPAGE);
+  }
+#endif
+}
+
+void BufferPoolManager::ConstructFrames(size_t num_frames) {
+  for (; constructed_frames_ < num_frames; ++constructed_frames_) {
+    if (arena_ != nullptr) {
+      new (&pages_[constructed_frames_]) Page(arena_ + constructed_frames_ * BUSTUB_PAGE_SIZE);
+    } else {
+      new (&pages_[constructed_frames_]) Page();
+    }
+  }
+}
+
+auto BufferPoolManager::ResizePool(size_t new_size, std::chrono::milliseconds pin_timeout) -> bool {
+  BUSTUB_ENSURE(new_size >= partitions_.size() && new_size <= max_pool_size_, "invalid buffer pool size");
+  std::lock_guard<std::mutex> resize_lock(resize_latch_);
+  size_t old_size = pool_size_;
+  size_t num_instances = partitions_.size();
+  if (new_size > old_size) {
+    ConstructFrames(new_size);
+    for (auto &partition : partitions_) {
+      size_t num_frames = (new_size - partition->index_ + num_instances - 1) / num_instances;
+      std::lock_guard<std::mutex> my_lock(partition->latch_);
+      for (size_t local = partition->num_frames_; local < num_frames; ++local) {
+        partition->free_list_.push_back(static_cast<frame_id_t>(local * num_instances + partition->index_));
+      }
+      partition->num_frames_ = num_frames;
+      partition->replacer_->Resize(num_frames);
+      partition->scan_ring_slot_.resize(num_frames, -1);
+      partition->page_table_.reserve(num_frames);
+    }
+    pool_size_ = new_size;
+    return true;
+  }
+  // Release the highest frame first, so that the frames of the pool stay numbered from 0.
+  size_t size = old_size;
+  bool released = true;
+  for (; size > new_size; --size) {
+    if (!ReleaseFrame(static_cast<frame_id_t>(size - 1), std::chrono::steady_clock::now() + pin_timeout)) {
+      released = false;
+      break;
+    }
+    pool_size_ = size - 1;
+  }
+  if (arena_ != nullptr && size < old_size) {
+    // The next touch of a released frame, if the pool grows again, gets a zeroed page.
+    madvise(arena_ + size * BUSTUB_PAGE_SIZE, (old_size - size) * BUSTUB_PAGE_SIZE, MADV_DONTNEED);
+  }
+  return released;
+}
+
+auto BufferPoolManager::ReleaseFrame(frame_id_t frame_id, std::chrono::steady_clock::time_point deadline) -> bool {
+  auto &partition = GetFramePartition(frame_id);
+  auto &page = pages_[frame_id];
+  std::unique_lock<std::mutex> lock(partition.latch_);
+  if (page.swizzled_) {
+    CoolFrame(partition, frame_id);
+  }
+  while (page.pin_count_ > 0) {
+    lock.unlock();
+    if (std::chrono::steady_clock::now() >= deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    lock.lock();
+    if (page.swizzled_) {
+      CoolFrame(partition, frame_id);
+    }
+  }
+  page_id_t write_back_page_id = INVALID_PAGE_ID;
+  if (page.page_id_ == INVALID_PAGE_ID) {
+    partition.free_list_.remove(frame_id);
   } else {
-    replacer_->Evict(&frame_id);
-    if (pages_[frame_id].is_dirty_) {
-      FlushPage(pages_[frame_id].page_id_);  // if has been modified,flushing to the disk first.
+    partition.replacer_->Remove(ToReplacerFrame(frame_id));
+    LeaveScanRing(partition, frame_id);
+    EvictFrame(partition, frame_id, &write_back_page_id);
+    page.page_id_ = INVALID_PAGE_ID;
+    page.is_dirty_ = false;
+  }
+  // The frame is the partition's highest, so cutting it off shrinks the replacer by one.
+  partition.num_frames_ = ToReplacerFrame(frame_id);
+  partition.replacer_->Resize(partition.num_frames_);
+  partition.scan_ring_slot_.resize(partition.num_frames_);
+  // Fetches of the evicted page wait on the I/O latch until its write-back is done.
+  page.io_latch_.lock();
+  lock.unlock();
+  WriteBackVictim(partition, frame_id, write_back_page_id);
+  page.io_latch_.unlock();
+  return true;
+}
+
+auto BufferPoolManager::NewPage(page_id_t *page_id, ExtentAllocator *extent) -> Page * {
+  page_id_t new_page_id = extent == nullptr ? AllocatePage() : extent->AllocatePage(disk_manager_);
+  auto &partition = GetPartition(new_page_id);
+  std::unique_lock<std::mutex> lock(partition.latch_);
+  auto iter = partition.page_table_.find(new_page_id);
+  if (iter != partition.page_table_.end()) {
+    // The id was reused, and a stale copy of the deallocated page was fetched in the meantime, e.g. by an optimistic
+    // reader that is about to find out it followed an outdated child pointer. Take its frame over.
+    frame_id_t frame_id = iter->second;
+    if (pages_[frame_id].swizzled_) {
+      CoolFrame(partition, frame_id);
     }
-    page_id_t evict_page_id = pages_[frame_id].page_id_;  // remove the evicted page from page_table_,this must be done
-                                                          // after the evcted page has been flushed to the disk!
-    auto iter = page_table_.find(evict_page_id);
-    page_table_.erase(iter);
+    PinFrame(partition, frame_id, AccessType::Unknown);
+    pages_[frame_id].is_dirty_ = false;
+    pages_[frame_id].prefetched_ = false;
+    lock.unlock();
+    WaitFrameIo(frame_id);
+    // Latching bumps the version, so optimistic readers of the stale copy notice the reset.
+    pages_[frame_id].WLatch();
+    pages_[frame_id].ResetMemory();
+    pages_[frame_id].WUnlatch();
+    *page_id = new_page_id;
+    return &pages_[frame_id];
   }
-  page_table_[next_page_id_] = frame_id;
+  frame_id_t frame_id = -1;
+  page_id_t write_back_page_id = INVALID_PAGE_ID;
+  // all places of the partition are occupied and non-evictable
+  if (!AcquireFrame(partition, new_page_id, AccessType::Unknown, &frame_id, &write_back_page_id)) {
+    BufferPoolCounters::Add(partition.stats_.no_free_frames_);
+    if (extent == nullptr) {
+      DeallocatePage(new_page_id);
+    } else {
+      extent->ReleasePage(disk_manager_, new_page_id);
+    }
+    return nullptr;
+  }
+  lock.unlock();
+  WriteBackVictim(partition, frame_id, write_back_page_id);
   pages_[frame_id].ResetMemory();
-  pages_[frame_id].page_id_ = next_page_id_;
-  pages_[frame_id].pin_count_ = 1;
-  *page_id = next_page_id_;
-  replacer_->RecordAccess(frame_id);
-  replacer_->SetEvictable(frame_id, false);
-  next_page_id_++;
-  // std::cout << "frame_id:" << frame_id << "page_id:" << *page_id << '\n';
+  FinishFrameIo(frame_id);
+  *page_id = new_page_id;
   return &pages_[frame_id];
 }
 
-auto BufferPoolManager::FetchPage(page_id_t page_id, [[maybe_unused]] AccessType access_type) -> Page * {
-  std::lock_guard<std::mutex> my_lock(latch_);
-  // std::cout << "Start FetchPage!" << '\n';
-  // std::cout << "page_id" << page_id << '\n';
-  // Print();
-  auto iter = page_table_.find(page_id);
-  Page *page = nullptr;
-  if (iter != page_table_.end()) {  // This page has already exsisted in the buffer pool
-    frame_id_t frame_id = iter->second;
-    replacer_->RecordAccess(frame_id);
-    replacer_->SetEvictable(frame_id, false);
-    pages_[frame_id].pin_count_++;
-    page = &pages_[frame_id];
-  } else {
-    if (free_list_.empty() && replacer_->Size() == 0) {
-      return nullptr;
+auto BufferPoolManager::FetchPage(page_id_t page_id, AccessType access_type) -> Page * {
+  size_t window = read_ahead_window_;
+  if (access_type == AccessType::Scan && window > 0) {
+    // A run of consecutive page ids is read ahead half a window at a time, so the next batch is requested while the
+    // previous one is still being consumed.
+    page_id_t last_scan_page_id = last_scan_page_id_.exchange(page_id);
+    auto stride = static_cast<page_id_t>(std::max<size_t>(window / 2, 1));
+    if (last_scan_page_id != INVALID_PAGE_ID && page_id == last_scan_page_id + 1 && page_id % stride == 0) {
+      EnqueueReadAhead({page_id + 1, window, nullptr});
     }
-    // all places are occupied and non-evictable
-    frame_id_t frame_id = -1;
-    if (!free_list_.empty()) {
-      frame_id = free_list_.front();
-      free_list_.pop_front();
-    } else {
-      replacer_->Evict(&frame_id);
-      if (pages_[frame_id].is_dirty_) {
-        FlushPage(pages_[frame_id].page_id_);
+  }
+  auto &partition = GetPartition(page_id);
+  std::unique_lock<std::mutex> lock(partition.latch_);
+  while (true) {
+    auto iter = partition.page_table_.find(page_id);
+    if (iter != partition.page_table_.end()) {  // This page has already exsisted in the buffer pool
+      frame_id_t frame_id = iter->second;
+      if (pages_[frame_id].prefetched_) {
+        pages_[frame_id].prefetched_ = false;
+        read_ahead_hits_++;
       }
-      // if has been modified,flushing to the disk first.
-      page_id_t evict_page_id = pages_[frame_id].page_id_;
-      // remove the evicted page from page_table_,this must be
-      // done after the evcted page has been flushed to the disk!
-      auto iter = page_table_.find(evict_page_id);
-      page_table_.erase(iter);
-    }
-    page_table_[page_id] = frame_id;
-    pages_[frame_id].ResetMemory();
-    disk_manager_->ReadPage(page_id, pages_[frame_id].GetData());
-    pages_[frame_id].page_id_ = page_id;
-    pages_[frame_id].pin_count_ = 1;
-    replacer_->RecordAccess(frame_id);
-    replacer_->SetEvictable(frame_id, false);
-    page = &pages_[frame_id];
+      BufferPoolCounters::Add(partition.stats_.hits_[static_cast<size_t>(access_type)]);
+      PinFrame(partition, frame_id, access_type);
+      lock.unlock();
+      // The page may still be loading into the frame.
+      WaitFrameIo(frame_id);
+      return &pages_[frame_id];
+    }
+    auto write_back = partition.write_back_.find(page_id);
+    if (write_back == partition.write_back_.end()) {
+      break;
+    }
+    // The page was just evicted and its write-back is in flight. Wait for it, then look again.
+    frame_id_t frame_id = write_back->second;
+    lock.unlock();
+    WaitFrameIo(frame_id);
+    lock.lock();
   }
-
-  return page;
+  auto miss_start = std::chrono::steady_clock::now();
+  frame_id_t frame_id = -1;
+  page_id_t write_back_page_id = INVALID_PAGE_ID;
+  // all places of the partition are occupied and non-evictable
+  if (!AcquireFrame(partition, page_id, access_type, &frame_id, &write_back_page_id)) {
+    BufferPoolCounters::Add(partition.stats_.no_free_frames_);
+    return nullptr;
+  }
+  BufferPoolCounters::Add(partition.stats_.misses_[static_cast<size_t>(access_type)]);
+  lock.unlock();
+  WriteBackVictim(partition, frame_id, write_back_page_id);
+  pages_[frame_id].ResetMemory();
+  disk_manager_->ReadPage(page_id, pages_[frame_id].GetData());
+  FinishFrameIo(frame_id);
+  partition.stats_.miss_latency_.Record(std::chrono::steady_clock::now() - miss_start);
+  return &pages_[frame_id];
 }
 
 auto BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty, [[maybe_unused]] AccessType access_type) -> bool {
-  std::lock_guard<std::mutex> my_lock(latch_);
-  // std::cout << "Start UnpinPage!" << '\n';
-  // std::cout << "page_id:" << page_id << "is_dirty:" << is_dirty << '\n';
-  auto iter = page_table_.find(page_id);
-  if (iter == page_table_.end() || pages_[iter->second].pin_count_ == 0) {
+  auto &partition = GetPartition(page_id);
+  std::lock_guard<std::mutex> my_lock(partition.latch_);
+  auto iter = partition.page_table_.find(page_id);
+  if (iter == partition.page_table_.end() || pages_[iter->second].pin_count_ == 0) {
     return false;
   }
   frame_id_t frame_id = iter->second;
-  pages_[frame_id].pin_count_--;
-  if (pages_[frame_id].pin_count_ == 0) {
-    replacer_->SetEvictable(frame_id, true);
-  }
+  UnpinFrame(partition, frame_id);
   pages_[frame_id].is_dirty_ |= is_dirty;
   return true;
 }
 
-auto BufferPoolManager::FlushPage(page_id_t page_id) -> bool {
-  // std::cout << "Start FlushPage!" << '\n';
-  // std::cout << "page_id" << page_id << '\n';
-  auto iter = page_table_.find(page_id);
-  if (iter == page_table_.end()) {
-    return false;
-  }
-  frame_id_t frame_id = iter->second;
-  disk_manager_->WritePage(page_id, pages_[frame_id].data_);
-  pages_[frame_id].is_dirty_ = false;
-  return true;
-}
+auto BufferPoolManager::FlushPage(page_id_t page_id) -> bool { return FlushPageUnlatched(GetPartition(page_id), page_id); }
 
 void BufferPoolManager::FlushAllPages() {
-  std::lock_guard<std::mutex> my_lock(latch_);
-  for (auto &iter : page_table_) {
-    FlushPage(iter.first);
+  std::vector<frame_id_t> frame_ids;
+  std::vector<page_id_t> busy_page_ids;
+  for (auto &partition : partitions_) {
+    std::lock_guard<std::mutex> my_lock(partition->latch_);
+    for (auto &[page_id, frame_id] : partition->page_table_) {
+      // Waiting for I/O in flight while holding the I/O latches of the batch could deadlock with another batch, such
+      // frames are flushed one at a time afterwards.
+      if (!pages_[frame_id].io_latch_.try_lock()) {
+        busy_page_ids.push_back(page_id);
+        continue;
+      }
+      PinFrameForIo(*partition, frame_id);
+      pages_[frame_id].is_dirty_ = false;
+      frame_ids.push_back(frame_id);
+    }
+  }
+  // Consecutive pages live in different partitions, so the runs of them are found across all partitions.
+  std::sort(frame_ids.begin(), frame_ids.end(),
+            [&](frame_id_t a, frame_id_t b) { return pages_[a].page_id_ < pages_[b].page_id_; });
+  std::vector<std::future<bool>> writes;
+  ForEachPageRun(frame_ids, [&](page_id_t page_id, const std::vector<const char *> &pages_data) {
+    writes.push_back(WritePagesAsync(GetPartition(page_id), page_id, pages_data));
+  });
+  for (auto &write : writes) {
+    write.wait();
+  }
+  for (auto frame_id : frame_ids) {
+    auto &partition = GetFramePartition(frame_id);
+    FinishFrameIo(frame_id);
+    BufferPoolCounters::Add(partition.stats_.flushes_);
+    std::lock_guard<std::mutex> my_lock(partition.latch_);
+    UnpinFrame(partition, frame_id);
+  }
+  for (auto page_id : busy_page_ids) {
+    FlushPageUnlatched(GetPartition(page_id), page_id);
   }
 }
 
 auto BufferPoolManager::DeletePage(page_id_t page_id) -> bool {
-  std::lock_guard<std::mutex> my_lock(latch_);
-  // std::cout << "Start DeletePage!" << '\n';
-  // std::cout << "page_id:" << page_id << '\n';
-  auto iter = page_table_.find(page_id);
-  if (iter == page_table_.end()) {
+  auto &partition = GetPartition(page_id);
+  std::lock_guard<std::mutex> my_lock(partition.latch_);
+  auto iter = partition.page_table_.find(page_id);
+  if (iter == partition.page_table_.end()) {
+    // A page whose write-back is in flight keeps its id until the write lands, so the id cannot be reused under it.
+    if (partition.write_back_.count(page_id) == 0) {
+      DeallocatePage(page_id);
+    } else {
+      partition.deleted_write_backs_.insert(page_id);
+    }
     return true;
   }
-  frame_id_t frame_id = page_table_[page_id];
+  frame_id_t frame_id = iter->second;
+  if (pages_[frame_id].swizzled_) {
+    CoolFrame(partition, frame_id);
+  }
   if (pages_[frame_id].pin_count_ != 0) {
     return false;
   }
+  DiscardFrame(partition, frame_id);
+  DeallocatePage(page_id);
+  return true;
+}
+
+void BufferPoolManager::DiscardFrame(Partition &partition, frame_id_t frame_id) {
+  partition.page_table_.erase(pages_[frame_id].page_id_);
   pages_[frame_id].ResetMemory();
   pages_[frame_id].page_id_ = INVALID_PAGE_ID;
   pages_[frame_id].pin_count_ = 0;
   pages_[frame_id].is_dirty_ = false;
-  replacer_->Remove(frame_id);
-  free_list_.push_back(frame_id);
+  partition.replacer_->Remove(ToReplacerFrame(frame_id));
+  LeaveScanRing(partition, frame_id);
+  partition.free_list_.push_back(frame_id);
+}
+
+auto BufferPoolManager::CreateTablespace(const std::string &file_name) -> tablespace_id_t {
+  return disk_manager_->CreateTablespace(file_name);
+}
+
+/**
+ * All partitions stay latched while the pages are discarded and the file is dropped, so no page of the tablespace can
+ * be fetched or written back in between.
+ */
+auto BufferPoolManager::DropTablespace(tablespace_id_t tablespace) -> bool {
+  if (tablespace == DEFAULT_TABLESPACE) {
+    return false;
+  }
+  std::vector<std::unique_lock<std::mutex>> locks;
+  for (auto &partition : partitions_) {
+    locks.emplace_back(partition->latch_);
+  }
+  std::vector<std::pair<Partition *, frame_id_t>> frames;
+  for (auto &partition : partitions_) {
+    for (auto [page_id, frame_id] : partition->page_table_) {
+      if (DiskManager::GetTablespaceId(page_id) == tablespace) {
+        frames.emplace_back(partition.get(), frame_id);
+      }
+    }
+  }
+  for (auto [partition, frame_id] : frames) {
+    if (pages_[frame_id].swizzled_) {
+      CoolFrame(*partition, frame_id);
+    }
+    if (pages_[frame_id].pin_count_ != 0) {
+      return false;
+    }
+  }
+  if (!disk_manager_->DropTablespace(tablespace)) {
+    return false;
+  }
+  for (auto [partition, frame_id] : frames) {
+    DiscardFrame(*partition, frame_id);
+  }
+  // The file is gone, a pending deallocation would free a page of whichever tablespace reuses the id.
+  for (auto &partition : partitions_) {
+    for (auto iter = partition->deleted_write_backs_.begin(); iter != partition->deleted_write_backs_.end();) {
+      iter = DiskManager::GetTablespaceId(*iter) == tablespace ? partition->deleted_write_backs_.erase(iter) : ++iter;
+    }
+  }
+  return true;
+}
+
+auto BufferPoolManager::AllocatePage() -> page_id_t { return disk_manager_->AllocatePage(); }
+
+auto BufferPoolManager::AcquireFrame(Partition &partition, page_id_t page_id, AccessType access_type,
+                                     frame_id_t *frame_id, page_id_t *write_back_page_id) -> bool {
+  *write_back_page_id = INVALID_PAGE_ID;
+  if (access_type == AccessType::Scan && RecycleScanFrame(partition, frame_id)) {
+    EvictFrame(partition, *frame_id, write_back_page_id);
+  } else {
+    if (!partition.free_list_.empty()) {
+      *frame_id = partition.free_list_.front();
+      partition.free_list_.pop_front();
+    } else {
+      frame_id_t local_frame_id = -1;
+      // Cool swizzled pages until one of the frames can be evicted.
+      while (!partition.replacer_->Evict(&local_frame_id)) {
+        if (partition.swizzled_.empty()) {
+          return false;
+        }
+        CoolFrame(partition, partition.swizzled_.front());
+      }
+      *frame_id = FromReplacerFrame(partition, local_frame_id);
+      EvictFrame(partition, *frame_id, write_back_page_id);
+      LeaveScanRing(partition, *frame_id);
+    }
+    if (access_type == AccessType::Scan) {
+      JoinScanRing(partition, *frame_id);
+    }
+  }
+  // Nobody else holds a pin on the frame, so the I/O latch is free.
+  pages_[*frame_id].io_latch_.lock();
+  partition.page_table_[page_id] = *frame_id;
+  pages_[*frame_id].page_id_ = page_id;
+  pages_[*frame_id].is_dirty_ = false;
+  pages_[*frame_id].prefetched_ = false;
+  PinFrame(partition, *frame_id, access_type);
+  return true;
+}
+
+void BufferPoolManager::EvictFrame(Partition &partition, frame_id_t frame_id, page_id_t *write_back_page_id) {
+  page_id_t evict_page_id = pages_[frame_id].page_id_;
+  partition.page_table_.erase(evict_page_id);
+  BufferPoolCounters::Add(partition.stats_.evictions_);
+  // if has been modified, it has to reach the disk before anyone may read it again.
+  if (pages_[frame_id].is_dirty_) {
+    partition.write_back_[evict_page_id] = frame_id;
+    *write_back_page_id = evict_page_id;
+  }
+}
+
+auto BufferPoolManager::RecycleScanFrame(Partition &partition, frame_id_t *frame_id) -> bool {
+  auto &ring = partition.scan_ring_;
+  if (partition.scan_ring_frames_ < ring.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < ring.size(); ++i) {
+    frame_id_t candidate = ring[partition.scan_ring_next_];
+    partition.scan_ring_next_ = (partition.scan_ring_next_ + 1) % ring.size();
+    if (pages_[candidate].pin_count_ == 0) {
+      partition.replacer_->Remove(ToReplacerFrame(candidate));
+      *frame_id = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+void BufferPoolManager::JoinScanRing(Partition &partition, frame_id_t frame_id) {
+  auto &ring = partition.scan_ring_;
+  if (partition.scan_ring_frames_ == ring.size()) {
+    return;
+  }
+  auto slot = std::find(ring.begin(), ring.end(), -1);
+  *slot = frame_id;
+  partition.scan_ring_slot_[ToReplacerFrame(frame_id)] = static_cast<int>(slot - ring.begin());
+  partition.scan_ring_frames_++;
+}
+
+void BufferPoolManager::LeaveScanRing(Partition &partition, frame_id_t frame_id) {
+  int &slot = partition.scan_ring_slot_[ToReplacerFrame(frame_id)];
+  if (slot == -1) {
+    return;
+  }
+  partition.scan_ring_[slot] = -1;
+  slot = -1;
+  partition.scan_ring_frames_--;
+}
+
+void BufferPoolManager::WriteBackVictim(Partition &partition, frame_id_t frame_id, page_id_t write_back_page_id) {
+  if (write_back_page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  WritePageTimed(partition, write_back_page_id, pages_[frame_id].GetData());
+  BufferPoolCounters::Add(partition.stats_.foreground_writes_);
+  std::lock_guard<std::mutex> my_lock(partition.latch_);
+  partition.write_back_.erase(write_back_page_id);
+  if (partition.deleted_write_backs_.erase(write_back_page_id) != 0) {
+    DeallocatePage(write_back_page_id);
+  }
+}
+
+void BufferPoolManager::WritePageTimed(Partition &partition, page_id_t page_id, const char *page_data) {
+  auto start = std::chrono::steady_clock::now();
+  disk_manager_->WritePage(page_id, page_data);
+  partition.stats_.write_latency_.Record(std::chrono::steady_clock::now() - start);
+}
+
+auto BufferPoolManager::WritePagesAsync(Partition &partition, page_id_t page_id,
+                                        const std::vector<const char *> &pages_data) -> std::future<bool> {
+  auto start = std::chrono::steady_clock::now();
+  auto promise = std::make_shared<std::promise<bool>>();
+  auto future = promise->get_future();
+  async_disk_manager_->WritePages(page_id, pages_data, [&partition, start, promise](bool success) {
+    partition.stats_.write_latency_.Record(std::chrono::steady_clock::now() - start);
+    promise->set_value(success);
+  });
+  return future;
+}
+
+void BufferPoolManager::ForEachPageRun(const std::vector<frame_id_t> &frame_ids, const PageRunFn &write) {
+  std::vector<const char *> pages_data;
+  for (size_t begin = 0; begin < frame_ids.size();) {
+    page_id_t page_id = pages_[frame_ids[begin]].page_id_;
+    pages_data.clear();
+    size_t end = begin;
+    while (end < frame_ids.size() && pages_[frame_ids[end]].page_id_ == page_id + static_cast<page_id_t>(end - begin)) {
+      pages_data.push_back(pages_[frame_ids[end]].GetData());
+      ++end;
+    }
+    write(page_id, pages_data);
+    begin = end;
+  }
+}
+
+void BufferPoolManager::WaitFrameIo(frame_id_t frame_id) {
+  auto &io_latch = pages_[frame_id].io_latch_;
+  if (!io_latch.try_lock()) {
+    BufferPoolCounters::Add(GetFramePartition(frame_id).stats_.pin_waits_);
+    io_latch.lock();
+  }
+  io_latch.unlock();
+}
+
+void BufferPoolManager::PinFrame(Partition &partition, frame_id_t frame_id, AccessType access_type) {
+  pages_[frame_id].pin_count_++;
+  if (access_type != AccessType::Scan) {
+    // The page is wanted by more than a scan, so it is no longer recycled with the scan ring.
+    LeaveScanRing(partition, frame_id);
+  }
+  if (tracing_.load(std::memory_order_relaxed)) {
+    std::lock_guard<std::mutex> trace_lock(trace_latch_);
+    trace_.push_back({pages_[frame_id].page_id_, access_type});
+  }
+  partition.replacer_->RecordAccess(ToReplacerFrame(frame_id), access_type, pages_[frame_id].page_id_);
+  partition.replacer_->SetEvictable(ToReplacerFrame(frame_id), false);
+}
+
+void BufferPoolManager::PinFrameForIo(Partition &partition, frame_id_t frame_id) {
+  pages_[frame_id].pin_count_++;
+  partition.replacer_->SetEvictable(ToReplacerFrame(frame_id), false);
+}
+
+void BufferPoolManager::UnpinFrame(Partition &partition, frame_id_t frame_id) {
+  if (--pages_[frame_id].pin_count_ == 0) {
+    partition.replacer_->SetEvictable(ToReplacerFrame(frame_id), true);
+  }
+}
+
+auto BufferPoolManager::FlushPageUnlatched(Partition &partition, page_id_t page_id) -> bool {
+  std::unique_lock<std::mutex> lock(partition.latch_);
+  auto iter = partition.page_table_.find(page_id);
+  if (iter == partition.page_table_.end()) {
+    return false;
+  }
+  frame_id_t frame_id = iter->second;
+  // Pin the frame so it cannot be evicted, and clear the dirty flag first so that a modification made while the write
+  // is in flight marks the page dirty again.
+  PinFrameForIo(partition, frame_id);
+  pages_[frame_id].is_dirty_ = false;
+  lock.unlock();
+  {
+    std::lock_guard<std::mutex> io_lock(pages_[frame_id].io_latch_);
+    WritePageTimed(partition, page_id, pages_[frame_id].GetData());
+  }
+  BufferPoolCounters::Add(partition.stats_.flushes_);
+  lock.lock();
+  UnpinFrame(partition, frame_id);
+  return true;
+}
+
+void BufferPoolManager::StartAccessTrace() {
+  std::lock_guard<std::mutex> trace_lock(trace_latch_);
+  trace_.clear();
+  tracing_ = true;
+}
+
+auto BufferPoolManager::StopAccessTrace() -> std::vector<PageAccess> {
+  std::lock_guard<std::mutex> trace_lock(trace_latch_);
+  tracing_ = false;
+  std::vector<PageAccess> trace;
+  trace.swap(trace_);
+  return trace;
+}
+
+auto BufferPoolManager::GetStats() const -> BufferPoolStats {
+  BufferPoolStats stats;
+  for (const auto &partition : partitions_) {
+    stats.Add(partition->stats_);
+  }
+  stats.read_ahead_window_ = read_ahead_window_;
+  stats.read_ahead_pages_ = read_ahead_pages_;
+  stats.read_ahead_hits_ = read_ahead_hits_;
+  stats.swizzled_fetches_ = swizzled_fetches_;
+  stats.warm_loaded_pages_ = warm_loaded_pages_;
+  return stats;
+}
+
+void BufferPoolManager::StartPageCleaner(double clean_fraction) {
+  BUSTUB_ENSURE(clean_fraction >= 0 && clean_fraction <= 1, "clean fraction must be in [0, 1]");
+  StopPageCleaner();
+  clean_fraction_ = clean_fraction;
+  enable_page_cleaner_ = true;
+  page_cleaner_thread_ = new std::thread(&BufferPoolManager::RunPageCleaner, this);
+}
+
+void BufferPoolManager::StopPageCleaner() {
+  if (page_cleaner_thread_ == nullptr) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> cleaner_lock(page_cleaner_latch_);
+    enable_page_cleaner_ = false;
+  }
+  page_cleaner_cv_.notify_all();
+  page_cleaner_thread_->join();
+  delete page_cleaner_thread_;
+  page_cleaner_thread_ = nullptr;
+}
+
+void BufferPoolManager::RunPageCleaner() {
+  std::unique_lock<std::mutex> cleaner_lock(page_cleaner_latch_);
+  while (enable_page_cleaner_) {
+    cleaner_lock.unlock();
+    for (auto &partition : partitions_) {
+      CleanPartition(*partition);
+    }
+    if (std::chrono::steady_clock::now() - last_warm_manifest_ >= warm_manifest_interval) {
+      SaveWarmManifest();
+      last_warm_manifest_ = std::chrono::steady_clock::now();
+    }
+    cleaner_lock.lock();
+    page_cleaner_cv_.wait_for(cleaner_lock, page_cleaner_interval, [&] { return !enable_page_cleaner_; });
+  }
+}
+
+void BufferPoolManager::CleanPartition(Partition &partition) {
+  std::vector<frame_id_t> frame_ids;
+  std::unique_lock<std::mutex> lock(partition.latch_);
+  auto target = static_cast<size_t>(clean_fraction_ * partition.num_frames_ + 0.5);
+  if (partition.free_list_.size() >= target) {
+    return;
+  }
+  for (auto local_frame_id : partition.replacer_->EvictionCandidates(target - partition.free_list_.size())) {
+    frame_id_t frame_id = FromReplacerFrame(partition, local_frame_id);
+    Page &page = pages_[frame_id];
+    if (!page.is_dirty_) {
+      continue;
+    }
+    // WAL: a page may only reach the disk after the log records that modified it.
+    if (enable_logging && log_manager_ != nullptr && page.GetLSN() > log_manager_->GetPersistentLSN()) {
+      continue;
+    }
+    PinFrameForIo(partition, frame_id);
+    page.is_dirty_ = false;
+    // Nobody else holds a pin on the frame, so the I/O latch is free. Fetches of the page wait on it until the write
+    // is done, which keeps the image we write consistent.
+    page.io_latch_.lock();
+    frame_ids.push_back(frame_id);
+  }
+  lock.unlock();
+  std::sort(frame_ids.begin(), frame_ids.end(),
+            [&](frame_id_t a, frame_id_t b) { return pages_[a].page_id_ < pages_[b].page_id_; });
+  ForEachPageRun(frame_ids, [&](page_id_t page_id, const std::vector<const char *> &pages_data) {
+    auto start = std::chrono::steady_clock::now();
+    disk_manager_->WritePages(page_id, pages_data);
+    partition.stats_.write_latency_.Record(std::chrono::steady_clock::now() - start);
+  });
+  for (auto frame_id : frame_ids) {
+    FinishFrameIo(frame_id);
+    BufferPoolCounters::Add(partition.stats_.background_writes_);
+  }
+  lock.lock();
+  for (auto frame_id : frame_ids) {
+    UnpinFrame(partition, frame_id);
+  }
+}
+
+void BufferPoolManager::SaveWarmManifest() {
+  // Hottest first within every partition; the partitions are interleaved so that any prefix of the manifest is hot.
+  std::vector<std::vector<page_id_t>> partition_pages;
+  size_t max_pages = 0;
+  for (auto &partition : partitions_) {
+    std::vector<page_id_t> page_ids;
+    std::scoped_lock lock(partition->latch_);
+    for (const auto &[page_id, frame_id] : partition->page_table_) {
+      if (pages_[frame_id].pin_count_ > 0) {
+        page_ids.push_back(page_id);
+      }
+    }
+    auto candidates = partition->replacer_->EvictionCandidates(partition->num_frames_);
+    for (auto iter = candidates.rbegin(); iter != candidates.rend(); ++iter) {
+      page_ids.push_back(pages_[FromReplacerFrame(*partition, *iter)].page_id_);
+    }
+    max_pages = std::max(max_pages, page_ids.size());
+    partition_pages.push_back(std::move(page_ids));
+  }
+  std::vector<page_id_t> manifest;
+  for (size_t i = 0; i < max_pages; ++i) {
+    for (const auto &page_ids : partition_pages) {
+      if (i < page_ids.size()) {
+        manifest.push_back(page_ids[i]);
+      }
+    }
+  }
+  disk_manager_->WriteWarmManifest(manifest);
+}
+
+auto BufferPoolManager::StartWarmLoad() -> size_t {
+  WaitWarmLoad();
+  std::vector<size_t> budgets;
+  for (auto &partition : partitions_) {
+    std::scoped_lock lock(partition->latch_);
+    budgets.push_back(partition->free_list_.size());
+  }
+  std::vector<page_id_t> page_ids;
+  for (auto page_id : disk_manager_->ReadWarmManifest()) {
+    if (page_id < 0 || page_id >= disk_manager_->GetNextPageId(DiskManager::GetTablespaceId(page_id))) {
+      continue;
+    }
+    auto &budget = budgets[page_id % partitions_.size()];
+    if (budget > 0) {
+      budget--;
+      page_ids.push_back(page_id);
+    }
+  }
+  if (page_ids.empty()) {
+    return 0;
+  }
+  std::sort(page_ids.begin(), page_ids.end());
+  page_ids.erase(std::unique(page_ids.begin(), page_ids.end()), page_ids.end());
+  size_t num_pages = page_ids.size();
+  stop_warm_load_ = false;
+  warm_load_thread_ = new std::thread(&BufferPoolManager::RunWarmLoad, this, std::move(page_ids));
+  return num_pages;
+}
+
+void BufferPoolManager::WaitWarmLoad() {
+  if (warm_load_thread_ == nullptr) {
+    return;
+  }
+  warm_load_thread_->join();
+  delete warm_load_thread_;
+  warm_load_thread_ = nullptr;
+}
+
+void BufferPoolManager::RunWarmLoad(std::vector<page_id_t> page_ids) {
+  for (auto page_id : page_ids) {
+    if (stop_warm_load_) {
+      return;
+    }
+    WarmPage(page_id);
+  }
+}
+
+void BufferPoolManager::WarmPage(page_id_t page_id) {
+  auto &partition = GetPartition(page_id);
+  std::unique_lock<std::mutex> lock(partition.latch_);
+  // Never evict anything for a warm page: only free frames are used, and pages fetched meanwhile are left alone.
+  if (partition.page_table_.count(page_id) > 0 || partition.write_back_.count(page_id) > 0 ||
+      partition.free_list_.empty()) {
+    return;
+  }
+  frame_id_t frame_id = -1;
+  page_id_t write_back_page_id = INVALID_PAGE_ID;
+  if (!AcquireFrame(partition, page_id, AccessType::Unknown, &frame_id, &write_back_page_id)) {
+    return;
+  }
+  lock.unlock();
+  pages_[frame_id].ResetMemory();
+  disk_manager_->ReadPage(page_id, pages_[frame_id].GetData());
+  FinishFrameIo(frame_id);
+  warm_loaded_pages_++;
+  lock.lock();
+  UnpinFrame(partition, frame_id);
+}
+
+void BufferPoolManager::SetReadAheadWindow(size_t window) {
+  read_ahead_window_ = window;
+  std::lock_guard<std::mutex> read_ahead_lock(read_ahead_latch_);
+  if (window > 0 && read_ahead_thread_ == nullptr) {
+    enable_read_ahead_ = true;
+    read_ahead_thread_ = new std::thread(&BufferPoolManager::RunReadAhead, this);
+  }
+}
+
+void BufferPoolManager::ReadAheadChain(page_id_t page_id, NextPageFn next_page) {
+  size_t window = read_ahead_window_;
+  if (window == 0 || page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  EnqueueReadAhead({page_id, window, std::move(next_page)});
+}
+
+void BufferPoolManager::EnqueueReadAhead(ReadAheadRequest request) {
+  {
+    std::lock_guard<std::mutex> read_ahead_lock(read_ahead_latch_);
+    if (!enable_read_ahead_ || read_ahead_queue_.size() >= READ_AHEAD_QUEUE_SIZE) {
+      return;
+    }
+    read_ahead_queue_.emplace_back(std::move(request));
+  }
+  read_ahead_cv_.notify_one();
+}
+
+void BufferPoolManager::StopReadAhead() {
+  {
+    std::lock_guard<std::mutex> read_ahead_lock(read_ahead_latch_);
+    if (read_ahead_thread_ == nullptr) {
+      return;
+    }
+    enable_read_ahead_ = false;
+  }
+  read_ahead_cv_.notify_all();
+  read_ahead_thread_->join();
+  delete read_ahead_thread_;
+  read_ahead_thread_ = nullptr;
+}
+
+void BufferPoolManager::RunReadAhead() {
+  std::unique_lock<std::mutex> read_ahead_lock(read_ahead_latch_);
+  while (true) {
+    read_ahead_cv_.wait(read_ahead_lock, [&] { return !enable_read_ahead_ || !read_ahead_queue_.empty(); });
+    if (!enable_read_ahead_) {
+      return;
+    }
+    ReadAheadRequest request = std::move(read_ahead_queue_.front());
+    read_ahead_queue_.pop_front();
+    read_ahead_lock.unlock();
+    if (!request.next_page_) {
+      PrefetchPages(request.page_id_, request.count_);
+      read_ahead_lock.lock();
+      continue;
+    }
+    page_id_t page_id = request.page_id_;
+    for (size_t i = 0; i < request.count_ && page_id != INVALID_PAGE_ID; ++i) {
+      // Never read ahead past the end of the allocated pages.
+      if (page_id >= disk_manager_->GetNextPageId(DiskManager::GetTablespaceId(page_id))) {
+        break;
+      }
+      page_id_t next_page_id = INVALID_PAGE_ID;
+      if (!PrefetchPage(page_id, request.next_page_, &next_page_id)) {
+        break;
+      }
+      page_id = request.next_page_ ? next_page_id : page_id + 1;
+    }
+    read_ahead_lock.lock();
+  }
+}
+
+auto BufferPoolManager::PrefetchPage(page_id_t page_id, const NextPageFn &next_page, page_id_t *next_page_id)
+    -> bool {
+  auto &partition = GetPartition(page_id);
+  std::unique_lock<std::mutex> lock(partition.latch_);
+  while (true) {
+    auto iter = partition.page_table_.find(page_id);
+    if (iter != partition.page_table_.end()) {
+      // Already cached, we only need to look at it to follow the chain.
+      if (next_page) {
+        frame_id_t frame_id = iter->second;
+        PinFrameForIo(partition, frame_id);
+        lock.unlock();
+        WaitFrameIo(frame_id);
+        *next_page_id = next_page(pages_[frame_id].GetData());
+        lock.lock();
+        UnpinFrame(partition, frame_id);
+      }
+      return true;
+    }
+    auto write_back = partition.write_back_.find(page_id);
+    if (write_back == partition.write_back_.end()) {
+      break;
+    }
+    frame_id_t frame_id = write_back->second;
+    lock.unlock();
+    WaitFrameIo(frame_id);
+    lock.lock();
+  }
+  frame_id_t frame_id = -1;
+  page_id_t write_back_page_id = INVALID_PAGE_ID;
+  if (!AcquireFrame(partition, page_id, AccessType::Scan, &frame_id, &write_back_page_id)) {
+    return false;
+  }
+  pages_[frame_id].prefetched_ = true;
+  lock.unlock();
+  WriteBackVictim(partition, frame_id, write_back_page_id);
+  pages_[frame_id].ResetMemory();
+  disk_manager_->ReadPage(page_id, pages_[frame_id].GetData());
+  if (next_page) {
+    *next_page_id = next_page(pages_[frame_id].GetData());
+  }
+  FinishFrameIo(frame_id);
+  read_ahead_pages_++;
+  lock.lock();
+  UnpinFrame(partition, frame_id);
   return true;
 }
 
-auto BufferPoolManager::AllocatePage() -> page_id_t { return next_page_id_++; }
+void BufferPoolManager::PrefetchPages(page_id_t page_id, size_t count) {
+  struct Load {
+    frame_id_t frame_id_;
+    page_id_t write_back_page_id_;
+  };
+  std::vector<Load> loads;
+  // Never read ahead past the end of the allocated pages.
+  page_id_t end_page_id =
+      std::min<page_id_t>(page_id + count, disk_manager_->GetNextPageId(DiskManager::GetTablespaceId(page_id)));
+  if (page_id < end_page_id) {
+    disk_manager_->AdviseSequentialRead(page_id, end_page_id - page_id);
+  }
+  for (; page_id < end_page_id; ++page_id) {
+    auto &partition = GetPartition(page_id);
+    std::lock_guard<std::mutex> my_lock(partition.latch_);
+    if (partition.page_table_.count(page_id) != 0 || partition.write_back_.count(page_id) != 0) {
+      continue;
+    }
+    frame_id_t frame_id = -1;
+    page_id_t write_back_page_id = INVALID_PAGE_ID;
+    if (!AcquireFrame(partition, page_id, AccessType::Scan, &frame_id, &write_back_page_id)) {
+      break;
+    }
+    pages_[frame_id].prefetched_ = true;
+    loads.push_back({frame_id, write_back_page_id});
+  }
+  std::vector<std::future<bool>> reads;
+  reads.reserve(loads.size());
+  for (const auto &load : loads) {
+    WriteBackVictim(GetFramePartition(load.frame_id_), load.frame_id_, load.write_back_page_id_);
+    pages_[load.frame_id_].ResetMemory();
+    reads.push_back(async_disk_manager_->ReadPage(pages_[load.frame_id_].page_id_, pages_[load.frame_id_].GetData()));
+  }
+  for (size_t i = 0; i < loads.size(); ++i) {
+    reads[i].wait();
+    FinishFrameIo(loads[i].frame_id_);
+    read_ahead_pages_++;
+    auto &partition = GetFramePartition(loads[i].frame_id_);
+    std::lock_guard<std::mutex> my_lock(partition.latch_);
+    UnpinFrame(partition, loads[i].frame_id_);
+  }
+}
 
-auto BufferPoolManager::FetchPageBasic(page_id_t page_id) -> BasicPageGuard {
-  Page *page = FetchPage(page_id);
+auto BufferPoolManager::FetchPageBasic(page_id_t page_id, AccessType access_type) -> BasicPageGuard {
+  Page *page = FetchPage(page_id, access_type);
   if (page != nullptr) {
     return BasicPageGuard{this, page};
   }
   return BasicPageGuard{this, nullptr};
 }
 
-auto BufferPoolManager::FetchPageRead(page_id_t page_id) -> ReadPageGuard {
-  Page *page = FetchPage(page_id);
+auto BufferPoolManager::FetchPageRead(page_id_t page_id, AccessType access_type) -> ReadPageGuard {
+  Page *page = FetchPage(page_id, access_type);
   if (page != nullptr) {
     page->RLatch();
     return ReadPageGuard{this, page};
@@ -192,8 +996,134 @@ auto BufferPoolManager::FetchPageRead(page_id_t page_id) -> ReadPageGuard {
   return ReadPageGuard{this, nullptr};
 }
 
-auto BufferPoolManager::FetchPageWrite(page_id_t page_id) -> WritePageGuard {
-  Page *page = FetchPage(page_id);
+auto BufferPoolManager::FetchPageReadSwizzled(page_id_t page_id) -> ReadPageGuard {
+  auto *swip = GetSwip(page_id, false);
+  Page *page = swip == nullptr ? nullptr : swip->load();
+  if (page != nullptr) {
+    page->pin_count_++;
+    // The pin only protects the frame if the page was still swizzled after we took it.
+    if (swip->load() == page) {
+      swizzled_fetches_++;
+      page->RLatch();
+      ReadPageGuard guard{this, page};
+      guard.guard_.swizzled_ = true;
+      return guard;
+    }
+    UnpinSwizzledPage(page);
+  }
+  return FetchPageRead(page_id);
+}
+
+auto BufferPoolManager::FetchPageOptimistic(page_id_t page_id) -> ReadPageGuard {
+  auto *swip = GetSwip(page_id, false);
+  Page *page = swip == nullptr ? nullptr : swip->load();
+  if (page != nullptr) {
+    uint64_t version = page->GetVersion();
+    // If the swip still points at the frame, the page can only leave it after a cooling, which changes the version.
+    if (version % 2 == 0 && swip->load() == page) {
+      ReadPageGuard guard{nullptr, page};
+      guard.optimistic_ = true;
+      guard.version_ = version;
+      return guard;
+    }
+  }
+  page = FetchPage(page_id);
+  ReadPageGuard guard{this, page};
+  if (page != nullptr) {
+    guard.optimistic_ = true;
+    while ((guard.version_ = page->GetVersion()) % 2 != 0) {
+      std::this_thread::yield();
+    }
+  }
+  return guard;
+}
+
+void BufferPoolManager::SwizzlePage(const ReadPageGuard &guard) {
+  Page *page = guard.guard_.page_;
+  double fraction = swizzle_fraction_;
+  if (fraction == 0 || page == nullptr || guard.guard_.swizzled_ || guard.guard_.bpm_ == nullptr) {
+    return;
+  }
+  auto *swip = GetSwip(page->GetPageId(), true);
+  if (swip == nullptr) {
+    return;
+  }
+  auto frame_id = static_cast<frame_id_t>(page - pages_);
+  auto &partition = GetFramePartition(frame_id);
+  std::lock_guard<std::mutex> my_lock(partition.latch_);
+  auto max_swizzled = static_cast<size_t>(fraction * partition.num_frames_);
+  if (page->swizzled_ || max_swizzled == 0) {
+    return;
+  }
+  // The guard's pin keeps the frame mapped to the page, so the swizzle pin can be taken without the page table.
+  page->swizzled_ = true;
+  page->pin_count_++;
+  partition.swizzled_.push_back(frame_id);
+  swip->store(page);
+  while (partition.swizzled_.size() > max_swizzled) {
+    CoolFrame(partition, partition.swizzled_.front());
+  }
+}
+
+void BufferPoolManager::SetSwizzleFraction(double fraction) {
+  BUSTUB_ENSURE(fraction >= 0 && fraction <= 1, "swizzle fraction must be in [0, 1]");
+  swizzle_fraction_ = fraction;
+  for (auto &partition : partitions_) {
+    std::lock_guard<std::mutex> my_lock(partition->latch_);
+    auto max_swizzled = static_cast<size_t>(fraction * partition->num_frames_);
+    while (partition->swizzled_.size() > max_swizzled) {
+      CoolFrame(*partition, partition->swizzled_.front());
+    }
+  }
+}
+
+auto BufferPoolManager::GetSwip(page_id_t page_id, bool create) -> std::atomic<Page *> * {
+  auto chunk_index = static_cast<size_t>(page_id) / SWIP_CHUNK_SIZE;
+  if (page_id < 0 || chunk_index >= MAX_SWIP_CHUNKS) {
+    return nullptr;
+  }
+  auto &chunk = swip_chunks_[chunk_index];
+  std::atomic<Page *> *swips = chunk.load();
+  if (swips == nullptr) {
+    if (!create) {
+      return nullptr;
+    }
+    auto *new_swips = new std::atomic<Page *>[SWIP_CHUNK_SIZE]();
+    if (chunk.compare_exchange_strong(swips, new_swips)) {
+      swips = new_swips;
+    } else {
+      delete[] new_swips;
+    }
+  }
+  return &swips[page_id % SWIP_CHUNK_SIZE];
+}
+
+void BufferPoolManager::CoolFrame(Partition &partition, frame_id_t frame_id) {
+  auto &page = pages_[frame_id];
+  GetSwip(page.page_id_, false)->store(nullptr);
+  // Optimistic readers that borrowed the page through its swip must not trust what they read from now on.
+  page.version_.fetch_add(2);
+  page.swizzled_ = false;
+  partition.swizzled_.erase(std::find(partition.swizzled_.begin(), partition.swizzled_.end(), frame_id));
+  UnpinFrame(partition, frame_id);
+}
+
+void BufferPoolManager::UnpinSwizzledPage(Page *page) {
+  if (--page->pin_count_ > 0) {
+    return;
+  }
+  // The page was cooled while we held it. Make the frame evictable, unless someone pinned it again meanwhile or the
+  // frame was released by a shrinking ResizePool().
+  auto frame_id = static_cast<frame_id_t>(page - pages_);
+  auto &partition = GetFramePartition(frame_id);
+  std::lock_guard<std::mutex> my_lock(partition.latch_);
+  if (page->pin_count_ == 0 && page->page_id_ != INVALID_PAGE_ID) {
+    partition.replacer_->SetEvictable(ToReplacerFrame(frame_id), true);
+  }
+}
+
+auto BufferPoolManager::FetchPageWrite(page_id_t page_id, AccessType access_type) -> WritePageGuard {
+  Page *page = FetchPage(page_id, access_type);
   if (page != nullptr) {
     page->WLatch();
     return WritePageGuard{this, page};
@@ -201,16 +1131,110 @@ auto BufferPoolManager::FetchPageWrite(page_id_t page_id) -> WritePageGuard {
   return WritePageGuard{this, nullptr};
 }
 
-auto BufferPoolManager::NewPageGuarded(page_id_t *page_id) -> BasicPageGuard {
-  Page *page = NewPage(page_id);
-  return BasicPageGuard{this, page};
+auto BufferPoolManager::FetchPagesBasic(const std::vector<page_id_t> &page_ids, AccessType access_type)
+    -> std::vector<BasicPageGuard> {
+  std::vector<BasicPageGuard> guards;
+  guards.reserve(page_ids.size());
+  for (Page *page : PinPages(page_ids, access_type)) {
+    guards.emplace_back(this, page);
+  }
+  return guards;
 }
 
-// void BufferPoolManager::Print(){
-//   replacer_->Print();
-//   for(auto & a : page_table_){
-//     std::cout << "frame_id:" << a.second << "page_id:" << a.first << '\n';
-//   }
-// }
+auto BufferPoolManager::FetchPagesRead(const std::vector<page_id_t> &page_ids, AccessType access_type)
+    -> std::vector<ReadPageGuard> {
+  std::vector<ReadPageGuard> guards;
+  guards.reserve(page_ids.size());
+  for (Page *page : PinPages(page_ids, access_type)) {
+    if (page != nullptr) {
+      page->RLatch();
+    }
+    guards.emplace_back(this, page);
+  }
+  return guards;
+}
+
+auto BufferPoolManager::PinPages(const std::vector<page_id_t> &page_ids, AccessType access_type)
+    -> std::vector<Page *> {
+  struct Miss {
+    size_t index_;
+    frame_id_t frame_id_;
+    page_id_t write_back_page_id_;
+  };
+  std::vector<Page *> pages(page_ids.size(), nullptr);
+  std::vector<std::vector<size_t>> partition_indexes(partitions_.size());
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    partition_indexes[page_ids[i] % partitions_.size()].push_back(i);
+  }
+  auto batch_start = std::chrono::steady_clock::now();
+  std::vector<frame_id_t> hits;
+  std::vector<Miss> misses;
+  std::vector<size_t> deferred;
+  for (size_t p = 0; p < partitions_.size(); ++p) {
+    if (partition_indexes[p].empty()) {
+      continue;
+    }
+    auto &partition = *partitions_[p];
+    std::lock_guard<std::mutex> my_lock(partition.latch_);
+    for (auto i : partition_indexes[p]) {
+      page_id_t page_id = page_ids[i];
+      auto iter = partition.page_table_.find(page_id);
+      if (iter != partition.page_table_.end()) {
+        frame_id_t frame_id = iter->second;
+        if (pages_[frame_id].prefetched_) {
+          pages_[frame_id].prefetched_ = false;
+          read_ahead_hits_++;
+        }
+        BufferPoolCounters::Add(partition.stats_.hits_[static_cast<size_t>(access_type)]);
+        PinFrame(partition, frame_id, access_type);
+        hits.push_back(frame_id);
+        pages[i] = &pages_[frame_id];
+        continue;
+      }
+      // Waiting for a write-back while holding the I/O latches of our own misses could deadlock with another batch.
+      if (partition.write_back_.count(page_id) != 0) {
+        deferred.push_back(i);
+        continue;
+      }
+      frame_id_t frame_id = -1;
+      page_id_t write_back_page_id = INVALID_PAGE_ID;
+      if (!AcquireFrame(partition, page_id, access_type, &frame_id, &write_back_page_id)) {
+        BufferPoolCounters::Add(partition.stats_.no_free_frames_);
+        continue;
+      }
+      BufferPoolCounters::Add(partition.stats_.misses_[static_cast<size_t>(access_type)]);
+      misses.push_back({i, frame_id, write_back_page_id});
+      pages[i] = &pages_[frame_id];
+    }
+  }
+  // Submit the misses in page id order, so that runs of consecutive pages reach the disk sequentially.
+  std::sort(misses.begin(), misses.end(),
+            [&](const Miss &a, const Miss &b) { return page_ids[a.index_] < page_ids[b.index_]; });
+  std::vector<std::future<bool>> reads;
+  reads.reserve(misses.size());
+  for (const auto &miss : misses) {
+    WriteBackVictim(GetFramePartition(miss.frame_id_), miss.frame_id_, miss.write_back_page_id_);
+    pages_[miss.frame_id_].ResetMemory();
+    reads.push_back(async_disk_manager_->ReadPage(page_ids[miss.index_], pages_[miss.frame_id_].GetData()));
+  }
+  for (size_t i = 0; i < misses.size(); ++i) {
+    reads[i].wait();
+    FinishFrameIo(misses[i].frame_id_);
+    GetFramePartition(misses[i].frame_id_).stats_.miss_latency_.Record(std::chrono::steady_clock::now() - batch_start);
+  }
+  // Only wait for the I/O of other threads once ours is done: a hit may be one of our own misses.
+  for (auto frame_id : hits) {
+    WaitFrameIo(frame_id);
+  }
+  for (auto i : deferred) {
+    pages[i] = FetchPage(page_ids[i], access_type);
+  }
+  return pages;
+}
+
+auto BufferPoolManager::NewPageGuarded(page_id_t *page_id, ExtentAllocator *extent) -> BasicPageGuard {
+  Page *page = NewPage(page_id, extent);
+  return BasicPageGuard{this, page};
+}
 
 }  // namespace bustub
@@ -0,0 +1,126 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_stats.cpp
+//
+// Identification: src/buffer/buffer_pool_stats.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#include "buffer/buffer_pool_stats.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "fmt/format.h"
+
+namespace bustub {
+
+auto LatencyHistogramSnapshot::MeanUs() const -> double {
+  return count_ == 0 ? 0 : static_cast<double>(total_ns_) / static_cast<double>(count_) / 1000;
+}
+
+auto LatencyHistogramSnapshot::PercentileUs(double percentile) const -> uint64_t {
+  if (count_ == 0) {
+    return 0;
+  }
+  auto rank = static_cast<uint64_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100 * count_));
+  rank = std::max<uint64_t>(rank, 1);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < buckets_.size(); ++i) {
+    seen += buckets_[i];
+    if (seen >= rank) {
+      return uint64_t{1} << i;
+    }
+  }
+  return uint64_t{1} << (buckets_.size() - 1);
+}
+
+void LatencyHistogramSnapshot::Merge(const LatencyHistogramSnapshot &other) {
+  for (size_t i = 0; i < buckets_.size(); ++i) {
+    buckets_[i] += other.buckets_[i];
+  }
+  count_ += other.count_;
+  total_ns_ += other.total_ns_;
+}
+
+void LatencyHistogram::Record(std::chrono::nanoseconds latency) {
+  auto us = static_cast<uint64_t>(std::max<int64_t>(latency.count(), 0)) / 1000;
+  // The bucket is the bit width of the latency in microseconds: 0 -> 0, 1 -> 1, [2, 4) -> 2, ...
+  size_t bucket = 0;
+  while (us != 0 && bucket + 1 < LATENCY_HISTOGRAM_BUCKETS) {
+    us >>= 1;
+    bucket++;
+  }
+  buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+  total_ns_.fetch_add(std::max<int64_t>(latency.count(), 0), std::memory_order_relaxed);
+}
+
+auto LatencyHistogram::Snapshot() const -> LatencyHistogramSnapshot {
+  LatencyHistogramSnapshot snapshot;
+  for (size_t i = 0; i < buckets_.size(); ++i) {
+    snapshot.buckets_[i] = buckets_[i].load(std::memory_order_relaxed);
+    snapshot.count_ += snapshot.buckets_[i];
+  }
+  snapshot.total_ns_ = total_ns_.load(std::memory_order_relaxed);
+  return snapshot;
+}
+
+void BufferPoolStats::Add(const BufferPoolCounters &counters) {
+  for (size_t i = 0; i < hits_.size(); ++i) {
+    hits_[i] += counters.hits_[i].load(std::memory_order_relaxed);
+    misses_[i] += counters.misses_[i].load(std::memory_order_relaxed);
+  }
+  evictions_ += counters.evictions_.load(std::memory_order_relaxed);
+  foreground_writes_ += counters.foreground_writes_.load(std::memory_order_relaxed);
+  background_writes_ += counters.background_writes_.load(std::memory_order_relaxed);
+  flushes_ += counters.flushes_.load(std::memory_order_relaxed);
+  pin_waits_ += counters.pin_waits_.load(std::memory_order_relaxed);
+  no_free_frames_ += counters.no_free_frames_.load(std::memory_order_relaxed);
+  miss_latency_.Merge(counters.miss_latency_.Snapshot());
+  write_latency_.Merge(counters.write_latency_.Snapshot());
+}
+
+auto BufferPoolStats::TotalHits() const -> uint64_t { return hits_[0] + hits_[1] + hits_[2]; }
+
+auto BufferPoolStats::TotalMisses() const -> uint64_t { return misses_[0] + misses_[1] + misses_[2]; }
+
+auto BufferPoolStats::HitRate() const -> double {
+  uint64_t fetches = TotalHits() + TotalMisses();
+  return fetches == 0 ? 0 : static_cast<double>(TotalHits()) / static_cast<double>(fetches);
+}
+
+auto BufferPoolStats::ToRows() const -> std::vector<std::pair<std::string, std::string>> {
+  // Indexed by AccessType.
+  static constexpr std::array<const char *, 3> ACCESS_TYPE_NAMES = {"unknown", "get", "scan"};
+  std::vector<std::pair<std::string, std::string>> rows;
+  rows.emplace_back("hits", fmt::format("{}", TotalHits()));
+  rows.emplace_back("misses", fmt::format("{}", TotalMisses()));
+  rows.emplace_back("hit_rate", fmt::format("{:.4f}", HitRate()));
+  for (size_t i = 0; i < ACCESS_TYPE_NAMES.size(); ++i) {
+    rows.emplace_back(fmt::format("hits_{}", ACCESS_TYPE_NAMES[i]), fmt::format("{}", hits_[i]));
+    rows.emplace_back(fmt::format("misses_{}", ACCESS_TYPE_NAMES[i]), fmt::format("{}", misses_[i]));
+  }
+  rows.emplace_back("evictions", fmt::format("{}", evictions_));
+  rows.emplace_back("foreground_writes", fmt::format("{}", foreground_writes_));
+  rows.emplace_back("background_writes", fmt::format("{}", background_writes_));
+  rows.emplace_back("flushes", fmt::format("{}", flushes_));
+  rows.emplace_back("pin_waits", fmt::format("{}", pin_waits_));
+  rows.emplace_back("no_free_frames", fmt::format("{}", no_free_frames_));
+  rows.emplace_back("read_ahead_window", fmt::format("{}", read_ahead_window_));
+  rows.emplace_back("read_ahead_pages", fmt::format("{}", read_ahead_pages_));
+  rows.emplace_back("read_ahead_hits", fmt::format("{}", read_ahead_hits_));
+  rows.emplace_back("swizzled_fetches", fmt::format("{}", swizzled_fetches_));
+  rows.emplace_back("warm_loaded_pages", fmt::format("{}", warm_loaded_pages_));
+  for (const auto &[name, histogram] : {std::make_pair("miss_latency", &miss_latency_),
+                                        std::make_pair("write_latency", &write_latency_)}) {
+    rows.emplace_back(fmt::format("{}_mean_us", name), fmt::format("{:.1f}", histogram->MeanUs()));
+    rows.emplace_back(fmt::format("{}_p50_us", name), fmt::format("{}", histogram->PercentileUs(50)));
+    rows.emplace_back(fmt::format("{}_p99_us", name), fmt::format("{}", histogram->PercentileUs(99)));
+  }
+  return rows;
+}
+
+}  // namespace bustub
@@ -12,18 +12,121 @@
 
 #include "buffer/clock_replacer.h"
 
+#include "common/macros.h"
+
 namespace bustub {
 
-ClockReplacer::ClockReplacer(size_t num_pages) {}
+ClockReplacer::ClockReplacer(size_t num_pages) : frames_(num_pages) {}
 
 ClockReplacer::~ClockReplacer() = default;
 
-auto ClockReplacer::Victim(frame_id_t *frame_id) -> bool { return false; }
+auto ClockReplacer::Victim(frame_id_t *frame_id) -> bool { return Evict(frame_id); }
+
+void ClockReplacer::Pin(frame_id_t frame_id) { SetEvictable(frame_id, false); }
+
+void ClockReplacer::Unpin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> my_lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < frames_.size(), "invalid frame id");
+  if (frames_[frame_id].evictable_) {
+    return;
+  }
+  RecordAccessLatched(frame_id, AccessType::Unknown);
+  SetEvictableLatched(frame_id, true);
+}
+
+auto ClockReplacer::Size() -> size_t {
+  std::lock_guard<std::mutex> my_lock(latch_);
+  return evictable_size_;
+}
+
+auto ClockReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::lock_guard<std::mutex> my_lock(latch_);
+  if (evictable_size_ == 0) {
+    return false;
+  }
+  // Every evictable frame is passed at most twice: once to clear its bit, once to evict it.
+  while (true) {
+    auto &frame = frames_[hand_];
+    size_t slot = hand_;
+    hand_ = (hand_ + 1) % frames_.size();
+    if (!frame.evictable_) {
+      continue;
+    }
+    if (frame.referenced_) {
+      frame.referenced_ = false;
+      continue;
+    }
+    frame = ClockFrame();
+    evictable_size_--;
+    *frame_id = static_cast<frame_id_t>(slot);
+    return true;
+  }
+}
+
+void ClockReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type, [[maybe_unused]] page_id_t page_id) {
+  std::lock_guard<std::mutex> my_lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < frames_.size(), "invalid frame id");
+  RecordAccessLatched(frame_id, access_type);
+}
+
+void ClockReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::lock_guard<std::mutex> my_lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < frames_.size(), "invalid frame id");
+  SetEvictableLatched(frame_id, set_evictable);
+}
+
+void ClockReplacer::Remove(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> my_lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < frames_.size(), "invalid frame id");
+  if (frames_[frame_id].evictable_) {
+    evictable_size_--;
+  }
+  frames_[frame_id] = ClockFrame();
+}
+
+auto ClockReplacer::EvictionCandidates(size_t max_count) -> std::vector<frame_id_t> {
+  std::lock_guard<std::mutex> my_lock(latch_);
+  // The hand evicts the unreferenced frames in clock order first, then the referenced ones once their bits are clear.
+  std::vector<frame_id_t> candidates;
+  for (bool referenced : {false, true}) {
+    for (size_t i = 0; i < frames_.size() && candidates.size() < max_count; ++i) {
+      size_t slot = (hand_ + i) % frames_.size();
+      if (frames_[slot].evictable_ && frames_[slot].referenced_ == referenced) {
+        candidates.push_back(static_cast<frame_id_t>(slot));
+      }
+    }
+  }
+  return candidates;
+}
 
-void ClockReplacer::Pin(frame_id_t frame_id) {}
+void ClockReplacer::Resize(size_t num_frames) {
+  std::lock_guard<std::mutex> my_lock(latch_);
+  for (size_t slot = num_frames; slot < frames_.size(); ++slot) {
+    BUSTUB_ASSERT(!frames_[slot].tracked_, "a frame that is cut off is still tracked");
+  }
+  frames_.resize(num_frames);
+  hand_ = num_frames == 0 ? 0 : hand_ % num_frames;
+}
 
-void ClockReplacer::Unpin(frame_id_t frame_id) {}
+void ClockReplacer::RecordAccessLatched(frame_id_t frame_id, AccessType access_type) {
+  auto &frame = frames_[frame_id];
+  frame.tracked_ = true;
+  if (access_type != AccessType::Scan) {
+    frame.referenced_ = true;
+  }
+}
 
-auto ClockReplacer::Size() -> size_t { return 0; }
+void ClockReplacer::SetEvictableLatched(frame_id_t frame_id, bool set_evictable) {
+  auto &frame = frames_[frame_id];
+  if (!frame.tracked_ || frame.evictable_ == set_evictable) {
+    return;
+  }
+  frame.evictable_ = set_evictable;
+  if (set_evictable) {
+    evictable_size_++;
+  } else {
+    evictable_size_--;
+  }
+}
 
 }  // namespace bustub
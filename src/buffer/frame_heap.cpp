@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_heap.cpp
+//
+// Identification: src/buffer/frame_heap.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#include "buffer/frame_heap.h"
+
+#include <functional>
+#include <queue>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+void FrameHeap::Push(frame_id_t frame_id, size_t key) {
+  BUSTUB_ASSERT(!Contains(frame_id), "frame is already in the heap");
+  heap_.emplace_back(key, frame_id);
+  position_[frame_id] = heap_.size() - 1;
+  SiftUp(heap_.size() - 1);
+}
+
+void FrameHeap::Erase(frame_id_t frame_id) {
+  if (!Contains(frame_id)) {
+    return;
+  }
+  size_t pos = position_[frame_id];
+  position_[frame_id] = NOT_IN_HEAP;
+  auto last = heap_.back();
+  heap_.pop_back();
+  if (pos == heap_.size()) {
+    return;
+  }
+  // Move the last entry into the hole; it may have to go either way.
+  Place(pos, last);
+  SiftUp(pos);
+  SiftDown(position_[last.second]);
+}
+
+void FrameHeap::Update(frame_id_t frame_id, size_t key) {
+  size_t pos = position_[frame_id];
+  size_t old_key = heap_[pos].first;
+  heap_[pos].first = key;
+  if (key < old_key) {
+    SiftUp(pos);
+  } else {
+    SiftDown(pos);
+  }
+}
+
+void FrameHeap::Resize(size_t num_frames) {
+  for (size_t frame_id = num_frames; frame_id < position_.size(); ++frame_id) {
+    BUSTUB_ASSERT(position_[frame_id] == NOT_IN_HEAP, "a frame that is cut off is still in the heap");
+  }
+  position_.resize(num_frames, NOT_IN_HEAP);
+  heap_.reserve(num_frames);
+}
+
+void FrameHeap::Smallest(size_t max_count, std::vector<frame_id_t> *out) const {
+  // Best-first walk of the heap: the next smallest key is always the root of one of the subtrees not visited yet.
+  using Entry = std::pair<size_t, size_t>;  // (key, heap position)
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<>> frontier;
+  if (!heap_.empty()) {
+    frontier.emplace(heap_[0].first, 0);
+  }
+  for (size_t found = 0; found < max_count && !frontier.empty(); ++found) {
+    size_t pos = frontier.top().second;
+    frontier.pop();
+    out->push_back(heap_[pos].second);
+    for (size_t child = 2 * pos + 1; child <= 2 * pos + 2 && child < heap_.size(); ++child) {
+      frontier.emplace(heap_[child].first, child);
+    }
+  }
+}
+
+void FrameHeap::SiftUp(size_t pos) {
+  auto entry = heap_[pos];
+  while (pos > 0) {
+    size_t parent = (pos - 1) / 2;
+    if (heap_[parent].first <= entry.first) {
+      break;
+    }
+    Place(pos, heap_[parent]);
+    pos = parent;
+  }
+  Place(pos, entry);
+}
+
+void FrameHeap::SiftDown(size_t pos) {
+  auto entry = heap_[pos];
+  while (true) {
+    size_t child = 2 * pos + 1;
+    if (child >= heap_.size()) {
+      break;
+    }
+    if (child + 1 < heap_.size() && heap_[child + 1].first < heap_[child].first) {
+      child++;
+    }
+    if (entry.first <= heap_[child].first) {
+      break;
+    }
+    Place(pos, heap_[child]);
+    pos = child;
+  }
+  Place(pos, entry);
+}
+
+void FrameHeap::Place(size_t pos, std::pair<size_t, frame_id_t> entry) {
+  position_[entry.second] = pos;
+  heap_[pos] = entry;
+}
+
+}  // namespace bustub
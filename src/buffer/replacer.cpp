@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer.cpp
+//
+// Identification: src/buffer/replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#include "buffer/replacer.h"
+
+#include "buffer/arc_replacer.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/two_queue_replacer.h"
+#include "common/macros.h"
+#include "common/util/string_util.h"
+
+namespace bustub {
+
+auto MakeReplacer(ReplacementPolicy policy, size_t num_frames, size_t k) -> std::unique_ptr<FrameReplacer> {
+  switch (policy) {
+    case ReplacementPolicy::LRUK:
+      return std::make_unique<LRUKReplacer>(num_frames, k);
+    case ReplacementPolicy::Clock:
+      return std::make_unique<ClockReplacer>(num_frames);
+    case ReplacementPolicy::TwoQueue:
+      return std::make_unique<TwoQueueReplacer>(num_frames);
+    case ReplacementPolicy::ARC:
+      return std::make_unique<ArcReplacer>(num_frames);
+  }
+  UNREACHABLE("unknown replacement policy");
+}
+
+auto ReplacementPolicyName(ReplacementPolicy policy) -> std::string {
+  switch (policy) {
+    case ReplacementPolicy::LRUK:
+      return "lru-k";
+    case ReplacementPolicy::Clock:
+      return "clock";
+    case ReplacementPolicy::TwoQueue:
+      return "2q";
+    case ReplacementPolicy::ARC:
+      return "arc";
+  }
+  UNREACHABLE("unknown replacement policy");
+}
+
+auto ParseReplacementPolicy(const std::string &name, ReplacementPolicy *policy) -> bool {
+  auto lower = StringUtil::Lower(name);
+  for (auto candidate :
+       {ReplacementPolicy::LRUK, ReplacementPolicy::Clock, ReplacementPolicy::TwoQueue, ReplacementPolicy::ARC}) {
+    if (lower == ReplacementPolicyName(candidate)) {
+      *policy = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace bustub
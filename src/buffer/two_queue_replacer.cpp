@@ -0,0 +1,144 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer.cpp
+//
+// Identification: src/buffer/two_queue_replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#include "buffer/two_queue_replacer.h"
+
+#include <algorithm>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+TwoQueueReplacer::TwoQueueReplacer(size_t num_frames)
+    : nodes_(num_frames),
+      a1in_heap_(num_frames),
+      am_heap_(num_frames),
+      a1in_target_(std::max<size_t>(num_frames / 4, 1)),
+      a1out_capacity_(std::max<size_t>(num_frames / 2, 1)) {}
+
+void TwoQueueReplacer::Resize(size_t num_frames) {
+  std::lock_guard<std::mutex> my_lock(latch_);
+  for (size_t frame_id = num_frames; frame_id < nodes_.size(); ++frame_id) {
+    BUSTUB_ASSERT(nodes_[frame_id].queue_ == Queue::None, "a frame that is cut off is still tracked");
+  }
+  nodes_.resize(num_frames);
+  a1in_heap_.Resize(num_frames);
+  am_heap_.Resize(num_frames);
+  a1in_target_ = std::max<size_t>(num_frames / 4, 1);
+  a1out_capacity_ = std::max<size_t>(num_frames / 2, 1);
+  while (a1out_.Size() > a1out_capacity_) {
+    a1out_.PopFront();
+  }
+}
+
+auto TwoQueueReplacer::EvictFromA1In() const -> bool {
+  return !a1in_heap_.Empty() && (a1in_size_ > a1in_target_ || am_heap_.Empty());
+}
+
+auto TwoQueueReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::lock_guard<std::mutex> my_lock(latch_);
+  bool from_a1in = EvictFromA1In();
+  if (!from_a1in && am_heap_.Empty()) {
+    return false;
+  }
+  FrameHeap &heap = from_a1in ? a1in_heap_ : am_heap_;
+  *frame_id = heap.Top();
+  heap.Erase(*frame_id);
+  auto &node = nodes_[*frame_id];
+  if (from_a1in) {
+    a1in_size_--;
+    if (node.page_id_ != INVALID_PAGE_ID) {
+      a1out_.PushBack(node.page_id_);
+      if (a1out_.Size() > a1out_capacity_) {
+        a1out_.PopFront();
+      }
+    }
+  }
+  node = TwoQueueNode();
+  evictable_size_--;
+  return true;
+}
+
+void TwoQueueReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type, page_id_t page_id) {
+  std::lock_guard<std::mutex> my_lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < nodes_.size(), "invalid frame id");
+  auto &node = nodes_[frame_id];
+  size_t now = current_timestamp_++;
+  if (node.queue_ == Queue::None) {
+    node.page_id_ = page_id;
+    node.key_ = now;
+    if (access_type != AccessType::Scan && page_id != INVALID_PAGE_ID && a1out_.Erase(page_id)) {
+      node.queue_ = Queue::Am;
+    } else {
+      node.queue_ = Queue::A1In;
+      a1in_size_++;
+    }
+    return;
+  }
+  if (node.queue_ == Queue::Am) {
+    node.key_ = now;
+    if (node.is_evictable_) {
+      am_heap_.Update(frame_id, now);
+    }
+  }
+  // A re-access in A1in is a correlated reference: the page keeps its place in the FIFO.
+}
+
+void TwoQueueReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::lock_guard<std::mutex> my_lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < nodes_.size(), "invalid frame id");
+  auto &node = nodes_[frame_id];
+  if (node.queue_ == Queue::None || node.is_evictable_ == set_evictable) {
+    return;
+  }
+  node.is_evictable_ = set_evictable;
+  if (set_evictable) {
+    HeapOf(node).Push(frame_id, node.key_);
+    evictable_size_++;
+  } else {
+    HeapOf(node).Erase(frame_id);
+    evictable_size_--;
+  }
+}
+
+void TwoQueueReplacer::Remove(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> my_lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < nodes_.size(), "invalid frame id");
+  auto &node = nodes_[frame_id];
+  if (node.queue_ == Queue::None) {
+    return;
+  }
+  if (node.is_evictable_) {
+    HeapOf(node).Erase(frame_id);
+    evictable_size_--;
+  }
+  if (node.queue_ == Queue::A1In) {
+    a1in_size_--;
+  }
+  node = TwoQueueNode();
+}
+
+auto TwoQueueReplacer::Size() -> size_t {
+  std::lock_guard<std::mutex> my_lock(latch_);
+  return evictable_size_;
+}
+
+auto TwoQueueReplacer::EvictionCandidates(size_t max_count) -> std::vector<frame_id_t> {
+  std::lock_guard<std::mutex> my_lock(latch_);
+  // Evictions may switch queues as A1in shrinks, so the order is only exact for the first candidate.
+  std::vector<frame_id_t> candidates;
+  bool from_a1in = EvictFromA1In();
+  (from_a1in ? a1in_heap_ : am_heap_).Smallest(max_count, &candidates);
+  (from_a1in ? am_heap_ : a1in_heap_).Smallest(max_count - candidates.size(), &candidates);
+  return candidates;
+}
+
+}  // namespace bustub
@@ -127,6 +127,21 @@ void BustubInstance::HandleExplainStatement(Transaction *txn, const ExplainState
 
 void BustubInstance::HandleVariableShowStatement(Transaction *txn, const VariableShowStatement &stmt,
                                                  ResultWriter &writer) {
+  if (stmt.variable_ == "buffer_pool_stats") {
+    writer.BeginTable(false);
+    writer.BeginHeader();
+    writer.WriteHeaderCell("name");
+    writer.WriteHeaderCell("value");
+    writer.EndHeader();
+    for (const auto &[name, value] : buffer_pool_manager_->GetStats().ToRows()) {
+      writer.BeginRow();
+      writer.WriteCell(name);
+      writer.WriteCell(value);
+      writer.EndRow();
+    }
+    writer.EndTable();
+    return;
+  }
   auto content = GetSessionVariable(stmt.variable_);
   WriteOneCell(fmt::format("{}={}", stmt.variable_, content), writer);
 }
@@ -3,6 +3,7 @@
 #include <shared_mutex>
 #include <string>
 #include <tuple>
+#include <utility>
 
 #include "binder/binder.h"
 #include "binder/bound_expression.h"
@@ -57,6 +58,8 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   try {
     buffer_pool_manager_ =
         std::make_unique<BufferPoolManager>(128, disk_manager_.get(), LRUK_REPLACER_K, log_manager_.get());
+    buffer_pool_manager_->SetReadAheadWindow(READ_AHEAD_WINDOW);
+    buffer_pool_manager_->StartWarmLoad();
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
@@ -84,11 +87,13 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   execution_engine_ = std::make_unique<ExecutionEngine>(buffer_pool_manager_.get(), txn_manager_.get(), catalog_.get());
 }
 
-BustubInstance::BustubInstance() {
+BustubInstance::BustubInstance() : BustubInstance(std::make_unique<DiskManagerUnlimitedMemory>()) {}
+
+BustubInstance::BustubInstance(std::unique_ptr<DiskManager> disk_manager) {
   enable_logging = false;
 
   // Storage related.
-  disk_manager_ = std::make_unique<DiskManagerUnlimitedMemory>();
+  disk_manager_ = std::move(disk_manager);
 
   // Log related.
   log_manager_ = std::make_unique<LogManager>(disk_manager_.get());
@@ -98,6 +103,7 @@ BustubInstance::BustubInstance() {
   try {
     buffer_pool_manager_ =
         std::make_unique<BufferPoolManager>(128, disk_manager_.get(), LRUK_REPLACER_K, log_manager_.get());
+    buffer_pool_manager_->SetReadAheadWindow(READ_AHEAD_WINDOW);
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
@@ -180,6 +186,7 @@ void BustubInstance::CmdDisplayHelp(ResultWriter &writer) {
 \dt: show all tables
 \di: show all indices
 \help: show this message again
+show buffer_pool_stats: show buffer pool hit rate, evictions, write-backs and latencies
 
 BusTub shell currently only supports a small set of Postgres queries. We'll set
 up a doc describing the current status later. It will silently ignore some parts
@@ -354,6 +361,9 @@ void BustubInstance::GenerateMockTable() {
 }
 
 BustubInstance::~BustubInstance() {
+  if (buffer_pool_manager_ != nullptr) {
+    buffer_pool_manager_->SaveWarmManifest();
+  }
   if (enable_logging) {
     log_manager_->StopFlushThread();
   }
@@ -20,4 +20,16 @@ std::chrono::duration<int64_t> log_timeout = std::chrono::seconds(1);
 
 std::chrono::milliseconds cycle_detection_interval = std::chrono::milliseconds(50);
 
+std::chrono::milliseconds page_cleaner_interval = std::chrono::milliseconds(10);
+
+std::chrono::milliseconds warm_manifest_interval = std::chrono::seconds(30);
+
+#ifdef NDEBUG
+FrameAllocation frame_allocation = FrameAllocation::HugePageArena;
+#else
+FrameAllocation frame_allocation = FrameAllocation::PerPage;
+#endif
+
+ReplacementPolicy replacement_policy = ReplacementPolicy::LRUK;
+
 }  // namespace bustub
@@ -0,0 +1,42 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// access_trace.h
+//
+// Identification: src/include/buffer/access_trace.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/** One page access recorded by BufferPoolManager::StartAccessTrace(). */
+struct PageAccess {
+  page_id_t page_id_;
+  AccessType access_type_;
+};
+
+/**
+ * @brief Write an access trace as text, one `<page id> <unknown|get|scan>` line per access, so that traces can be
+ * inspected, edited and replayed against other replacement policies.
+ */
+void WriteAccessTrace(std::ostream &out, const std::vector<PageAccess> &trace);
+
+/**
+ * @brief Read an access trace written by WriteAccessTrace(). Empty lines and lines starting with '#' are skipped.
+ * @throws Exception on a malformed line
+ */
+auto ReadAccessTrace(std::istream &in) -> std::vector<PageAccess>;
+
+}  // namespace bustub
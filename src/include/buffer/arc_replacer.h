@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.h
+//
+// Identification: src/include/buffer/arc_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/frame_heap.h"
+#include "buffer/ghost_list.h"
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * ArcReplacer implements the Adaptive Replacement Cache policy of Megiddo and Modha.
+ *
+ * Frames are split between T1, pages accessed once since they were loaded, and T2, pages accessed at least twice.
+ * Pages evicted from T1 and T2 are remembered in the ghost lists B1 and B2. A page loaded again while in B1 shows that
+ * T1 is too small, so the target size p of T1 grows; a page found in B2 shrinks it. Victims come from the LRU end of
+ * T1 while T1 is larger than p, and from the LRU end of T2 otherwise.
+ *
+ * Unlike the original algorithm, the replacer does not know which page is about to be loaded when it picks a victim,
+ * so the tie-break on a B2 hit is dropped. Scan accesses neither promote pages to T2 nor adapt p.
+ */
+class ArcReplacer : public FrameReplacer {
+ public:
+  /** @param num_frames the number of frames the replacer tracks */
+  explicit ArcReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(ArcReplacer);
+
+  ~ArcReplacer() override = default;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,  // NOLINT
+                    page_id_t page_id = INVALID_PAGE_ID) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+  auto EvictionCandidates(size_t max_count) -> std::vector<frame_id_t> override;
+
+  void Resize(size_t num_frames) override;
+
+  /** @return the current target size of T1 */
+  auto GetTarget() -> size_t;
+
+ private:
+  enum class List { None, T1, T2 };
+
+  struct ArcNode {
+    List list_{List::None};
+    bool is_evictable_{false};
+    page_id_t page_id_{INVALID_PAGE_ID};
+    size_t last_access_{0};
+  };
+
+  auto HeapOf(const ArcNode &node) -> FrameHeap & { return node.list_ == List::T1 ? t1_heap_ : t2_heap_; }
+
+  /** @return true if the next victim should come from T1 */
+  auto EvictFromT1() const -> bool;
+
+  /** @brief Keep |T1| + |B1| <= c and |T1| + |T2| + |B1| + |B2| <= 2c by forgetting the oldest ghosts. */
+  void TrimGhosts();
+
+  /** Per-frame bookkeeping, indexed by frame id. */
+  std::vector<ArcNode> nodes_;
+  /** Evictable frames of T1, keyed by their last access. */
+  FrameHeap t1_heap_;
+  /** Evictable frames of T2, keyed by their last access. */
+  FrameHeap t2_heap_;
+  /** Pages recently evicted from T1. */
+  GhostList b1_;
+  /** Pages recently evicted from T2. */
+  GhostList b2_;
+  /** Number of frames in T1 and T2, pinned or not. */
+  size_t t1_size_{0};
+  size_t t2_size_{0};
+  /** Target size of T1. */
+  size_t target_{0};
+  /** The cache size c. */
+  size_t capacity_;
+  size_t current_timestamp_{0};
+  size_t evictable_size_{0};
+  std::mutex latch_;
+};
+
+}  // namespace bustub
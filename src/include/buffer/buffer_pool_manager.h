@@ -12,15 +12,30 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <future>  // NOLINT
 #include <list>
 #include <memory>
 #include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
-#include "buffer/lru_k_replacer.h"
+#include "buffer/access_trace.h"
+#include "buffer/buffer_pool_stats.h"
+#include "buffer/replacer.h"
 #include "common/config.h"
 #include "recovery/log_manager.h"
+#include "storage/disk/async_disk_manager.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/extent_allocator.h"
 #include "storage/page/page.h"
 #include "storage/page/page_guard.h"
 
@@ -28,18 +43,73 @@ namespace bustub {
 
 /**
  * BufferPoolManager reads disk pages to and from its internal buffer pool.
+ *
+ * The frames of the pool are split into `num_instances` partitions. Frame `f` belongs to partition `f % num_instances`
+ * and page `p` is always cached by partition `p % num_instances`. Every partition has its own page table, free list,
+ * replacer and latch, so threads working on pages of different partitions never contend with each other. With a
+ * single instance the pool behaves exactly like one globally latched buffer pool.
+ *
+ * Partition latches are only held for page table and replacer bookkeeping. Disk reads and write-backs run after the
+ * latch is released while the frame's I/O latch is held, so a slow miss only stalls the threads that want that frame.
+ *
+ * An optional background page cleaner writes dirty pages back before the replacer picks them as victims, so that
+ * fetches rarely have to write a page on their own path.
+ *
+ * When a read-ahead window is set, a background worker prefetches pages that a scan is about to need: the next page ids
+ * after a run of sequential AccessType::Scan fetches, or the next pages of a linked chain on request of the scan.
+ *
+ * Pages loaded by AccessType::Scan fetches go to a small ring of frames per partition (a buffer access strategy in
+ * PostgreSQL terms). Once the ring is full, a scan miss recycles the next unpinned frame of the ring instead of asking
+ * the replacer, so a large scan cannot flush the rest of the pool. A page of the ring that is fetched with any other
+ * access type leaves the ring and is managed by the replacer from then on.
+ *
+ * Page metadata is kept in one dense array. Depending on `frame_allocation`, the frame memory is either allocated by
+ * every page on its own, or carved out of one contiguous arena aligned to the page size (or to the huge page size,
+ * with the arena advised to be backed by transparent huge pages).
+ *
+ * Hot pages can be swizzled, in the spirit of LeanStore: their swip, a slot of a table indexed by page id, then points
+ * straight at the frame, and FetchPageReadSwizzled() pins them without the partition latch or the page table. A
+ * swizzled page holds one extra pin, so it is never evicted. Each partition keeps at most a configurable fraction of
+ * its frames swizzled and cools the oldest swizzled page when it needs room, or when nothing else can be evicted:
+ * cooling unswizzles the page and hands it back to the replacer.
+ *
+ * Readers that cannot afford to write the page latch's cache line fetch pages optimistically: they remember the page
+ * version, read, and check afterwards that no writer latched the page in between. Cooling a page bumps its version
+ * too, so a swizzled page can be read without a pin.
+ *
+ * The pool can be resized while it runs. Frame metadata and the arena are reserved up front for
+ * BUFFER_POOL_MAX_GROWTH times the initial size, so that frames never move: growing constructs frames and adds them to
+ * the free lists, shrinking evicts the highest frames one at a time, each under its partition latch only, and hands
+ * their memory back to the OS.
+ *
+ * Batches of page I/O, from FlushAllPages(), consecutive read-ahead and batch pins, go through an AsyncDiskManager,
+ * which keeps up to DISK_IO_QUEUE_DEPTH of them in flight at once. FlushAllPages() and the page cleaner sort the
+ * frames they write by page id, and write every run of consecutive pages with a single vectored write.
+ *
+ * Every partition keeps lock-free counters of hits, misses, evictions, write-backs and pin waits, and histograms of
+ * miss and write latencies. GetStats() sums them up into a snapshot.
+ *
+ * The replacement policy of every partition is chosen by `replacement_policy` when the pool is created: LRU-K, CLOCK,
+ * 2Q or ARC. The page accesses seen by the replacers can be recorded and replayed offline against other policies.
  */
 class BufferPoolManager {
+  // Page guards of swizzled pages are unpinned through the frame.
+  friend class BasicPageGuard;
+
  public:
+  /** Extracts the id of the next page of a page chain from the raw data of a page. */
+  using NextPageFn = std::function<page_id_t(const char *page_data)>;
+
   /**
    * @brief Creates a new BufferPoolManager.
    * @param pool_size the size of the buffer pool
    * @param disk_manager the disk manager
-   * @param replacer_k the lookback constant k for the LRU-K replacer
+   * @param replacer_k the lookback constant k for the LRU-K replacer, ignored by the other replacement policies
    * @param log_manager the log manager (for testing only: nullptr = disable logging). Please ignore this for P1.
+   * @param num_instances the number of independently latched partitions the frames are split into
    */
   BufferPoolManager(size_t pool_size, DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
-                    LogManager *log_manager = nullptr);
+                    LogManager *log_manager = nullptr, size_t num_instances = BUFFER_POOL_INSTANCES);
 
   /**
    * @brief Destroy an existing BufferPoolManager.
@@ -49,9 +119,35 @@ class BufferPoolManager {
   /** @brief Return the size (number of frames) of the buffer pool. */
   auto GetPoolSize() -> size_t { return pool_size_; }
 
+  /** @brief Return the largest size the buffer pool can be resized to. */
+  auto GetMaxPoolSize() const -> size_t { return max_pool_size_; }
+
+  /**
+   * @brief Resize the buffer pool while it is in use. Growing adds free frames. Shrinking releases the highest frames
+   * one by one: their pages are written back if dirty and evicted, and the frame memory is returned to the OS in arena
+   * mode. Other threads only ever wait for the eviction of a single frame of their partition.
+   *
+   * A pinned frame cannot be released. Shrinking waits up to `pin_timeout` for it to be unpinned, then gives up and
+   * leaves the pool at the frames released so far.
+   *
+   * @param new_size the new number of frames, between the number of partitions and GetMaxPoolSize()
+   * @param pin_timeout how long to wait for each pinned frame that has to be released
+   * @return true if the pool has the new size, false if shrinking gave up on a pinned frame
+   */
+  auto ResizePool(size_t new_size, std::chrono::milliseconds pin_timeout = std::chrono::milliseconds(1000)) -> bool;
+
   /** @brief Return the pointer to all the pages in the buffer pool. */
   auto GetPages() -> Page * { return pages_; }
 
+  /** @brief Return how the memory of the frames was allocated. */
+  auto GetFrameAllocation() const -> FrameAllocation { return frame_allocation_; }
+
+  /** @brief Return the replacement policy of the partitions. */
+  auto GetReplacementPolicy() const -> ReplacementPolicy { return replacement_policy_; }
+
+  /** @brief Return the number of partitions the buffer pool is split into. */
+  auto GetNumInstances() -> size_t { return partitions_.size(); }
+
   /**
    * TODO(P1): Add implementation
    *
@@ -67,9 +163,10 @@ class BufferPoolManager {
    * Also, remember to record the access history of the frame in the replacer for the lru-k algorithm to work.
    *
    * @param[out] page_id id of created page
+   * @param extent if set, the page is allocated from the extents of this table heap or index
    * @return nullptr if no new pages could be created, otherwise pointer to new page
    */
-  auto NewPage(page_id_t *page_id) -> Page *;
+  auto NewPage(page_id_t *page_id, ExtentAllocator *extent = nullptr) -> Page *;
 
   /**
    * TODO(P1): Add implementation
@@ -81,9 +178,10 @@ class BufferPoolManager {
    * BasicPageGuard structure.
    *
    * @param[out] page_id, the id of the new page
+   * @param extent if set, the page is allocated from the extents of this table heap or index
    * @return BasicPageGuard holding a new page
    */
-  auto NewPageGuarded(page_id_t *page_id) -> BasicPageGuard;
+  auto NewPageGuarded(page_id_t *page_id, ExtentAllocator *extent = nullptr) -> BasicPageGuard;
 
   /**
    * TODO(P1): Add implementation
@@ -115,11 +213,37 @@ class BufferPoolManager {
    * the returned page already has a read or write latch held, respectively.
    *
    * @param page_id, the id of the page to fetch
+   * @param access_type type of access to the page
    * @return PageGuard holding the fetched page
    */
-  auto FetchPageBasic(page_id_t page_id) -> BasicPageGuard;
-  auto FetchPageRead(page_id_t page_id) -> ReadPageGuard;
-  auto FetchPageWrite(page_id_t page_id) -> WritePageGuard;
+  auto FetchPageBasic(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> BasicPageGuard;
+  auto FetchPageRead(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> ReadPageGuard;
+  auto FetchPageWrite(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> WritePageGuard;
+
+  /**
+   * @brief Pin a batch of pages in one call. The page ids are grouped by partition, and each partition latch is taken
+   * once to pin the cached pages and to take frames for all the misses. The misses are then read back to back in page
+   * id order, outside of the latches.
+   *
+   * A page whose partition has no evictable frame left is skipped, its guard holds no page. Pinning a large batch
+   * takes that many frames away from everyone else, see GetScanBatchSize().
+   *
+   * @param page_ids the pages to fetch, duplicates are allowed
+   * @param access_type type of access to the pages
+   * @return one guard per page id, in the same order
+   */
+  auto FetchPagesBasic(const std::vector<page_id_t> &page_ids, AccessType access_type = AccessType::Unknown)
+      -> std::vector<BasicPageGuard>;
+
+  /**
+   * @brief Like FetchPagesBasic(), but every page is read latched, in the order of `page_ids`. The page ids must be
+   * distinct.
+   */
+  auto FetchPagesRead(const std::vector<page_id_t> &page_ids, AccessType access_type = AccessType::Unknown)
+      -> std::vector<ReadPageGuard>;
+
+  /** @return how many pages a scan should pin ahead with FetchPagesBasic(), at most SCAN_BATCH_SIZE */
+  auto GetScanBatchSize() const -> size_t { return std::clamp<size_t>(pool_size_ / 16, 1, SCAN_BATCH_SIZE); }
 
   /**
    * TODO(P1): Add implementation
@@ -172,43 +296,471 @@ class BufferPoolManager {
    */
   auto DeletePage(page_id_t page_id) -> bool;
 
-  // void Print();
+  /**
+   * @brief Open a tablespace of the disk manager, a database file of its own. Tables and indexes created in it with
+   * Catalog::CreateTable() and CreateIndex() allocate their pages from its file.
+   * @param file_name the database file of the tablespace, created if it does not exist
+   * @return the id of the tablespace
+   */
+  auto CreateTablespace(const std::string &file_name) -> tablespace_id_t;
+
+  /**
+   * @brief Drop a tablespace: discard its cached pages without writing them back, and delete its file. This takes
+   * time in the size of the buffer pool, not of the tablespace.
+   * @param tablespace id of the tablespace
+   * @return false if the tablespace does not exist or one of its pages is pinned
+   */
+  auto DropTablespace(tablespace_id_t tablespace) -> bool;
+
+  /**
+   * @brief Start the background page cleaner.
+   *
+   * Every page_cleaner_interval, the cleaner looks at the frames each partition would evict next and writes the dirty
+   * ones back, so that at least `clean_fraction` of the partition's frames can be reused without a write. When logging
+   * is enabled, pages whose LSN is not yet persistent in the log are skipped (WAL rule).
+   *
+   * @param clean_fraction the target fraction of free or clean evictable frames per partition, in [0, 1]
+   */
+  void StartPageCleaner(double clean_fraction = PAGE_CLEANER_CLEAN_FRACTION);
+
+  /** @brief Stop and join the background page cleaner. Does nothing if it is not running. */
+  void StopPageCleaner();
+
+  /** @return the number of dirty victims written back on the path of a NewPage() or FetchPage() */
+  auto GetForegroundWrites() const -> uint64_t { return GetStats().foreground_writes_; }
+
+  /** @return the number of pages written back by the page cleaner */
+  auto GetBackgroundWrites() const -> uint64_t { return GetStats().background_writes_; }
+
+  /**
+   * @brief Set how many pages ahead of a scan are prefetched. 0 disables read-ahead, which is the default.
+   * @param window the number of pages to prefetch
+   */
+  void SetReadAheadWindow(size_t window);
+
+  /** @return the number of pages prefetched ahead of a scan, 0 if read-ahead is disabled */
+  auto GetReadAheadWindow() const -> size_t { return read_ahead_window_; }
+
+  /**
+   * @brief Asynchronously prefetch up to one read-ahead window of pages of a page chain, starting at (and including)
+   * `page_id`. Pages that are already cached are only used to follow the chain. This is a hint: it does nothing when
+   * read-ahead is disabled or the prefetch queue is full.
+   * @param page_id the first page to prefetch
+   * @param next_page extracts the id of the next page of the chain, INVALID_PAGE_ID ends the chain
+   */
+  void ReadAheadChain(page_id_t page_id, NextPageFn next_page);
+
+  /** @return the number of pages loaded from disk by read-ahead */
+  auto GetReadAheadPages() const -> uint64_t { return read_ahead_pages_; }
+
+  /** @return the number of fetches that found a page loaded by read-ahead before anyone else accessed it */
+  auto GetReadAheadHits() const -> uint64_t { return read_ahead_hits_; }
+
+  /**
+   * @brief Allow up to `fraction` of the frames of every partition to hold swizzled pages. 0 disables swizzling, which
+   * is the default, and cools every swizzled page.
+   */
+  void SetSwizzleFraction(double fraction);
+
+  /**
+   * @brief Fetch a page for reading, like FetchPageRead(). If the page is swizzled, it is pinned through its swip
+   * without taking the partition latch or looking at the page table.
+   */
+  auto FetchPageReadSwizzled(page_id_t page_id) -> ReadPageGuard;
+
+  /**
+   * @brief Swizzle the page held by a read guard so that later FetchPageReadSwizzled() calls take the fast path. Does
+   * nothing if swizzling is disabled or the page is already swizzled.
+   */
+  void SwizzlePage(const ReadPageGuard &guard);
+
+  /**
+   * @brief Fetch a page for an optimistic read: the guard holds no read latch, and everything read through it must be
+   * confirmed with ReadPageGuard::Validate() before it is used. A swizzled page is not even pinned, since cooling it
+   * invalidates the guard; any other page is pinned through the page table. Waits while a writer holds the page.
+   */
+  auto FetchPageOptimistic(page_id_t page_id) -> ReadPageGuard;
+
+  /**
+   * @brief Write the ids of the cached pages to the warm-start manifest of the disk manager, hottest first: pinned
+   * pages, then the others in reverse eviction order of the replacer. The page cleaner also saves the manifest every
+   * `warm_manifest_interval` while it runs.
+   */
+  void SaveWarmManifest();
+
+  /**
+   * @brief Start a background loader that reads the pages of the warm-start manifest into free frames, in page id
+   * order so that the disk sees one forward sweep. Only as many pages as a partition has free frames are loaded, the
+   * hottest ones; pages that are cached by then are skipped.
+   * @return the number of pages the loader will try to read
+   */
+  auto StartWarmLoad() -> size_t;
+
+  /** @brief Wait until the warm-start loader is done. Returns at once if it is not running. */
+  void WaitWarmLoad();
+
+  /** @return the number of fetches served through a swip */
+  auto GetSwizzledFetches() const -> uint64_t { return swizzled_fetches_; }
+
+  /** @return the number of fetches of the given access type that found their page in the buffer pool */
+  auto GetFetchHits(AccessType access_type) const -> uint64_t {
+    return GetStats().hits_[static_cast<size_t>(access_type)];
+  }
+
+  /** @return the number of fetches of the given access type that had to read their page from disk */
+  auto GetFetchMisses(AccessType access_type) const -> uint64_t {
+    return GetStats().misses_[static_cast<size_t>(access_type)];
+  }
+
+  /**
+   * @brief Take a snapshot of the statistics of all partitions. Counters are read one by one without stopping the
+   * pool, so a snapshot taken under load may be off by the operations in flight.
+   */
+  auto GetStats() const -> BufferPoolStats;
+
+  /**
+   * @brief Start recording every page access that reaches a replacer, i.e. every pin through the page table,
+   * discarding any previous recording. Swizzled and optimistic fetches that bypass the page table are not recorded.
+   */
+  void StartAccessTrace();
+
+  /** @brief Stop recording and return the accesses recorded since StartAccessTrace(), in the order they were made. */
+  auto StopAccessTrace() -> std::vector<PageAccess>;
 
  private:
-  /** Number of pages in the buffer pool. */
-  const size_t pool_size_;
-  /** The next page id to be allocated  */
-  std::atomic<page_id_t> next_page_id_ = 0;
+  /**
+   * A partition of the buffer pool. All members are protected by the partition's latch_. The replacer is indexed by
+   * the partition-local frame id, i.e. `frame_id / num_instances`.
+   */
+  struct Partition {
+    Partition(size_t index, size_t num_frames, ReplacementPolicy policy, size_t replacer_k)
+        : index_(index),
+          num_frames_(num_frames),
+          replacer_(MakeReplacer(policy, num_frames, replacer_k)),
+          scan_ring_(std::min(SCAN_RING_SIZE, std::max<size_t>(num_frames / 8, 1)), -1),
+          scan_ring_slot_(num_frames, -1) {}
+
+    /** Index of this partition, every frame and page of the partition is congruent to it. */
+    const size_t index_;
+    /** Number of frames owned by this partition, changes when the pool is resized. */
+    size_t num_frames_;
+    /** Page table for keeping track of the pages cached by this partition. */
+    std::unordered_map<page_id_t, frame_id_t> page_table_;
+    /** Replacer to find unpinned frames of this partition for replacement. */
+    std::unique_ptr<FrameReplacer> replacer_;
+    /** List of free frames of this partition that don't have any pages on them. */
+    std::list<frame_id_t> free_list_;
+    /**
+     * Evicted dirty pages whose write-back is still in flight, mapped to the frame being written from. A fetch of such
+     * a page has to wait for the write to finish, otherwise it would read a stale image from disk.
+     */
+    std::unordered_map<page_id_t, frame_id_t> write_back_;
+    /** Pages of write_back_ deleted by DeletePage(), deallocated once their write-back lands. */
+    std::unordered_set<page_id_t> deleted_write_backs_;
+    /** Frames recycled by scans, -1 for an unused slot. */
+    std::vector<frame_id_t> scan_ring_;
+    /** The slot of scan_ring_ holding each frame, indexed by the partition-local frame id, -1 if not in the ring. */
+    std::vector<int> scan_ring_slot_;
+    /** Number of used slots of scan_ring_. */
+    size_t scan_ring_frames_{0};
+    /** The next slot of scan_ring_ to recycle. */
+    size_t scan_ring_next_{0};
+    /** Frames of the partition holding swizzled pages, in the order they were swizzled. */
+    std::deque<frame_id_t> swizzled_;
+    /** Statistics of the partition. These are atomics and need no latch. */
+    BufferPoolCounters stats_;
+    /** This latch protects the page table, the free list, the replacer and the metadata of the partition's frames. */
+    std::mutex latch_;
+  };
 
-  /** Array of buffer pool pages. */
+  /** Number of frames in the buffer pool. */
+  std::atomic<size_t> pool_size_;
+  /** The number of frames pages_ and the arena have room for. */
+  const size_t max_pool_size_;
+  /** Number of frames of pages_ that have been constructed, frames beyond pool_size_ stay constructed once released. */
+  size_t constructed_frames_{0};
+  /** Serializes ResizePool() calls. */
+  std::mutex resize_latch_;
+  /** Array of buffer pool pages, with room for max_pool_size_ frames. */
   Page *pages_;
+  /** How the memory of the frames is allocated. */
+  const FrameAllocation frame_allocation_;
+  /** The replacement policy of the partitions. */
+  const ReplacementPolicy replacement_policy_;
+  /** Start of the frame memory in arena mode, nullptr for per-page allocation. */
+  char *arena_{nullptr};
+  /** The anonymous mapping holding the arena, which starts early enough to align it. */
+  void *arena_mapping_{nullptr};
+  size_t arena_mapping_size_{0};
   /** Pointer to the disk manager. */
   DiskManager *disk_manager_ __attribute__((__unused__));
   /** Pointer to the log manager. Please ignore this for P1. */
   LogManager *log_manager_ __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  std::unordered_map<page_id_t, frame_id_t> page_table_;
-  /** Replacer to find unpinned pages for replacement. */
-  std::unique_ptr<LRUKReplacer> replacer_;
-  /** List of free frames that don't have any pages on them. */
-  std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
-  std::mutex latch_;
+  /** The partitions of the buffer pool, indexed by `page_id % num_instances`. */
+  std::vector<std::unique_ptr<Partition>> partitions_;
+  /** Keeps the I/O of page batches in flight together. */
+  std::unique_ptr<AsyncDiskManager> async_disk_manager_;
+
+  /** Number of swip entries allocated at once. */
+  static constexpr size_t SWIP_CHUNK_SIZE = 4096;
+  /** Maximum number of swip chunks, pages beyond SWIP_CHUNK_SIZE * MAX_SWIP_CHUNKS are never swizzled. */
+  static constexpr size_t MAX_SWIP_CHUNKS = 16384;
+
+  /** Maximum fraction of the frames of each partition that may be swizzled, 0 = disabled. */
+  std::atomic<double> swizzle_fraction_{0};
+  /** The swips of all pages, indexed by page id, in chunks allocated on first use. A null swip is unswizzled. */
+  std::vector<std::atomic<std::atomic<Page *> *>> swip_chunks_;
+  /** Number of fetches served through a swip. */
+  std::atomic<uint64_t> swizzled_fetches_{0};
+
+  /** The page cleaner thread, nullptr if it is not running. */
+  std::thread *page_cleaner_thread_{nullptr};
+  /** True while the page cleaner should keep running. Protected by page_cleaner_latch_. */
+  bool enable_page_cleaner_{false};
+  /** Target fraction of clean frames per partition. */
+  double clean_fraction_{PAGE_CLEANER_CLEAN_FRACTION};
+  std::mutex page_cleaner_latch_;
+  std::condition_variable page_cleaner_cv_;
+
+  /** A prefetch request: `count` pages starting at `page_id`, following `next_page` or consecutive ids if unset. */
+  struct ReadAheadRequest {
+    page_id_t page_id_;
+    size_t count_;
+    NextPageFn next_page_;
+  };
+
+  /** The warm-start loader thread, nullptr if it is not running. */
+  std::thread *warm_load_thread_{nullptr};
+  /** Set to make the warm-start loader stop early. */
+  std::atomic<bool> stop_warm_load_{false};
+  /** Number of pages read by the warm-start loader. */
+  std::atomic<uint64_t> warm_loaded_pages_{0};
+  /** When the page cleaner last saved the warm-start manifest. */
+  std::chrono::steady_clock::time_point last_warm_manifest_{std::chrono::steady_clock::now()};
+
+  /** True while page accesses are recorded into trace_. */
+  std::atomic<bool> tracing_{false};
+  /** The recorded page accesses. Protected by trace_latch_. */
+  std::vector<PageAccess> trace_;
+  std::mutex trace_latch_;
+
+  /** Maximum number of queued read-ahead requests, further requests are dropped. */
+  static constexpr size_t READ_AHEAD_QUEUE_SIZE = 64;
+
+  /** Number of pages prefetched ahead of a scan, 0 = disabled. */
+  std::atomic<size_t> read_ahead_window_{0};
+  /** The last page fetched with AccessType::Scan, used to detect sequential scans. */
+  std::atomic<page_id_t> last_scan_page_id_{INVALID_PAGE_ID};
+  /** Number of pages loaded by read-ahead. */
+  std::atomic<uint64_t> read_ahead_pages_{0};
+  /** Number of first accesses to pages loaded by read-ahead. */
+  std::atomic<uint64_t> read_ahead_hits_{0};
+  /** The read-ahead worker thread, nullptr until read-ahead is first enabled. */
+  std::thread *read_ahead_thread_{nullptr};
+  /** True while the read-ahead worker should keep running. Protected by read_ahead_latch_. */
+  bool enable_read_ahead_{false};
+  /** Pending prefetch requests. Protected by read_ahead_latch_. */
+  std::deque<ReadAheadRequest> read_ahead_queue_;
+  std::mutex read_ahead_latch_;
+  std::condition_variable read_ahead_cv_;
+
+  /**
+   * @brief Return the swip of a page.
+   * @param create allocate the chunk holding the swip if it does not exist yet
+   * @return the swip, or nullptr if it does not exist
+   */
+  auto GetSwip(page_id_t page_id, bool create) -> std::atomic<Page *> *;
+
+  /** @brief Cool a swizzled page: clear its swip and give back the swizzle pin. Caller should hold the partition latch. */
+  void CoolFrame(Partition &partition, frame_id_t frame_id);
+
+  /**
+   * @brief Forget the unpinned page held by a frame without writing it back, and put the frame on the free list.
+   * Caller should hold the partition latch.
+   */
+  void DiscardFrame(Partition &partition, frame_id_t frame_id);
+
+  /** @brief Read the pages chosen by StartWarmLoad(), in order. Runs on warm_load_thread_. */
+  void RunWarmLoad(std::vector<page_id_t> page_ids);
+
+  /** @brief Read one page of the warm-start manifest into a free frame, unless it is cached already. */
+  void WarmPage(page_id_t page_id);
+
+  /**
+   * @brief Release a pin taken through a swip. The page table is not needed; the partition latch is only taken if this
+   * was the last pin.
+   */
+  void UnpinSwizzledPage(Page *page);
+
+  /** @return the partition that owns the given frame */
+  auto GetFramePartition(frame_id_t frame_id) -> Partition & { return *partitions_[frame_id % partitions_.size()]; }
+
+  /** Alignment of the arena in FrameAllocation::HugePageArena mode. */
+  static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+  /** @brief Map the frame arena. Throws if the memory cannot be mapped. */
+  void AllocateArena();
+
+  /** @brief Construct the frames up to `num_frames` that have never been constructed. */
+  void ConstructFrames(size_t num_frames);
+
+  /**
+   * @brief Take the highest frame of its partition out of the pool, evicting its page. Waits until the deadline if the
+   * frame is pinned.
+   * @return false if the frame is still pinned at the deadline
+   */
+  auto ReleaseFrame(frame_id_t frame_id, std::chrono::steady_clock::time_point deadline) -> bool;
+
+  /** @brief Queue a prefetch request for the read-ahead worker, dropping it if the queue is full. */
+  void EnqueueReadAhead(ReadAheadRequest request);
+
+  /** @brief Main loop of the read-ahead worker thread. */
+  void RunReadAhead();
+
+  /**
+   * @brief Load a page into the buffer pool without pinning it, unless it is already cached.
+   * @param page_id the page to prefetch
+   * @param next_page if set, used to extract the id of the next page from the prefetched page
+   * @param[out] next_page_id the next page of the chain if next_page is set
+   * @return false if every frame of the partition is pinned
+   */
+  auto PrefetchPage(page_id_t page_id, const NextPageFn &next_page, page_id_t *next_page_id) -> bool;
+
+  /**
+   * @brief Load consecutive pages into the buffer pool without pinning them, reading all of them at once. Pages that
+   * are cached, or being written back, are skipped.
+   * @param page_id the first page to prefetch
+   * @param count the number of pages to prefetch
+   */
+  void PrefetchPages(page_id_t page_id, size_t count);
+
+  /** @brief Stop and join the read-ahead worker thread. */
+  void StopReadAhead();
+
+  /** @brief Main loop of the page cleaner thread. */
+  void RunPageCleaner();
+
+  /** @brief Write back the dirty frames of a partition that are next in line for eviction. */
+  void CleanPartition(Partition &partition);
+
+  /** @return the partition that caches the given page */
+  auto GetPartition(page_id_t page_id) -> Partition & { return *partitions_[page_id % partitions_.size()]; }
+
+  /** @return the id of a frame inside the replacer of the partition that owns it */
+  auto ToReplacerFrame(frame_id_t frame_id) -> frame_id_t {
+    return frame_id / static_cast<frame_id_t>(partitions_.size());
+  }
+
+  /** @return the global id of a frame given its partition and its id inside the partition's replacer */
+  auto FromReplacerFrame(const Partition &partition, frame_id_t local_frame_id) -> frame_id_t {
+    return local_frame_id * static_cast<frame_id_t>(partitions_.size()) + static_cast<frame_id_t>(partition.index_);
+  }
+
+  /**
+   * @brief Take a frame of the partition for `page_id`, either from its free list, by recycling a frame of the scan
+   * ring for AccessType::Scan, or by evicting a victim, map the page to it and pin it. The victim is removed from the page table; if it is dirty it is registered in the
+   * partition's write_back_ table. The frame's I/O latch is acquired before returning, so the caller must call
+   * FinishFrameIo() once the frame is loaded. Caller should hold the partition latch.
+   * @param partition the partition to take the frame from
+   * @param page_id the page that will be cached in the frame
+   * @param access_type type of access to the page
+   * @param[out] frame_id the frame that was taken
+   * @param[out] write_back_page_id the dirty victim that must be written back, INVALID_PAGE_ID if none
+   * @return false if every frame of the partition is pinned
+   */
+  auto AcquireFrame(Partition &partition, page_id_t page_id, AccessType access_type, frame_id_t *frame_id,
+                    page_id_t *write_back_page_id) -> bool;
+
+  /**
+   * @brief Unmap the page cached in a frame that is being reused. If the page is dirty it is registered in the
+   * partition's write_back_ table. Caller should hold the partition latch.
+   * @param[out] write_back_page_id the dirty page that must be written back, INVALID_PAGE_ID if none
+   */
+  void EvictFrame(Partition &partition, frame_id_t frame_id, page_id_t *write_back_page_id);
+
+  /**
+   * @brief Pick the next unpinned frame of a full scan ring for reuse, removing it from the replacer. The frame stays
+   * in the ring. Caller should hold the partition latch.
+   * @return false if the ring still has unused slots or all of its frames are pinned
+   */
+  auto RecycleScanFrame(Partition &partition, frame_id_t *frame_id) -> bool;
+
+  /** @brief Put a frame into an unused slot of the scan ring, if there is one. Caller should hold the partition latch. */
+  void JoinScanRing(Partition &partition, frame_id_t frame_id);
+
+  /** @brief Take a frame out of the scan ring, if it is in it. Caller should hold the partition latch. */
+  void LeaveScanRing(Partition &partition, frame_id_t frame_id);
+
+  /**
+   * @brief Write back the dirty victim of a frame taken by AcquireFrame(), if any, and deallocate it if it was deleted
+   * in the meantime. Caller should NOT hold the partition latch.
+   */
+  void WriteBackVictim(Partition &partition, frame_id_t frame_id, page_id_t write_back_page_id);
+
+  /** @brief Release the I/O latch acquired by AcquireFrame(). */
+  void FinishFrameIo(frame_id_t frame_id) { pages_[frame_id].io_latch_.unlock(); }
 
   /**
-   * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Pin a batch of pages, see FetchPagesBasic().
+   * @return the pinned pages, in the order of `page_ids`, nullptr for the pages that could not be pinned
+   */
+  auto PinPages(const std::vector<page_id_t> &page_ids, AccessType access_type) -> std::vector<Page *>;
+
+  /** @brief Block until no I/O is in flight on the frame. The caller must hold a pin on it. */
+  void WaitFrameIo(frame_id_t frame_id);
+
+  /** @brief Write a page to disk, recording the latency of the write in the partition's statistics. */
+  void WritePageTimed(Partition &partition, page_id_t page_id, const char *page_data);
+
+  /**
+   * @brief Submit a write of consecutive pages to the async disk manager, recording its latency in the statistics of
+   * `partition` once it completes.
+   * @return a future that becomes ready once the writes are done
+   */
+  auto WritePagesAsync(Partition &partition, page_id_t page_id, const std::vector<const char *> &pages_data)
+      -> std::future<bool>;
+
+  /** Writes a run of consecutive pages, given the id of the first one and the data of all of them. */
+  using PageRunFn = std::function<void(page_id_t, const std::vector<const char *> &)>;
+
+  /**
+   * @brief Split frames sorted by page id into runs of consecutive pages, so that each run can be written at once.
+   * @param frame_ids the frames, sorted by page id
+   * @param write called for every run, in page id order
+   */
+  void ForEachPageRun(const std::vector<frame_id_t> &frame_ids, const PageRunFn &write);
+
+  /** @brief Pin a frame and record an access to it. Caller should hold the partition latch. */
+  void PinFrame(Partition &partition, frame_id_t frame_id, AccessType access_type);
+
+  /**
+   * @brief Pin a frame for I/O issued by the buffer pool itself, without recording an access in the replacer. Caller
+   * should hold the partition latch.
+   */
+  void PinFrameForIo(Partition &partition, frame_id_t frame_id);
+
+  /** @brief Drop a pin taken by the buffer pool itself. Caller should hold the partition latch. */
+  void UnpinFrame(Partition &partition, frame_id_t frame_id);
+
+  /**
+   * @brief Write a cached page back to disk and clear its dirty flag. The page is pinned for the duration of the write,
+   * which happens outside the partition latch.
+   * @param partition the partition caching the page
+   * @param page_id the page to flush
+   * @return false if the page is not cached
+   */
+  auto FlushPageUnlatched(Partition &partition, page_id_t page_id) -> bool;
+
+  /**
+   * @brief Allocate a page on disk.
    * @return the id of the allocated page
    */
   auto AllocatePage() -> page_id_t;
 
   /**
-   * @brief Deallocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Deallocate a page on disk, so that a later NewPage() can reuse its id.
    * @param page_id id of the page to deallocate
    */
-  void DeallocatePage(page_id_t page_id) {
-    // This is a no-nop right now without a more complex data structure to track deallocated pages
-  }
-
-  // TODO(student): You may add additional private members and helper functions
+  void DeallocatePage(page_id_t page_id) { disk_manager_->DeallocatePage(page_id); }
 };
 }  // namespace bustub
@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_stats.h
+//
+// Identification: src/include/buffer/buffer_pool_stats.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+/** Number of buckets of a LatencyHistogram. */
+static constexpr size_t LATENCY_HISTOGRAM_BUCKETS = 32;
+
+/** A point-in-time copy of a LatencyHistogram. */
+struct LatencyHistogramSnapshot {
+  /** Bucket 0 counts latencies below 1us, bucket i > 0 counts latencies in [2^(i-1), 2^i) us. */
+  std::array<uint64_t, LATENCY_HISTOGRAM_BUCKETS> buckets_{};
+  /** Number of recorded latencies. */
+  uint64_t count_{0};
+  /** Sum of the recorded latencies, in nanoseconds. */
+  uint64_t total_ns_{0};
+
+  /** @return the mean latency in microseconds, 0 if nothing was recorded */
+  auto MeanUs() const -> double;
+
+  /**
+   * @return an upper bound of the given percentile in microseconds: the upper edge of the bucket holding it, 0 if
+   * nothing was recorded
+   * @param percentile the percentile, in [0, 100]
+   */
+  auto PercentileUs(double percentile) const -> uint64_t;
+
+  /** @brief Add the latencies of another snapshot to this one. */
+  void Merge(const LatencyHistogramSnapshot &other);
+};
+
+/**
+ * A histogram of latencies with power-of-two microsecond buckets. Recording is lock-free and only takes two relaxed
+ * atomic increments, so it can sit on the hot path of every buffer pool miss.
+ */
+class LatencyHistogram {
+ public:
+  /** @brief Record one latency. */
+  void Record(std::chrono::nanoseconds latency);
+
+  /** @return a copy of the histogram. Concurrent recordings may or may not be included. */
+  auto Snapshot() const -> LatencyHistogramSnapshot;
+
+ private:
+  std::array<std::atomic<uint64_t>, LATENCY_HISTOGRAM_BUCKETS> buckets_{};
+  std::atomic<uint64_t> total_ns_{0};
+};
+
+/**
+ * The live counters of one buffer pool partition. Every counter is only ever incremented, with relaxed atomics, so
+ * they can be bumped outside of the partition latch.
+ */
+struct BufferPoolCounters {
+  /** Fetches that found their page in the buffer pool, indexed by access type. */
+  std::array<std::atomic<uint64_t>, 3> hits_{};
+  /** Fetches that had to read their page from disk, indexed by access type. */
+  std::array<std::atomic<uint64_t>, 3> misses_{};
+  /** Pages unmapped from a frame to make room for another page. */
+  std::atomic<uint64_t> evictions_{0};
+  /** Dirty victims written back on the path of a NewPage() or FetchPage(). */
+  std::atomic<uint64_t> foreground_writes_{0};
+  /** Pages written back by the page cleaner. */
+  std::atomic<uint64_t> background_writes_{0};
+  /** Pages written by FlushPage() and FlushAllPages(). */
+  std::atomic<uint64_t> flushes_{0};
+  /** Pins that had to wait for I/O in flight on the frame. */
+  std::atomic<uint64_t> pin_waits_{0};
+  /** NewPage() and FetchPage() calls that failed because every frame of the partition was pinned. */
+  std::atomic<uint64_t> no_free_frames_{0};
+  /** Time from detecting a miss until the page is loaded, including the write-back of a dirty victim. */
+  LatencyHistogram miss_latency_;
+  /** Time taken by every page write: write-backs, flushes and the page cleaner. */
+  LatencyHistogram write_latency_;
+
+  /** @brief Increment a counter. */
+  static void Add(std::atomic<uint64_t> &counter, uint64_t delta = 1) {
+    counter.fetch_add(delta, std::memory_order_relaxed);
+  }
+};
+
+/** A point-in-time copy of the counters of a whole buffer pool, as returned by BufferPoolManager::GetStats(). */
+struct BufferPoolStats {
+  std::array<uint64_t, 3> hits_{};
+  std::array<uint64_t, 3> misses_{};
+  uint64_t evictions_{0};
+  uint64_t foreground_writes_{0};
+  uint64_t background_writes_{0};
+  uint64_t flushes_{0};
+  uint64_t pin_waits_{0};
+  uint64_t no_free_frames_{0};
+  /** Pages prefetched ahead of a scan when the snapshot was taken, 0 if read-ahead is disabled. */
+  uint64_t read_ahead_window_{0};
+  uint64_t read_ahead_pages_{0};
+  uint64_t read_ahead_hits_{0};
+  uint64_t swizzled_fetches_{0};
+  uint64_t warm_loaded_pages_{0};
+  LatencyHistogramSnapshot miss_latency_;
+  LatencyHistogramSnapshot write_latency_;
+
+  /** @brief Add the counters of one partition. */
+  void Add(const BufferPoolCounters &counters);
+
+  /** @return the number of fetches of all access types that hit the buffer pool */
+  auto TotalHits() const -> uint64_t;
+
+  /** @return the number of fetches of all access types that missed the buffer pool */
+  auto TotalMisses() const -> uint64_t;
+
+  /** @return the fraction of fetches that hit the buffer pool, 0 if there was no fetch */
+  auto HitRate() const -> double;
+
+  /** @return the statistics as (name, value) pairs, in a stable order */
+  auto ToRows() const -> std::vector<std::pair<std::string, std::string>>;
+};
+
+}  // namespace bustub
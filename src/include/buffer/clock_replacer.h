@@ -12,7 +12,6 @@
 
 #pragma once
 
-#include <list>
 #include <mutex>  // NOLINT
 #include <vector>
 
@@ -23,8 +22,14 @@ namespace bustub {
 
 /**
  * ClockReplacer implements the clock replacement policy, which approximates the Least Recently Used policy.
+ *
+ * The tracked frames sit on a circular array indexed by frame id, each with a reference bit. Accesses set the bit, and
+ * the clock hand sweeps over the evictable frames, clearing the bits it finds set and evicting the first frame whose
+ * bit is already clear. Scan accesses do not set the bit, so pages only touched by scans get no second chance.
+ *
+ * The replacer implements both the buffer pool's FrameReplacer interface and the older Victim/Pin/Unpin interface.
  */
-class ClockReplacer : public Replacer {
+class ClockReplacer : public Replacer, public FrameReplacer {
  public:
   /**
    * Create a new ClockReplacer.
@@ -45,8 +50,35 @@ class ClockReplacer : public Replacer {
 
   auto Size() -> size_t override;
 
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,  // NOLINT
+                    page_id_t page_id = INVALID_PAGE_ID) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto EvictionCandidates(size_t max_count) -> std::vector<frame_id_t> override;
+
+  void Resize(size_t num_frames) override;
+
  private:
-  // TODO(student): implement me!
+  struct ClockFrame {
+    bool tracked_{false};
+    bool evictable_{false};
+    bool referenced_{false};
+  };
+
+  void RecordAccessLatched(frame_id_t frame_id, AccessType access_type);
+  void SetEvictableLatched(frame_id_t frame_id, bool set_evictable);
+
+  /** Clock slots, indexed by frame id. */
+  std::vector<ClockFrame> frames_;
+  /** The next slot the hand looks at. */
+  size_t hand_{0};
+  size_t evictable_size_{0};
+  std::mutex latch_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,64 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_heap.h
+//
+// Identification: src/include/buffer/frame_heap.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * FrameHeap is a binary min-heap of frame ids keyed by timestamps that remembers the position of every frame, so that
+ * the key of any frame can be changed or removed in O(log n). All storage is allocated up front.
+ */
+class FrameHeap {
+ public:
+  explicit FrameHeap(size_t num_frames) : position_(num_frames, NOT_IN_HEAP) { heap_.reserve(num_frames); }
+
+  auto Contains(frame_id_t frame_id) const -> bool { return position_[frame_id] != NOT_IN_HEAP; }
+  auto Empty() const -> bool { return heap_.empty(); }
+  /** @return the frame with the smallest key, the heap must not be empty */
+  auto Top() const -> frame_id_t { return heap_.front().second; }
+
+  /** @brief Insert a frame that is not in the heap. */
+  void Push(frame_id_t frame_id, size_t key);
+
+  /** @brief Remove a frame from the heap, if it is in it. */
+  void Erase(frame_id_t frame_id);
+
+  /** @brief Change the key of a frame that is in the heap. */
+  void Update(frame_id_t frame_id, size_t key);
+
+  /** @brief Change the number of frames the heap can hold. Frames that are cut off must not be in the heap. */
+  void Resize(size_t num_frames);
+
+  /** @brief Append up to max_count frames with the smallest keys to out, in increasing key order. */
+  void Smallest(size_t max_count, std::vector<frame_id_t> *out) const;
+
+ private:
+  static constexpr size_t NOT_IN_HEAP = std::numeric_limits<size_t>::max();
+
+  void SiftUp(size_t pos);
+  void SiftDown(size_t pos);
+  void Place(size_t pos, std::pair<size_t, frame_id_t> entry);
+
+  /** (key, frame id) pairs in heap order. */
+  std::vector<std::pair<size_t, frame_id_t>> heap_;
+  /** Index of every frame in heap_, NOT_IN_HEAP if absent. */
+  std::vector<size_t> position_;
+};
+
+}  // namespace bustub
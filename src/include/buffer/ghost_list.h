@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// ghost_list.h
+//
+// Identification: src/include/buffer/ghost_list.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <unordered_map>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * GhostList remembers the ids of recently evicted pages in eviction order, without their data. Adaptive replacement
+ * policies look a page up in it when the page is loaded again, to learn that it was evicted too early.
+ */
+class GhostList {
+ public:
+  auto Size() const -> size_t { return index_.size(); }
+
+  auto Contains(page_id_t page_id) const -> bool { return index_.count(page_id) != 0; }
+
+  /** @brief Append a page as the most recently evicted one, moving it if it is already in the list. */
+  void PushBack(page_id_t page_id) {
+    Erase(page_id);
+    order_.push_back(page_id);
+    index_.emplace(page_id, std::prev(order_.end()));
+  }
+
+  /** @brief Forget the page evicted longest ago, the list must not be empty. */
+  void PopFront() {
+    index_.erase(order_.front());
+    order_.pop_front();
+  }
+
+  /** @return true if the page was in the list and has been removed */
+  auto Erase(page_id_t page_id) -> bool {
+    auto iter = index_.find(page_id);
+    if (iter == index_.end()) {
+      return false;
+    }
+    order_.erase(iter->second);
+    index_.erase(iter);
+    return true;
+  }
+
+ private:
+  std::list<page_id_t> order_;
+  std::unordered_map<page_id_t, std::list<page_id_t>::iterator> index_;
+};
+
+}  // namespace bustub
@@ -12,35 +12,27 @@
 
 #pragma once
 
-#include <iostream>
-#include <limits>
-#include <list>
 #include <mutex>  // NOLINT
-#include <queue>
-#include <unordered_map>
 #include <vector>
 
+#include "buffer/frame_heap.h"
+#include "buffer/replacer.h"
 #include "common/config.h"
 #include "common/macros.h"
 
 namespace bustub {
 
-enum class AccessType { Unknown = 0, Get, Scan };
-
+/**
+ * Replacement bookkeeping of one frame. The access history itself lives in the replacer, in a ring buffer of k slots
+ * per frame, so that recording an access never allocates.
+ */
 class LRUKNode {
  public:
-  LRUKNode(size_t k, frame_id_t fid) : k_(k), fid_(fid) {}
-  LRUKNode() = default;
-
-  /** History of last seen K timestamps of this page. Least recent timestamp stored in front. */
-  // Remove maybe_unused if you start using them. Feel free to change the member variables as you want.
-  std::list<size_t> history_;
-  size_t pinned_count_{0};
-  size_t k_;
-  frame_id_t fid_;
+  /** Slot of the least recent timestamp in the frame's history ring. */
+  size_t history_head_{0};
+  /** Number of timestamps in the history ring, at most k. */
+  size_t history_size_{0};
   bool is_evictable_{false};
-  LRUKNode *next_{nullptr};
-  LRUKNode *pre_{nullptr};
 };
 
 /**
@@ -53,8 +45,13 @@ class LRUKNode {
  * A frame with less than k historical references is given
  * +inf as its backward k-distance. When multipe frames have +inf backward k-distance,
  * classical LRU algorithm is used to choose victim.
+ *
+ * Only evictable frames are kept in the priority structures: one heap keyed by the first access of the frames with
+ * less than k references, and one keyed by the k-th most recent access of the others. In both cases the key is the
+ * oldest timestamp of the frame's history ring. RecordAccess, SetEvictable, Evict and Remove are O(log n) and do not
+ * allocate.
  */
-class LRUKReplacer {
+class LRUKReplacer : public FrameReplacer {
  public:
   /**
    *
@@ -72,7 +69,7 @@ class LRUKReplacer {
    *
    * @brief Destroys the LRUReplacer.
    */
-  ~LRUKReplacer();
+  ~LRUKReplacer() override = default;
 
   /**
    * TODO(P1): Add implementation
@@ -90,7 +87,7 @@ class LRUKReplacer {
    * @param[out] frame_id id of frame that is evicted.
    * @return true if a frame is evicted successfully, false if no frames can be evicted.
    */
-  auto Evict(frame_id_t *frame_id) -> bool;
+  auto Evict(frame_id_t *frame_id) -> bool override;
 
   /**
    * TODO(P1): Add implementation
@@ -104,8 +101,10 @@ class LRUKReplacer {
    * @param frame_id id of frame that received a new access.
    * @param access_type type of access that was received. This parameter is only needed for
    * leaderboard tests.
+   * @param page_id the page held by the frame, unused by LRU-K
    */
-  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown);
+  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,  // NOLINT
+                    page_id_t page_id = INVALID_PAGE_ID) override;
 
   /**
    * TODO(P1): Add implementation
@@ -124,10 +123,10 @@ class LRUKReplacer {
    * @param frame_id id of frame whose 'evictable' status will be modified
    * @param set_evictable whether the given frame is evictable or not
    */
-  void SetEvictable(frame_id_t frame_id, bool set_evictable);
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
 
   /**
-   * TODO(P1): Add implementationLRUKNode* node = node_store_.find()
+   * TODO(P1): Add implementation
    *
    * @brief Remove an evictable frame from replacer, along with its access history.
    * This function should also decrement replacer's size if removal is successful.
@@ -143,7 +142,7 @@ class LRUKReplacer {
    *
    * @param frame_id id of frame to be removed
    */
-  void Remove(frame_id_t frame_id);
+  void Remove(frame_id_t frame_id) override;
 
   /**
    * TODO(P1): Add implementation
@@ -152,41 +151,41 @@ class LRUKReplacer {
    *
    * @return size_t
    */
-  auto Size() -> size_t;
+  auto Size() -> size_t override;
 
-  // void Print();
-
-  // void AdjustList(frame_id_t frame_id);
-
-  void RemoveNode(const LRUKNode *node);
-
-  void InsertNode(LRUKNode *left, LRUKNode *right);
+  /**
+   * @brief Peek at the frames that would be evicted next, without evicting them.
+   *
+   * @param max_count the maximum number of frames to return
+   * @return up to max_count evictable frames, in the order Evict() would choose them
+   */
+  auto EvictionCandidates(size_t max_count) -> std::vector<frame_id_t> override;
 
-  // void Print() {
-  //   std::cout << "first_q" << '\n';
-  //   for (int &iter : first_q_) {
-  //     std::cout << iter;
-  //   }
-  //   std::cout << '\n';
-  //   std::cout << "second_q" << '\n';
-  //   for (int &iter : second_q_) {
-  //     std::cout << iter;
-  //   }
-  // }
+  void Resize(size_t num_frames) override;
 
  private:
-  // TODO(student): implement me! You can replace these member variables as you like.
-  // Remove maybe_unused if you start using them.
-  std::unordered_map<frame_id_t, LRUKNode *> node_store_;
+  /** @return the timestamp slot of the frame's history ring at the given offset from its least recent access */
+  auto HistorySlot(frame_id_t frame_id, size_t offset) -> size_t & {
+    const auto &node = nodes_[frame_id];
+    return history_[frame_id * k_ + (node.history_head_ + offset) % k_];
+  }
+
+  /** @return the heap an evictable frame with this node belongs to */
+  auto HeapOf(const LRUKNode &node) -> FrameHeap & { return node.history_size_ < k_ ? history_heap_ : cache_heap_; }
+
+  /** Per-frame bookkeeping, indexed by frame id. */
+  std::vector<LRUKNode> nodes_;
+  /** History rings of all frames, k timestamps per frame. */
+  std::vector<size_t> history_;
+  /** Evictable frames with less than k accesses, keyed by their first access. */
+  FrameHeap history_heap_;
+  /** Evictable frames with k accesses, keyed by their k-th most recent access. */
+  FrameHeap cache_heap_;
   size_t current_timestamp_{0};
   size_t evictable_size_{0};  // number of evictable frames of the replacer.
   size_t replacer_size_;      // max size of replacer.
   size_t k_;
   std::mutex latch_;
-  LRUKNode *head1_;  // 1 is the history_list,which stores nodes with pinned_count < k.
-  LRUKNode *head2_;  // 2 is the buffer_list,which stores nodes with pinned_count >= k.
-  LRUKNode *tail1_;
-  LRUKNode *tail2_;
 };
 
 }  // namespace bustub
@@ -12,10 +12,16 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "common/config.h"
 
 namespace bustub {
 
+enum class AccessType { Unknown = 0, Get, Scan };
+
 /**
  * Replacer is an abstract class that tracks page usage.
  */
@@ -47,4 +53,68 @@ class Replacer {
   virtual auto Size() -> size_t = 0;
 };
 
+/**
+ * FrameReplacer is the interface between the buffer pool and its replacement policy. Frame ids are dense, in
+ * [0, num_frames). A frame is tracked from its first RecordAccess() until it is evicted or removed, and only frames
+ * marked evictable may be chosen as victims.
+ */
+class FrameReplacer {
+ public:
+  FrameReplacer() = default;
+  virtual ~FrameReplacer() = default;
+
+  /**
+   * @brief Pick a victim among the evictable frames and stop tracking it.
+   * @param[out] frame_id id of the evicted frame
+   * @return true if a frame was evicted, false if no frame is evictable
+   */
+  virtual auto Evict(frame_id_t *frame_id) -> bool = 0;
+
+  /**
+   * @brief Record an access to a frame, starting to track it if needed.
+   * @param frame_id id of the accessed frame
+   * @param access_type type of the access
+   * @param page_id the page held by the frame, used by policies that remember evicted pages
+   */
+  virtual void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,  // NOLINT
+                            page_id_t page_id = INVALID_PAGE_ID) = 0;
+
+  /** @brief Mark a tracked frame evictable or not, untracked frames are ignored. */
+  virtual void SetEvictable(frame_id_t frame_id, bool set_evictable) = 0;
+
+  /** @brief Stop tracking a frame without evicting it, e.g. because its page was deleted. */
+  virtual void Remove(frame_id_t frame_id) = 0;
+
+  /** @return the number of evictable frames */
+  virtual auto Size() -> size_t = 0;
+
+  /**
+   * @return up to max_count evictable frames, roughly in the order Evict() would choose them, without evicting them
+   */
+  virtual auto EvictionCandidates(size_t max_count) -> std::vector<frame_id_t> = 0;
+
+  /**
+   * @brief Change the number of frames the replacer tracks, when the buffer pool is resized. Frames that are cut off
+   * must have been removed first.
+   */
+  virtual void Resize(size_t num_frames) = 0;
+};
+
+/**
+ * @brief Create the replacer of a replacement policy.
+ * @param policy the replacement policy
+ * @param num_frames the number of frames the replacer tracks
+ * @param k the lookback constant of LRU-K, ignored by the other policies
+ */
+auto MakeReplacer(ReplacementPolicy policy, size_t num_frames, size_t k) -> std::unique_ptr<FrameReplacer>;
+
+/** @return the name of a replacement policy, as accepted by ParseReplacementPolicy() */
+auto ReplacementPolicyName(ReplacementPolicy policy) -> std::string;
+
+/**
+ * @brief Parse the name of a replacement policy: "lru-k", "clock", "2q" or "arc", in any case.
+ * @return false if the name is unknown
+ */
+auto ParseReplacementPolicy(const std::string &name, ReplacementPolicy *policy) -> bool;
+
 }  // namespace bustub
@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer.h
+//
+// Identification: src/include/buffer/two_queue_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/frame_heap.h"
+#include "buffer/ghost_list.h"
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * TwoQueueReplacer implements the full 2Q replacement policy of Johnson and Shasha.
+ *
+ * A newly loaded page enters A1in, a FIFO probation queue; further accesses while it is there are treated as
+ * correlated and do not promote it. When A1in holds more than a quarter of the frames, the oldest page of A1in is
+ * evicted and its id moves to A1out, a ghost queue remembering up to half as many pages as there are frames. A page
+ * loaded again while its id is still in A1out was evicted too early: it goes straight to Am, the LRU main queue. Am is
+ * only evicted from when A1in is within its share.
+ *
+ * Scan accesses never promote a page to Am, so a large scan only churns through A1in. Only evictable frames are kept
+ * in the heaps, as in LRUKReplacer.
+ */
+class TwoQueueReplacer : public FrameReplacer {
+ public:
+  /** @param num_frames the number of frames the replacer tracks */
+  explicit TwoQueueReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(TwoQueueReplacer);
+
+  ~TwoQueueReplacer() override = default;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,  // NOLINT
+                    page_id_t page_id = INVALID_PAGE_ID) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+  auto EvictionCandidates(size_t max_count) -> std::vector<frame_id_t> override;
+
+  void Resize(size_t num_frames) override;
+
+ private:
+  enum class Queue { None, A1In, Am };
+
+  struct TwoQueueNode {
+    Queue queue_{Queue::None};
+    bool is_evictable_{false};
+    page_id_t page_id_{INVALID_PAGE_ID};
+    /** First access for frames of A1in, last access for frames of Am. */
+    size_t key_{0};
+  };
+
+  auto HeapOf(const TwoQueueNode &node) -> FrameHeap & { return node.queue_ == Queue::A1In ? a1in_heap_ : am_heap_; }
+
+  /** @return true if the next victim should come from A1in */
+  auto EvictFromA1In() const -> bool;
+
+  /** Per-frame bookkeeping, indexed by frame id. */
+  std::vector<TwoQueueNode> nodes_;
+  /** Evictable frames of A1in, keyed by their first access. */
+  FrameHeap a1in_heap_;
+  /** Evictable frames of Am, keyed by their last access. */
+  FrameHeap am_heap_;
+  /** Pages recently evicted from A1in. */
+  GhostList a1out_;
+  /** Number of frames in A1in, pinned or not. */
+  size_t a1in_size_{0};
+  /** Share of the frames A1in may hold before it is evicted from, a quarter of the frames. */
+  size_t a1in_target_;
+  /** Maximum number of pages remembered by A1out, half the number of frames. */
+  size_t a1out_capacity_;
+  size_t current_timestamp_{0};
+  size_t evictable_size_{0};
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -222,6 +222,9 @@ class BustubInstance {
 
   BustubInstance();
 
+  /** Create an in-memory instance on top of the given disk manager, e.g. a SimulatedDiskManager. */
+  explicit BustubInstance(std::unique_ptr<DiskManager> disk_manager);
+
   ~BustubInstance();
 
   /**
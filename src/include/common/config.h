@@ -16,6 +16,11 @@
 #include <chrono>  // NOLINT
 #include <cstdint>
 
+/** Size of a page in bytes, set with `cmake -DBUSTUB_PAGE_SIZE=<bytes>`. */
+#ifndef BUSTUB_PAGE_SIZE_BYTES
+#define BUSTUB_PAGE_SIZE_BYTES 4096
+#endif
+
 namespace bustub {
 
 /** Cycle detection is performed every CYCLE_DETECTION_INTERVAL milliseconds. */
@@ -27,21 +32,73 @@ extern std::atomic<bool> enable_logging;
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
 extern std::chrono::duration<int64_t> log_timeout;
 
+/** The buffer pool page cleaner wakes up every PAGE_CLEANER_INTERVAL milliseconds. */
+extern std::chrono::milliseconds page_cleaner_interval;
+
+/** While the page cleaner runs, it saves the buffer pool warm-start manifest every WARM_MANIFEST_INTERVAL. */
+extern std::chrono::milliseconds warm_manifest_interval;
+
+/** How a buffer pool allocates the memory of its frames. */
+enum class FrameAllocation {
+  PerPage,        // one heap allocation per frame, so that ASAN can detect page overflows
+  Arena,          // one page-aligned region for all frames
+  HugePageArena,  // one huge-page-aligned region, advised to be backed by transparent huge pages
+};
+
+/** Frame allocation of newly created buffer pools. Debug builds default to PerPage, others to HugePageArena. */
+extern FrameAllocation frame_allocation;
+
+/** The replacement policy a buffer pool uses to pick victim frames. */
+enum class ReplacementPolicy {
+  LRUK,      // LRU-K, evicting the frame with the largest backward k-distance
+  Clock,     // second-chance CLOCK
+  TwoQueue,  // 2Q: a FIFO probation queue, a ghost queue of pages evicted from it, and an LRU main queue
+  ARC,       // Adaptive Replacement Cache, balancing recency and frequency with two ghost lists
+};
+
+/** Replacement policy of newly created buffer pools. Defaults to LRUK. */
+extern ReplacementPolicy replacement_policy;
+
 static constexpr int INVALID_PAGE_ID = -1;                                           // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                            // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                               // invalid log sequence number
 static constexpr int HEADER_PAGE_ID = 0;                                             // the header page id
-static constexpr int BUSTUB_PAGE_SIZE = 4096;                                        // size of a data page in byte
+static constexpr int BUSTUB_PAGE_SIZE = BUSTUB_PAGE_SIZE_BYTES;                      // size of a data page in byte
 static constexpr int BUFFER_POOL_SIZE = 10;                                          // size of buffer pool
+static constexpr int BUFFER_POOL_INSTANCES = 1;                                      // partitions of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr double PAGE_CLEANER_CLEAN_FRACTION = 0.25;  // fraction of frames the page cleaner keeps clean
+static constexpr int READ_AHEAD_WINDOW = 8;                   // pages prefetched ahead of a table scan
+static constexpr size_t SCAN_RING_SIZE = 32;                  // max frames per partition recycled by table scans
+static constexpr size_t SCAN_BATCH_SIZE = 8;                  // max pages pinned ahead at once by a scan
+static constexpr size_t BUFFER_POOL_MAX_GROWTH = 4;           // a buffer pool can grow to this multiple of its size
+static constexpr size_t DISK_IO_QUEUE_DEPTH = 32;             // max page I/Os in flight of an AsyncDiskManager
+static constexpr size_t DISK_IO_WORKERS = 4;                  // AsyncDiskManager threads when io_uring is unavailable
+static constexpr size_t DIRECT_IO_ALIGNMENT = 4096;           // alignment of buffers, offsets and sizes for O_DIRECT
+static constexpr size_t WRITE_RUN_MAX_PAGES = 64;             // max adjacent pages written by one vectored write
+static constexpr int TABLESPACE_PAGE_BITS = 24;               // low bits of a page id that number pages in a tablespace
+static constexpr int MAX_TABLESPACES = 128;                   // tablespace ids fill the remaining bits of a page id
+static constexpr int DEFAULT_TABLESPACE = 0;                  // the tablespace of the database file itself
+
+/** Contiguous pages reserved at once by a heap or index: 256 KB, which is 64 pages of the default size. */
+static constexpr size_t EXTENT_SIZE = (256 << 10) / BUSTUB_PAGE_SIZE;
+
+/**
+ * Pages are at least one O_DIRECT block, and at most 64 KB, so that offsets within a page fit in 16 bits: table pages
+ * store tuple offsets in 16 bits, and PageCodec matches reach back at most 64 KB.
+ */
+static_assert(BUSTUB_PAGE_SIZE >= static_cast<int>(DIRECT_IO_ALIGNMENT) && BUSTUB_PAGE_SIZE <= (1 << 16) &&
+                  (BUSTUB_PAGE_SIZE & (BUSTUB_PAGE_SIZE - 1)) == 0,
+              "the page size must be a power of two from 4 KB to 64 KB");
 
-using frame_id_t = int32_t;    // frame id type
-using page_id_t = int32_t;     // page id type
-using txn_id_t = int32_t;      // transaction id type
-using lsn_t = int32_t;         // log sequence number type
-using slot_offset_t = size_t;  // slot offset type
+using frame_id_t = int32_t;       // frame id type
+using page_id_t = int32_t;        // page id type
+using tablespace_id_t = int32_t;  // tablespace id type
+using txn_id_t = int32_t;         // transaction id type
+using lsn_t = int32_t;            // log sequence number type
+using slot_offset_t = size_t;     // slot offset type
 using oid_t = uint16_t;
 
 static constexpr int VARCHAR_DEFAULT_LENGTH = 128;  // default length for varchar when constructing the column
@@ -0,0 +1,186 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// async_disk_manager.h
+//
+// Identification: src/include/storage/disk/async_disk_manager.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sys/uio.h>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <future>  // NOLINT
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * AsyncDiskManager keeps many page reads and writes of a DiskManager in flight at once.
+ *
+ * Requests are submitted with a callback or a future and complete in any order. When the disk manager has a database
+ * file and the kernel supports it, the requests go to an io_uring with `queue_depth` entries, and one completion
+ * thread runs the callbacks. Otherwise, for in-memory disk managers or kernels without io_uring, a pool of worker
+ * threads calls DiskManager::ReadPage() and WritePage().
+ *
+ * At most `queue_depth` requests are in flight; submitting more blocks until one completes. Callbacks run on an I/O
+ * thread, so they must be short and must not submit requests themselves. The async disk manager must be destroyed
+ * before the disk manager is shut down; destruction waits for every request in flight.
+ *
+ * If the disk manager is in direct I/O mode, io_uring requests go straight to the disk: their buffers must be aligned
+ * to DIRECT_IO_ALIGNMENT, as the frames of the buffer pool are.
+ */
+class AsyncDiskManager {
+ public:
+  /** Called with true once a request succeeded, false if it failed. */
+  using IoCallback = std::function<void(bool)>;
+
+  /**
+   * @brief Create an async disk manager.
+   * @param disk_manager the disk manager to read and write pages of
+   * @param queue_depth the maximum number of requests in flight
+   * @param use_io_uring try io_uring first; if false, or if io_uring cannot be set up, use worker threads
+   */
+  explicit AsyncDiskManager(DiskManager *disk_manager, size_t queue_depth = DISK_IO_QUEUE_DEPTH,
+                            bool use_io_uring = true);
+
+  ~AsyncDiskManager();
+
+  AsyncDiskManager(const AsyncDiskManager &) = delete;
+  auto operator=(const AsyncDiskManager &) -> AsyncDiskManager & = delete;
+
+  /**
+   * @brief Submit a page read. Reading past the end of the database file fills the page with zeros.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer, which must stay valid until the callback ran
+   * @param callback called once the read is done
+   */
+  void ReadPage(page_id_t page_id, char *page_data, IoCallback callback);
+
+  /**
+   * @brief Submit a page write.
+   * @param page_id id of the page
+   * @param page_data raw page data, which must stay valid and unchanged until the callback ran
+   * @param callback called once the write is done
+   */
+  void WritePage(page_id_t page_id, const char *page_data, IoCallback callback);
+
+  /**
+   * @brief Submit a write of consecutive pages. Every run of pages that are adjacent in the file, up to
+   * WRITE_RUN_MAX_PAGES long, is written by a single vectored request.
+   * @param page_id id of the first page
+   * @param pages_data raw data of the pages `page_id`, `page_id + 1`, ..., which must stay valid and unchanged until
+   * the callback ran
+   * @param callback called once all pages are written, with false if any write failed
+   */
+  void WritePages(page_id_t page_id, const std::vector<const char *> &pages_data, IoCallback callback);
+
+  /** @brief Submit a page read. @return a future that becomes ready with the outcome of the read */
+  auto ReadPage(page_id_t page_id, char *page_data) -> std::future<bool>;
+
+  /** @brief Submit a page write. @return a future that becomes ready with the outcome of the write */
+  auto WritePage(page_id_t page_id, const char *page_data) -> std::future<bool>;
+
+  /** @brief Submit a write of consecutive pages. @return a future that becomes ready with the outcome of the writes */
+  auto WritePages(page_id_t page_id, const std::vector<const char *> &pages_data) -> std::future<bool>;
+
+  /** @return true if requests go through io_uring, false if they are run by worker threads */
+  auto UsesIoUring() const -> bool { return ring_fd_ >= 0; }
+
+  /** @return the maximum number of requests in flight */
+  auto GetQueueDepth() const -> size_t { return queue_depth_; }
+
+ private:
+  struct IoRequest {
+    bool is_write_;
+    page_id_t page_id_;
+    char *page_data_;
+    IoCallback callback_;
+    /** The pages of a vectored write of adjacent pages, starting at page_id_; empty for a single page. */
+    std::vector<iovec> iovecs_;
+    /** The disk manager of the tablespace of page_id_ for io_uring requests, null for the default tablespace. */
+    std::shared_ptr<DiskManager> file_;
+  };
+
+  /** @brief Wait for a free slot and hand a request to io_uring or to the workers. */
+  void Submit(IoRequest request);
+
+  /** @brief Map the rings of an io_uring. @return false if io_uring is not available */
+  auto SetUpIoUring() -> bool;
+
+  /** @brief Unmap the rings and close the io_uring. */
+  void CloseIoUring();
+
+  /** @brief Queue one request to the io_uring, nullptr for the shutdown request. Caller should hold latch_. */
+  void SubmitToIoUring(IoRequest *request);
+
+  /** @brief Finish a request reaped from the io_uring, given the number of bytes transferred or a negative errno. */
+  void FinishIoUringRequest(IoRequest *request, int result);
+
+  /** @brief Reap io_uring completions and run their callbacks until the shutdown request completes. */
+  void RunCompletions();
+
+  /** @brief Run requests of the queue until the async disk manager is destroyed. Runs on every worker thread. */
+  void RunWorker();
+
+  /** @return the disk manager whose database file holds the page of an io_uring request */
+  auto FileOf(const IoRequest &request) const -> DiskManager * {
+    return request.file_ != nullptr ? request.file_.get() : disk_manager_;
+  }
+
+  /** @return the page buffers of a vectored write */
+  static auto PagesOf(const IoRequest &request) -> std::vector<const char *>;
+
+  /** @brief Run the callback of a finished request and give back its slot. */
+  void Complete(IoRequest *request, bool success);
+
+  DiskManager *disk_manager_;
+  const size_t queue_depth_;
+
+  /** Protects the submission ring, the worker queue and in_flight_. */
+  std::mutex latch_;
+  /** Signalled when a request completes. */
+  std::condition_variable slot_cv_;
+  /** Signalled when a request is queued for the workers, or on destruction. */
+  std::condition_variable work_cv_;
+  /** Number of submitted requests whose callback has not run yet. */
+  size_t in_flight_{0};
+  /** True until the destructor runs. Protected by latch_. */
+  bool running_{true};
+
+  /** The io_uring, -1 if the workers are used. */
+  int ring_fd_{-1};
+  void *sq_ring_{nullptr};
+  size_t sq_ring_size_{0};
+  void *cq_ring_{nullptr};
+  size_t cq_ring_size_{0};
+  void *sqes_{nullptr};
+  size_t sqes_size_{0};
+  unsigned *sq_tail_{nullptr};
+  unsigned sq_mask_{0};
+  unsigned *sq_array_{nullptr};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned cq_mask_{0};
+  void *cqes_{nullptr};
+  /** Reaps io_uring completions. */
+  std::thread completion_thread_;
+
+  /** Requests waiting for a worker. Protected by latch_. */
+  std::deque<IoRequest> queue_;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_disk_manager.h
+//
+// Identification: src/include/storage/disk/compressed_disk_manager.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * CompressedDiskManager stores every page compressed with PageCodec, so that tables of small integers and repetitive
+ * strings take fewer bytes to read and write. Frames of the buffer pool still hold uncompressed pages: pages are
+ * compressed in WritePage() and decompressed in ReadPage().
+ *
+ * The database file has its own format: a header block, then slots of whole SLOT_UNITs. A slot starts with a header
+ * naming the page it holds, the compressed size and the capacity of the slot, followed by the compressed page, or the
+ * raw page if compressing it does not save a unit. An indirection map from page id to slot is kept in memory and
+ * rebuilt from the slot headers when the file is opened; a page that has never been written has no slot and reads as
+ * zeros, and is free again after a restart.
+ *
+ * A page is written back in place while it fits its slot. When it outgrows the slot it moves to a free slot of its new
+ * size, or to the end of the file, and the old slot is marked free and handed out again. The write counter of the slot
+ * headers decides which copy of a page wins if a crash leaves two of them behind.
+ */
+class CompressedDiskManager : public DiskManager {
+ public:
+  /** Slots are whole multiples of this many bytes. */
+  static constexpr size_t SLOT_UNIT = 512;
+
+  /**
+   * Creates a new disk manager that keeps compressed pages in the specified database file.
+   * @param db_file the file name of the database file
+   */
+  explicit CompressedDiskManager(const std::string &db_file);
+
+  ~CompressedDiskManager() override;
+
+  /** Compress a page and write it to its slot, moving it to a bigger slot if it no longer fits. */
+  auto WritePage(page_id_t page_id, const char *page_data) -> bool override;
+
+  /** Read the slot of a page and decompress it; a page without a slot reads as zeros. */
+  auto ReadPage(page_id_t page_id, char *page_data) -> bool override;
+
+  /** Free the slot of the page besides deallocating it. */
+  void DeallocatePage(page_id_t page_id) override;
+
+  /** Free the slots of the pages besides deallocating them. */
+  void DeallocateExtent(page_id_t page_id, size_t count) override;
+
+  /** @return the number of bytes of compressed pages read */
+  auto GetNumBytesRead() const -> size_t { return num_bytes_read_; }
+
+  /** @return the number of bytes of compressed pages written */
+  auto GetNumBytesWritten() const -> size_t { return num_bytes_written_; }
+
+  /** @return the number of bytes of the slots that hold pages */
+  auto GetNumSlotBytes() -> size_t;
+
+ protected:
+  /** Disk manager of a tablespace, whose file is opened with OpenSlotFile(). */
+  CompressedDiskManager() = default;
+
+  auto NewTablespace(const std::string &file_name) -> std::unique_ptr<DiskManager> override;
+
+ private:
+  /** Where a page is stored: the slot at `offset_` of `units_` SLOT_UNITs holds `size_` bytes of compressed page. */
+  struct Slot {
+    size_t offset_{0};
+    uint32_t units_{0};
+    uint32_t size_{0};
+  };
+
+  /** Open, or create, the database file and rebuild the indirection map and the free-page map from it. */
+  void OpenSlotFile(const std::string &db_file);
+  /** Read every slot header, keeping the newest copy of each page and freeing the others. */
+  void LoadSlots();
+  /** @return the offset of a free slot of `units` units, taken from the free slots or from the end of the file */
+  auto TakeFreeSlot(uint32_t units) -> size_t;
+  /** Mark a slot free in the file and give it back to the free slots. */
+  void FreeSlot(size_t offset, uint32_t units);
+  /** Take the slot of a page away from it and free the slot. */
+  void FreePageSlot(page_id_t page_id);
+
+  /** Descriptor of the slot file; db_fd_ stays -1, so that nothing reads it as a file of plain pages. */
+  int slot_fd_{-1};
+  /** Protects the members below. */
+  std::mutex slot_latch_;
+  /** The indirection map: the slot of each page, indexed by page id. A slot of 0 units means the page has none. */
+  std::vector<Slot> slots_;
+  /** Offsets of the free slots, indexed by their number of units. */
+  std::vector<std::vector<size_t>> free_slots_;
+  /** Offset past the last slot of the file. */
+  size_t end_offset_{SLOT_UNIT};
+  /** Stamped into the header of every slot written, higher is newer. */
+  uint64_t next_write_counter_{1};
+  std::atomic<size_t> num_bytes_read_{0};
+  std::atomic<size_t> num_bytes_written_{0};
+};
+
+}  // namespace bustub
@@ -12,11 +12,16 @@
 
 #pragma once
 
+#include <sys/types.h>
+#include <algorithm>
+#include <array>
 #include <atomic>
-#include <fstream>
 #include <future>  // NOLINT
-#include <mutex>   // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <shared_mutex>
 #include <string>
+#include <vector>
 
 #include "common/config.h"
 
@@ -25,19 +30,49 @@ namespace bustub {
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
+ *
+ * The database file starts with a header page that records the format version and the page size of the file; a file
+ * with another version or page size is refused when it is opened.
+ *
+ * Deallocated pages are tracked in a free-page map and handed out again before the file grows. The map is persisted in
+ * bitmap pages interleaved with the data pages: every group of PAGES_PER_FREE_MAP data pages is preceded by the bitmap
+ * page that covers it, in which a set bit marks a free page. Page ids stay dense, the disk manager skips the bitmap
+ * pages when it maps a page id to a file offset. Pages past the end of the file are allocated as the file grows, so
+ * only reuses and deallocations have to write the map.
+ *
+ * Pages and log records are read and written with pread()/pwrite() at explicit offsets of raw file descriptors, so
+ * there is no shared file cursor to protect: concurrent reads and writes of different pages run in parallel.
+ *
+ * A disk manager can hold tablespaces besides its database file: more database files, e.g. on other volumes, each with
+ * its own descriptor, header page and free-page map. The high bits of a page id name its tablespace, the low
+ * TABLESPACE_PAGE_BITS bits number the page within the file of the tablespace; DEFAULT_TABLESPACE is the database file
+ * itself. Dropping a tablespace deletes its file, which frees all of its pages at once. Like the catalog, the files of
+ * the tablespaces are not recorded, they have to be created again in the same order after a restart.
+ *
+ * In direct I/O mode the database file is opened with O_DIRECT, so that pages are cached by the buffer pool only and
+ * not a second time by the OS. Page buffers aligned to DIRECT_IO_ALIGNMENT, like the frames of the buffer pool, go
+ * straight to the disk; other buffers are copied through an aligned one. The log stays buffered.
  */
 class DiskManager {
+  friend class AsyncDiskManager;
+
  public:
+  /** Number of data pages covered by one bitmap page of the free-page map. */
+  static constexpr page_id_t PAGES_PER_FREE_MAP = BUSTUB_PAGE_SIZE * 8;
+  /** Number of pages a tablespace can hold. */
+  static constexpr page_id_t MAX_TABLESPACE_PAGES = 1 << TABLESPACE_PAGE_BITS;
+
   /**
    * Creates a new disk manager that writes to the specified database file.
    * @param db_file the file name of the database file to write to
+   * @param direct_io open the database file with O_DIRECT; falls back to buffered I/O if the file system refuses it
    */
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::string &db_file, bool direct_io = false);
 
   /** FOR TEST / LEADERBOARD ONLY, used by DiskManagerMemory */
   DiskManager() = default;
 
-  virtual ~DiskManager() = default;
+  virtual ~DiskManager();
 
   /**
    * Shut down the disk manager and close all the file resources.
@@ -48,15 +83,116 @@ class DiskManager {
    * Write a page to the database file.
    * @param page_id id of the page
    * @param page_data raw page data
+   * @return false on an I/O error
+   */
+  virtual auto WritePage(page_id_t page_id, const char *page_data) -> bool;
+
+  /**
+   * Write consecutive pages to the database file, with one pwritev() per run of pages that are adjacent in the file.
+   * Disk managers without a database file write them one at a time with WritePage().
+   * @param page_id id of the first page
+   * @param pages_data raw data of the pages `page_id`, `page_id + 1`, ...
+   * @return false if any of the pages could not be written
    */
-  virtual void WritePage(page_id_t page_id, const char *page_data);
+  virtual auto WritePages(page_id_t page_id, const std::vector<const char *> &pages_data) -> bool;
 
   /**
-   * Read a page from the database file.
+   * Read a page from the database file. The part of a page beyond the end of the file reads as zeros.
    * @param page_id id of the page
    * @param[out] page_data output buffer
+   * @return false on an I/O error
+   */
+  virtual auto ReadPage(page_id_t page_id, char *page_data) -> bool;
+
+  /**
+   * Allocate a page, reusing the lowest free page id if there is one.
+   * @param tablespace the tablespace to allocate the page in
+   * @return the id of the allocated page
+   */
+  auto AllocatePage(tablespace_id_t tablespace = DEFAULT_TABLESPACE) -> page_id_t;
+
+  /**
+   * Allocate `count` pages with consecutive ids, reusing the lowest run of free pages that are adjacent in the file if
+   * there is one, and growing the database otherwise. Grown extents may straddle a bitmap page of the free-page map.
+   * @param count the number of pages
+   * @param tablespace the tablespace to allocate the pages in
+   * @return the id of the first allocated page
+   */
+  auto AllocateExtent(size_t count, tablespace_id_t tablespace = DEFAULT_TABLESPACE) -> page_id_t;
+
+  /**
+   * Give a page back to the free-page map, so that a later AllocatePage() can reuse it.
+   * @param page_id id of the page to deallocate
+   */
+  virtual void DeallocatePage(page_id_t page_id);
+
+  /**
+   * Give `count` pages with consecutive ids back to the free-page map, writing each bitmap page once.
+   * @param page_id id of the first page
+   * @param count the number of pages
+   */
+  virtual void DeallocateExtent(page_id_t page_id, size_t count);
+
+  /** @return true if the database file bypasses the OS page cache */
+  auto IsDirectIo() const -> bool { return direct_io_; }
+
+  /** @return one past the highest page id that has been allocated in a tablespace */
+  auto GetNextPageId(tablespace_id_t tablespace = DEFAULT_TABLESPACE) const -> page_id_t;
+
+  /** @return the number of free pages of the database file below GetNextPageId() */
+  auto GetNumFreePages() -> size_t;
+
+  /**
+   * Open a tablespace, creating its database file if it does not exist yet. Disk managers without a database file
+   * keep the pages of their tablespaces in memory too.
+   * @param file_name the database file of the tablespace
+   * @return the id of the new tablespace
    */
-  virtual void ReadPage(page_id_t page_id, char *page_data);
+  auto CreateTablespace(const std::string &file_name) -> tablespace_id_t;
+
+  /**
+   * Drop a tablespace and delete its file, without touching its pages. The pages must not be used anymore; I/O that
+   * is already in flight completes against the deleted file.
+   * @param tablespace id of the tablespace
+   * @return false if there is no such tablespace
+   */
+  auto DropTablespace(tablespace_id_t tablespace) -> bool;
+
+  /** @return the tablespace a page belongs to */
+  static auto GetTablespaceId(page_id_t page_id) -> tablespace_id_t { return page_id >> TABLESPACE_PAGE_BITS; }
+
+  /** @return the number of a page within the file of its tablespace */
+  static auto GetLocalPageId(page_id_t page_id) -> page_id_t { return page_id & (MAX_TABLESPACE_PAGES - 1); }
+
+  /** @return the id of the `local_page_id`-th page of a tablespace */
+  static auto MakePageId(tablespace_id_t tablespace, page_id_t local_page_id) -> page_id_t {
+    return (tablespace << TABLESPACE_PAGE_BITS) | local_page_id;
+  }
+
+  /**
+   * Drop the free pages at the end of the database file, truncating it after the last allocated page. Tablespaces are
+   * not compacted.
+   * @return the number of pages dropped
+   */
+  virtual auto Compact() -> size_t;
+
+  /**
+   * Hint that a scan is about to read the pages in order. Does nothing unless a subclass can prefetch them itself.
+   * @param page_id the first page of the scan
+   * @param count the number of pages
+   */
+  virtual void AdviseSequentialRead(page_id_t page_id, size_t count) {}
+
+  /**
+   * Replace the warm-start manifest: the ids of the pages a buffer pool held, hottest first, so that the next buffer
+   * pool over this database can prefetch them. The manifest lives next to the database file, with the extension
+   * ".warm", and is replaced atomically. Disk managers without a database file keep it in memory.
+   * @param page_ids the page ids to remember
+   */
+  void WriteWarmManifest(const std::vector<page_id_t> &page_ids);
+
+  /** @return the page ids of the warm-start manifest, empty if there is none or it is unreadable */
+  auto ReadWarmManifest() -> std::vector<page_id_t>;
 
   /**
    * Flush the entire log buffer into disk.
@@ -83,6 +219,9 @@ class DiskManager {
   /** @return the number of disk writes */
   auto GetNumWrites() const -> int;
 
+  /** @return the number of write system calls saved by writing adjacent pages together */
+  auto GetNumWritesSaved() const -> int { return num_writes_saved_; }
+
   /**
    * Sets the future which is used to check for non-blocking flushes.
    * @param f the non-blocking flush check
@@ -93,19 +232,76 @@ class DiskManager {
   inline auto HasFlushLogFuture() -> bool { return flush_log_f_ != nullptr; }
 
  protected:
-  auto GetFileSize(const std::string &file_name) -> int;
-  // stream to write log file
-  std::fstream log_io_;
+  auto GetFileSize(const std::string &file_name) -> int64_t;
+  /**
+   * Read up to `size` bytes at `offset`, retrying short reads and interrupts.
+   * @return the number of bytes read, less than `size` only at the end of the file, or -1 on an I/O error
+   */
+  static auto PreadFull(int fd, char *data, size_t size, size_t offset) -> ssize_t;
+  /**
+   * Write `size` bytes at `offset`, retrying short writes and interrupts.
+   * @return false on an I/O error
+   */
+  static auto PwriteFull(int fd, const char *data, size_t size, size_t offset) -> bool;
+  /** Open, or create, the log file next to the database file. @return false if the file name has no extension */
+  auto OpenLogFile(const std::string &db_file) -> bool;
+  /** Open, or create, the database file and read its header page and free-page map. Throws if that fails. */
+  void OpenDbFile(const std::string &db_file);
+  /** @return a disk manager for the file of a new tablespace. Disk managers without a file return an in-memory one. */
+  virtual auto NewTablespace(const std::string &file_name) -> std::unique_ptr<DiskManager>;
+  /** @return the disk manager of a tablespace other than DEFAULT_TABLESPACE, nullptr if there is no such tablespace */
+  auto GetTablespace(tablespace_id_t tablespace) const -> std::shared_ptr<DiskManager>;
+  /** @return the offset of a data page in the database file, accounting for the header and bitmap pages before it */
+  static auto GetPageOffset(page_id_t page_id) -> size_t;
+  /** @return the offset of the bitmap page covering `page_id` in the database file */
+  static auto GetFreeMapOffset(page_id_t page_id) -> size_t;
+  /** Write the header page of a new database file, or check the header of an existing one. @return false if invalid */
+  auto CheckFileHeader() -> bool;
+  /** @return the number of pages from `page_id` on, at most `count`, that follow each other without a bitmap page */
+  static auto GetAdjacentRun(page_id_t page_id, size_t count) -> size_t {
+    return std::min<size_t>(count, PAGES_PER_FREE_MAP - page_id % PAGES_PER_FREE_MAP);
+  }
+  /** Read the free-page map back from the database file and find the end of the allocated pages. */
+  void LoadFreeMap();
+  /** Persist the bitmap page covering `page_id`. Requires free_map_latch_. */
+  void WriteFreeMap(page_id_t page_id);
+  /** @return true if `page_id` is marked free. Requires free_map_latch_. */
+  auto IsFree(page_id_t page_id) const -> bool {
+    return static_cast<size_t>(page_id / 8) < free_map_.size() && (free_map_[page_id / 8] & (1 << (page_id % 8))) != 0;
+  }
+  /** Mark `page_id` free or allocated. Requires free_map_latch_. */
+  void SetFree(page_id_t page_id, bool free);
+
+  // descriptor of the log file, opened for appending, -1 for disk managers without a file
+  int log_fd_{-1};
   std::string log_name_;
-  // stream to write db file
-  std::fstream db_io_;
+  // descriptor of the db file, -1 for disk managers without a file
+  int db_fd_{-1};
   std::string file_name_;
-  int num_flushes_{0};
-  int num_writes_{0};
-  bool flush_log_{false};
+  // true if db_fd_ was opened with O_DIRECT
+  bool direct_io_{false};
+  // file of the warm-start manifest, empty if the manifest is kept in memory
+  std::string warm_manifest_name_;
+  /** The warm-start manifest of a disk manager without a database file. Protected by warm_manifest_latch_. */
+  std::vector<page_id_t> warm_manifest_;
+  std::mutex warm_manifest_latch_;
+  std::atomic<int> num_flushes_{0};
+  std::atomic<int> num_writes_{0};
+  std::atomic<int> num_writes_saved_{0};
+  std::atomic<bool> flush_log_{false};
   std::future<void> *flush_log_f_{nullptr};
-  // With multiple buffer pool instances, need to protect file access
-  std::mutex db_io_latch_;
+  /** Protects the free-page map. */
+  std::mutex free_map_latch_;
+  /** One bit per page below next_page_id_, set if the page is free. Grows a bitmap page at a time. */
+  std::vector<uint8_t> free_map_;
+  /** No page below this id is free. */
+  page_id_t first_free_page_id_{0};
+  size_t num_free_pages_{0};
+  std::atomic<page_id_t> next_page_id_{0};
+  /** Protects tablespaces_. I/O holds on to the disk manager of its tablespace instead of the latch. */
+  mutable std::shared_mutex tablespace_latch_;
+  /** The disk managers of the tablespaces, indexed by tablespace id; the slot of DEFAULT_TABLESPACE stays empty. */
+  std::array<std::shared_ptr<DiskManager>, MAX_TABLESPACES> tablespaces_;
 };
 
 }  // namespace bustub
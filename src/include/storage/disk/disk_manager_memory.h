@@ -9,6 +9,8 @@
 // Copyright (c) 2015-2020, Carnegie Mellon University Database Group
 //
 //===----------------------------------------------------------------------===//
+#pragma once
+
 #include <array>
 #include <cstring>
 #include <fstream>
@@ -44,14 +46,18 @@ class DiskManagerMemory : public DiskManager {
    * @param page_id id of the page
    * @param page_data raw page data
    */
-  void WritePage(page_id_t page_id, const char *page_data) override;
+  auto WritePage(page_id_t page_id, const char *page_data) -> bool override;
 
   /**
    * Read a page from the database file.
    * @param page_id id of the page
    * @param[out] page_data output buffer
    */
-  void ReadPage(page_id_t page_id, char *page_data) override;
+  auto ReadPage(page_id_t page_id, char *page_data) -> bool override;
+
+ protected:
+  /** The pages of a tablespace are kept in a DiskManagerUnlimitedMemory, which grows as pages are written. */
+  auto NewTablespace(const std::string &file_name) -> std::unique_ptr<DiskManager> override;
 
  private:
   char *memory_;
@@ -70,10 +76,13 @@ class DiskManagerUnlimitedMemory : public DiskManager {
    * @param page_id id of the page
    * @param page_data raw page data
    */
-  void WritePage(page_id_t page_id, const char *page_data) override {
+  auto WritePage(page_id_t page_id, const char *page_data) -> bool override {
     if (latency_ > 0) {
       std::this_thread::sleep_for(std::chrono::milliseconds(latency_));
     }
+    if (GetTablespaceId(page_id) != DEFAULT_TABLESPACE) {
+      return DiskManager::WritePage(page_id, page_data);
+    }
 
     std::unique_lock<std::mutex> l(mutex_);
     if (page_id >= static_cast<int>(data_.size())) {
@@ -87,6 +96,7 @@ class DiskManagerUnlimitedMemory : public DiskManager {
     l.unlock();
 
     memcpy(ptr->first.data(), page_data, BUSTUB_PAGE_SIZE);
+    return true;
   }
 
   /**
@@ -94,29 +104,38 @@ class DiskManagerUnlimitedMemory : public DiskManager {
    * @param page_id id of the page
    * @param[out] page_data output buffer
    */
-  void ReadPage(page_id_t page_id, char *page_data) override {
+  auto ReadPage(page_id_t page_id, char *page_data) -> bool override {
     if (latency_ > 0) {
       std::this_thread::sleep_for(std::chrono::milliseconds(latency_));
     }
+    if (GetTablespaceId(page_id) != DEFAULT_TABLESPACE) {
+      return DiskManager::ReadPage(page_id, page_data);
+    }
 
     std::unique_lock<std::mutex> l(mutex_);
     if (page_id >= static_cast<int>(data_.size()) || page_id < 0) {
       LOG_WARN("page not exist");
-      return;
+      return false;
     }
     if (data_[page_id] == nullptr) {
       LOG_WARN("page not exist");
-      return;
+      return false;
     }
     std::shared_ptr<ProtectedPage> ptr = data_[page_id];
     std::shared_lock<std::shared_mutex> l_page(ptr->second);
     l.unlock();
 
     memcpy(page_data, ptr->first.data(), BUSTUB_PAGE_SIZE);
+    return true;
   }
 
   void SetLatency(size_t latency_ms) { latency_ = latency_ms; }
 
+ protected:
+  auto NewTablespace(const std::string &file_name) -> std::unique_ptr<DiskManager> override {
+    return std::make_unique<DiskManagerUnlimitedMemory>();
+  }
+
  private:
   std::mutex mutex_;
   using Page = std::array<char, BUSTUB_PAGE_SIZE>;
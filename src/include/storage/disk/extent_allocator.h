@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extent_allocator.h
+//
+// Identification: src/include/storage/disk/extent_allocator.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * ExtentAllocator hands out the pages of one table heap or index. It reserves pages from the disk manager an extent
+ * at a time, a run of consecutive page ids that is contiguous in the database file, and allocates from the current
+ * extent until it is used up. The pages of the structure then stay together on disk instead of being interleaved with
+ * the pages of every other structure, and scanning it reads the file sequentially.
+ *
+ * The pages of the current extent that were never handed out go back to the free-page map when the allocator is
+ * destroyed, e.g. when its table is dropped, so the disk manager must outlive the structure that owns the allocator.
+ *
+ * All extents are reserved in one tablespace, so a structure stays within the file it was created in.
+ */
+class ExtentAllocator {
+ public:
+  /**
+   * @param extent_size the number of pages reserved at a time
+   * @param tablespace the tablespace to reserve the extents in
+   */
+  explicit ExtentAllocator(size_t extent_size = EXTENT_SIZE, tablespace_id_t tablespace = DEFAULT_TABLESPACE)
+      : extent_size_(extent_size), tablespace_(tablespace) {}
+
+  /** Give the unused pages of the current extent back to the disk manager. */
+  ~ExtentAllocator();
+
+  DISALLOW_COPY_AND_MOVE(ExtentAllocator);
+
+  /**
+   * Allocate the next page of the current extent, reserving a new extent from the disk manager if it is used up.
+   * @return the id of the allocated page
+   */
+  auto AllocatePage(DiskManager *disk_manager) -> page_id_t;
+
+  /**
+   * Give back a page returned by AllocatePage() that was not used, e.g. because the buffer pool had no frame for it.
+   * The last allocated page goes back to the extent, any other page to the disk manager.
+   */
+  void ReleasePage(DiskManager *disk_manager, page_id_t page_id);
+
+  /** @return the number of extents reserved so far */
+  auto GetNumExtents() -> size_t;
+
+  /** @return the tablespace the extents are reserved in */
+  auto GetTablespaceId() const -> tablespace_id_t { return tablespace_; }
+
+ private:
+  std::mutex latch_;
+  size_t extent_size_;
+  const tablespace_id_t tablespace_;
+  /** The disk manager the current extent was reserved from, nullptr before the first extent. */
+  DiskManager *disk_manager_{nullptr};
+  /** Next page to hand out of the current extent. */
+  page_id_t next_page_id_{INVALID_PAGE_ID};
+  /** One past the last page of the current extent. */
+  page_id_t end_page_id_{INVALID_PAGE_ID};
+  size_t num_extents_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// mmap_disk_manager.h
+//
+// Identification: src/include/storage/disk/mmap_disk_manager.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <mutex>  // NOLINT
+#include <string>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * MmapDiskManager serves page reads from a read-only shared mapping of the database file, for read-mostly databases
+ * that fit in memory: a read is a memcpy from the OS page cache, without a system call. Writes still go through
+ * pwrite(), and a MAP_SHARED mapping sees them at once.
+ *
+ * The mapping lives in an address range reserved up front, and grows in place as the file grows, so the pointers
+ * handed out by GetMappedPage() stay valid until the disk manager is destroyed. Pages past the mapped end of the file
+ * are read with pread(), which also notices new pages and extends the mapping.
+ */
+class MmapDiskManager : public DiskManager {
+ public:
+  /** Default size of the address range reserved for the mapping. */
+  static constexpr size_t DEFAULT_MAX_MAP_SIZE = static_cast<size_t>(64) << 30;
+
+  /**
+   * Creates a new disk manager that maps the specified database file.
+   * @param db_file the file name of the database file to map
+   * @param max_map_size the largest part of the file that is ever mapped; pages beyond it are read with pread()
+   */
+  explicit MmapDiskManager(const std::string &db_file, size_t max_map_size = DEFAULT_MAX_MAP_SIZE);
+
+  ~MmapDiskManager() override;
+
+  /**
+   * Read a page by copying it out of the mapping.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  auto ReadPage(page_id_t page_id, char *page_data) -> bool override;
+
+  /** Drop the trailing free pages, and unmap the part of the file that is truncated. */
+  auto Compact() -> size_t override;
+
+  /** Ask the kernel to read the pages into the page cache in the background, ahead of a scan. */
+  void AdviseSequentialRead(page_id_t page_id, size_t count) override;
+
+  /**
+   * Zero-copy read access to a page. The data reflects the database file, not the dirty frames of a buffer pool, so
+   * it suits read-only databases. The pointer stays valid until the disk manager is destroyed, but the page must not
+   * be read after Compact() dropped it.
+   * @param page_id id of the page
+   * @return the page inside the mapping, or nullptr if it is not in the file or belongs to a tablespace
+   */
+  auto GetMappedPage(page_id_t page_id) -> const char *;
+
+  /** @return the number of bytes of the database file that are mapped */
+  auto GetMappedSize() const -> size_t { return mapped_size_; }
+
+ private:
+  /** Extend the mapping to the current end of the database file. @return true if the mapping grew */
+  auto GrowMapping() -> bool;
+
+  /** Start of the reserved address range. */
+  char *map_base_{nullptr};
+  /** Size of the reserved address range. */
+  size_t max_map_size_;
+  /** Bytes of the file that are mapped at map_base_, a whole number of pages. Only grows under map_latch_. */
+  std::atomic<size_t> mapped_size_{0};
+  /** Serializes changes of the mapping. */
+  std::mutex map_latch_;
+};
+
+}  // namespace bustub
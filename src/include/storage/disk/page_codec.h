@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_codec.h
+//
+// Identification: src/include/storage/disk/page_codec.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+namespace bustub {
+
+/**
+ * PageCodec is a small LZ77 codec for pages, in the block format of LZ4: a compressed page is a sequence of
+ * sequences, each a token byte, the literal bytes that precede a match and the match, a 2-byte offset back into the
+ * output and its length. The high nibble of the token is the number of literals, the low nibble the match length
+ * minus MIN_MATCH; a nibble of 15 continues in extra bytes of 255 up to the first byte below 255. The last sequence
+ * has literals only.
+ *
+ * Matches are found through a hash table of the last position of each 4-byte prefix, without chains, which trades
+ * some ratio for speed: repeated values, zero padding and the free space of a page compress well.
+ */
+class PageCodec {
+ public:
+  /** Shortest match that is encoded, shorter ones are copied as literals. */
+  static constexpr size_t MIN_MATCH = 4;
+  /** Longest distance a match can reach back, inputs must not be larger. */
+  static constexpr size_t MAX_OFFSET = 65535;
+
+  /**
+   * Compress a buffer.
+   * @param src the data to compress, at most MAX_OFFSET + 1 bytes
+   * @param size the size of the data
+   * @param[out] dst the compressed data
+   * @param capacity the size of `dst`
+   * @return the size of the compressed data, or 0 if it does not fit in `capacity` bytes
+   */
+  static auto Compress(const char *src, size_t size, char *dst, size_t capacity) -> size_t;
+
+  /**
+   * Decompress a buffer written by Compress().
+   * @param src the compressed data
+   * @param size the size of the compressed data
+   * @param[out] dst the decompressed data
+   * @param dst_size the size the data had before it was compressed
+   * @return false if the compressed data is corrupt or does not decompress to exactly `dst_size` bytes
+   */
+  static auto Decompress(const char *src, size_t size, char *dst, size_t dst_size) -> bool;
+};
+
+}  // namespace bustub
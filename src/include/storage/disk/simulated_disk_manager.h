@@ -0,0 +1,124 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// simulated_disk_manager.h
+//
+// Identification: src/include/storage/disk/simulated_disk_manager.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <mutex>               // NOLINT
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+/** The performance model of a simulated disk. The default model costs nothing. */
+struct DiskModel {
+  /** Median service time of a random page I/O. */
+  std::chrono::microseconds latency_{0};
+  /** Spread of the service time: the sigma of a log-normal distribution around the median, 0 for a fixed latency. */
+  double latency_sigma_{0};
+  /** Fraction of the latency paid by an I/O of the page right after the page of the previous I/O. */
+  double sequential_factor_{1};
+  /** Bytes per second the device transfers, shared by all I/Os in service; 0 for unlimited. */
+  size_t bandwidth_{0};
+  /** Number of I/Os the device serves at once; further I/Os queue. */
+  size_t parallelism_{1};
+};
+
+/**
+ * @brief Parse a disk model: a preset, `none`, `nvme`, `ssd` or `hdd`, optionally followed by comma-separated
+ * overrides `latency_us=<n>`, `sigma=<x>`, `sequential_factor=<x>`, `bandwidth_mbps=<n>` and `parallelism=<n>`, e.g.
+ * `ssd,parallelism=4`.
+ * @return false if the spec is malformed
+ */
+auto ParseDiskModel(const std::string &spec, DiskModel *model) -> bool;
+
+/** One page I/O recorded by SimulatedDiskManager::StartIoTrace(). */
+struct DiskIo {
+  /** Microseconds between the start of the trace and the submission of the I/O. */
+  uint64_t submit_us_;
+  page_id_t page_id_;
+  bool is_write_;
+  /** True if the I/O got the sequential discount. */
+  bool sequential_;
+  /** Microseconds spent waiting for a free slot of the device. */
+  uint64_t queue_us_;
+  /** Microseconds from leaving the queue until completion. */
+  uint64_t service_us_;
+};
+
+/**
+ * @brief Write an I/O trace as text, one `<submit us> <page id> <read|write> <seq|rand> <queue us> <service us>` line
+ * per I/O.
+ */
+void WriteIoTrace(std::ostream &out, const std::vector<DiskIo> &trace);
+
+/**
+ * SimulatedDiskManager keeps pages in memory like DiskManagerUnlimitedMemory, but makes every page I/O take as long
+ * as it would on the device described by a DiskModel, so that I/O-bound benchmarks are repeatable on any machine.
+ *
+ * An I/O first waits for one of the `parallelism_` slots of the device. It is then served for its latency, drawn
+ * from a log-normal distribution and discounted if the I/O is sequential, and for its transfer time, which all I/Os
+ * share the bandwidth for; it completes when both are over.
+ */
+class SimulatedDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  /** Create a simulated disk that costs nothing until SetDiskModel() is called, e.g. after loading the data. */
+  SimulatedDiskManager() = default;
+
+  explicit SimulatedDiskManager(const DiskModel &model) { SetDiskModel(model); }
+
+  auto WritePage(page_id_t page_id, const char *page_data) -> bool override;
+
+  auto ReadPage(page_id_t page_id, char *page_data) -> bool override;
+
+  /** Replace the device model. I/Os in service finish under the old one. */
+  void SetDiskModel(const DiskModel &model);
+
+  /** @return the device model */
+  auto GetDiskModel() -> DiskModel;
+
+  /** Start recording every page I/O, dropping what was recorded before. */
+  void StartIoTrace();
+
+  /** Stop recording page I/Os. @return the I/Os recorded since StartIoTrace(), in the order they completed */
+  auto StopIoTrace() -> std::vector<DiskIo>;
+
+ private:
+  /** Block for as long as the device takes to serve an I/O of the page. */
+  void SimulateIo(page_id_t page_id, bool is_write);
+
+  /** Protects everything below. */
+  std::mutex latch_;
+  /** Signalled when a slot of the device frees up. */
+  std::condition_variable slot_cv_;
+  DiskModel model_;
+  std::lognormal_distribution<double> latency_dist_{0, 0};
+  std::mt19937_64 rng_{42};
+  /** Number of I/Os in service. */
+  size_t busy_slots_{0};
+  /** When the I/Os in service are done with the bandwidth. */
+  std::chrono::steady_clock::time_point transfer_end_{};
+  /** Page of the last I/O that entered service, to detect sequential I/O. */
+  page_id_t last_page_id_{INVALID_PAGE_ID};
+  bool tracing_{false};
+  std::chrono::steady_clock::time_point trace_start_{};
+  std::vector<DiskIo> trace_;
+};
+
+}  // namespace bustub
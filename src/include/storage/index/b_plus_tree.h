@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <deque>
+#include <fstream>
 #include <iostream>
 #include <optional>
 #include <queue>
@@ -22,6 +23,7 @@
 #include "common/config.h"
 #include "common/macros.h"
 #include "concurrency/transaction.h"
+#include "storage/disk/extent_allocator.h"
 #include "storage/index/index_iterator.h"
 #include "storage/page/b_plus_tree_header_page.h"
 #include "storage/page/b_plus_tree_internal_page.h"
@@ -32,6 +34,13 @@ namespace bustub {
 
 struct PrintableBPlusTree;
 
+/**
+ * Outcome of an optimistic B+ tree operation: OK when it completed, RETRY when it conflicted with a concurrent writer,
+ * and PESSIMISTIC when it has to change the tree structure (a split, an underflow or a new root), which retrying
+ * optimistically can never do.
+ */
+enum class OptimisticResult { OK, RETRY, PESSIMISTIC };
+
 /**
  * @brief Definition of the Context class.
  *
@@ -87,11 +96,11 @@ class BPlusTree {
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
 
  public:
-  explicit BPlusTree(
-      std::string name, page_id_t header_page_id, BufferPoolManager *buffer_pool_manager,
-      const KeyComparator &comparator, int leaf_max_size = LEAF_PAGE_SIZE - 1,
-      int internal_max_size = INTERNAL_PAGE_SIZE -
-                              1);  // For convinience of writing code,leave one slot for temporary storage
+  // For convinience of writing code,leave one slot for temporary storage. The pages of the tree other than the header
+  // page are allocated in `tablespace`.
+  explicit BPlusTree(std::string name, page_id_t header_page_id, BufferPoolManager *buffer_pool_manager,
+                     const KeyComparator &comparator, int leaf_max_size = LEAF_PAGE_SIZE - 1,
+                     int internal_max_size = INTERNAL_PAGE_SIZE - 1, tablespace_id_t tablespace = DEFAULT_TABLESPACE);
 
   auto BinarySearch(const KeyType &key, const InternalPage *internal_page) -> int;
 
@@ -115,6 +124,19 @@ class BPlusTree {
   void RemoveParentReadLock(Context &ctx, page_id_t pos_page_id);
 
   void RemoveParentWriteLock(Context &ctx, page_id_t pos_page_id);
+
+  // Descend to the leaf that covers `key` without read latches, copying it to `leaf_data`. On success, `parent` holds
+  // an optimistic guard on the leaf's parent (the header page if the root is a leaf, in which case `leaf_page_id` may
+  // be INVALID_PAGE_ID for an empty tree). Returns false on a conflict with a writer.
+  auto OptimisticDescend(const KeyType &key, ReadPageGuard *parent, page_id_t *leaf_page_id, char *leaf_data) -> bool;
+
+  // Optimistic versions of GetValue, Insert and Remove. They return RETRY on a conflict with a writer, and
+  // PESSIMISTIC if the operation has to fall back to latch crabbing because the leaf would split or underflow.
+  auto TryGetValueOptimistic(const KeyType &key, std::vector<ValueType> *result, bool *found) -> OptimisticResult;
+
+  auto TryInsertOptimistic(const KeyType &key, const ValueType &value, bool *inserted) -> OptimisticResult;
+
+  auto TryRemoveOptimistic(const KeyType &key) -> OptimisticResult;
   // Returns true if this B+ tree has no keys and values.
   auto IsEmpty() const -> bool;
 
@@ -137,6 +159,10 @@ class BPlusTree {
 
   auto Begin(const KeyType &key) -> INDEXITERATOR_TYPE;
 
+  // Return up to `max_count` leaves in key order, starting with the leaf that covers `key`, taken from the children of
+  // its parent. Used by the index iterator to pin leaves ahead in batches.
+  auto LeafRun(const KeyType &key, size_t max_count) -> std::vector<page_id_t>;
+
   // Print the B+ tree
   void Print(BufferPoolManager *bpm);
 
@@ -186,6 +212,8 @@ class BPlusTree {
   int leaf_max_size_;
   int internal_max_size_;
   page_id_t header_page_id_;
+  /** Allocates the pages of the tree from extents, so that neighbouring leaves tend to be close on disk. */
+  ExtentAllocator extent_allocator_;
 };
 
 /**
@@ -13,18 +13,36 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include <deque>
+#include <functional>
+#include <vector>
+
 #include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/page_guard.h"
 
 namespace bustub {
 
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
 
+/**
+ * IndexIterator walks the leaf chain of a B+ tree. The leaf it is on stays pinned and is only read latched while a
+ * key-value pair is read. Given a LeafRunFn, the iterator pins the leaves after the current one in batches with one
+ * BufferPoolManager::FetchPagesBasic() call, instead of fetching every leaf on its own.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
  public:
+  /**
+   * Returns up to `max_count` leaves in key order, starting with the leaf that covers `key`, as far as they share a
+   * parent. The result is only a hint, the iterator still follows the leaf chain.
+   */
+  using LeafRunFn = std::function<std::vector<page_id_t>(const KeyType &key, size_t max_count)>;
+
   // you may define your own constructor based on your member variables
   // IndexIterator(page_id_t leaf_page_id, int index, BufferPoolManager *bpm, const KeyComparator &comparator);
-  IndexIterator(page_id_t leaf_page_id, int index, BufferPoolManager *bpm);
+  IndexIterator(page_id_t leaf_page_id, int index, BufferPoolManager *bpm, LeafRunFn leaf_run = nullptr);
+  IndexIterator(IndexIterator &&) noexcept = default;
+  auto operator=(IndexIterator &&) noexcept -> IndexIterator & = default;
   ~IndexIterator();  // NOLINT
 
   auto IsEnd() -> bool;
@@ -42,12 +60,18 @@ class IndexIterator {
   }
 
  private:
+  /** Move to the next leaf of the chain, pinning a batch of the leaves after the current one if none is pinned. */
+  void NextLeaf();
+
   // add your own private member variables here
   page_id_t leaf_page_id_;
   const B_PLUS_TREE_LEAF_PAGE_TYPE *leaf_page_{nullptr};
   BufferPoolManager *bpm_;
   int index_{0};
   MappingType pair_;
+  /** The pinned current leaf, followed by the leaves pinned ahead of it. */
+  std::deque<BasicPageGuard> leaves_;
+  LeafRunFn leaf_run_;
 };
 
 }  // namespace bustub
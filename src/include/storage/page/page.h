@@ -12,8 +12,11 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstring>
 #include <iostream>
+#include <mutex>  // NOLINT
+#include <new>
 
 #include "common/config.h"
 #include "common/rwlatch.h"
@@ -30,14 +33,21 @@ class Page {
   friend class BufferPoolManager;
 
  public:
-  /** Constructor. Zeros out the page data. */
+  /** Constructor. Zeros out the page data, which is aligned for O_DIRECT. */
   Page() {
-    data_ = new char[BUSTUB_PAGE_SIZE];
+    data_ = static_cast<char *>(::operator new[](BUSTUB_PAGE_SIZE, std::align_val_t{DIRECT_IO_ALIGNMENT}));
     ResetMemory();
   }
 
+  /** Constructor for a frame whose memory is owned by someone else, e.g. the buffer pool's arena. Zeros it out. */
+  explicit Page(char *data) : data_(data), owns_data_(false) { ResetMemory(); }
+
   /** Default destructor. */
-  ~Page() { delete[] data_; }
+  ~Page() {
+    if (owns_data_) {
+      ::operator delete[](data_, std::align_val_t{DIRECT_IO_ALIGNMENT});
+    }
+  }
 
   /** @return the actual data contained within this page */
   inline auto GetData() -> char * { return data_; }
@@ -51,11 +61,23 @@ class Page {
   /** @return true if the page in memory has been modified from the page on disk, false otherwise */
   inline auto IsDirty() -> bool { return is_dirty_; }
 
-  /** Acquire the page write latch. */
-  inline void WLatch() { rwlatch_.WLock(); }
+  /** Acquire the page write latch. Makes the version odd until the latch is released. */
+  inline void WLatch() {
+    rwlatch_.WLock();
+    version_.fetch_add(1);
+  }
 
   /** Release the page write latch. */
-  inline void WUnlatch() { rwlatch_.WUnlock(); }
+  inline void WUnlatch() {
+    version_.fetch_add(1, std::memory_order_release);
+    rwlatch_.WUnlock();
+  }
+
+  /**
+   * @return the page version. It is odd while a writer holds the latch and changes whenever the latch is released, so
+   * an optimistic reader that sees the same even version before and after reading knows nothing was written meanwhile.
+   */
+  inline auto GetVersion() -> uint64_t { return version_.load(std::memory_order_acquire); }
 
   /** Acquire the page read latch. */
   inline void RLatch() { rwlatch_.RLock(); }
@@ -85,14 +107,24 @@ class Page {
   // Usually this should be stored as `char data_[BUSTUB_PAGE_SIZE]{};`. But to enable ASAN to detect page overflow,
   // we store it as a ptr.
   char *data_;
+  /** True if data_ was allocated by this page. */
+  bool owns_data_ = true;
   /** The ID of this page. */
   page_id_t page_id_ = INVALID_PAGE_ID;
-  /** The pin count of this page. */
-  int pin_count_ = 0;
+  /** The pin count of this page. Atomic, because swizzled pages are pinned without the buffer pool latch. */
+  std::atomic<int> pin_count_ = 0;
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
   bool is_dirty_ = false;
+  /** True if the page was loaded by read-ahead and has not been fetched since. */
+  bool prefetched_ = false;
+  /** True if the page is reachable through its swip, which holds one pin on it. */
+  bool swizzled_ = false;
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
+  /** Bumped by writers and when the page is cooled; see GetVersion(). */
+  std::atomic<uint64_t> version_ = 0;
+  /** Held by the buffer pool while the frame is being read from or written to disk. */
+  std::mutex io_latch_;
 };
 
 }  // namespace bustub
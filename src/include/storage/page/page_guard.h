@@ -59,10 +59,22 @@ class BasicPageGuard {
    */
   ~BasicPageGuard();
 
+  /** @return false if the guard holds no page, e.g. because the page could not be fetched */
+  auto HasPage() const -> bool { return page_ != nullptr; }
+
   auto PageId() -> page_id_t { return page_->GetPageId(); }
 
   auto GetData() -> const char * { return page_->GetData(); }
 
+  /**
+   * @brief Take the read latch of the guarded page for a short read. The guard keeps its pin either way, so a page held
+   * for longer (e.g. by an iterator) does not block writers in between reads.
+   */
+  void RLatch() { page_->RLatch(); }
+
+  /** @brief Release the read latch taken by RLatch(). */
+  void RUnlatch() { page_->RUnlatch(); }
+
   template <class T>
   auto As() -> const T * {
     return reinterpret_cast<const T *>(GetData());
@@ -79,12 +91,16 @@ class BasicPageGuard {
   }
 
  private:
+  friend class BufferPoolManager;
   friend class ReadPageGuard;
   friend class WritePageGuard;
 
+  /** Null for a guard that borrows a swizzled page without pinning it; see BufferPoolManager::FetchPageOptimistic(). */
   BufferPoolManager *bpm_{nullptr};
   Page *page_{nullptr};
   bool is_dirty_{false};
+  /** True if the page was pinned through its swip, so it is unpinned without the page table. */
+  bool swizzled_{false};
 };
 
 class ReadPageGuard {
@@ -142,9 +158,27 @@ class ReadPageGuard {
     return guard_.As<T>();
   }
 
+  /** @return false if the guard holds no page, e.g. because the page could not be fetched */
+  auto HasPage() const -> bool { return guard_.HasPage(); }
+
+  /** @return true if the guard was taken by BufferPoolManager::FetchPageOptimistic() and holds no read latch */
+  auto IsOptimistic() const -> bool { return optimistic_; }
+
+  /**
+   * @brief Check that the page has not been written since an optimistic guard was taken. Data read through an
+   * optimistic guard may be torn and must not be acted upon until this returns true. Always true for a latched guard.
+   */
+  auto Validate() const -> bool;
+
  private:
+  friend class BufferPoolManager;
+
   // You may choose to get rid of this and add your own private variables.
   BasicPageGuard guard_;
+  /** True if the guard holds no read latch and its reads are checked against version_ instead. */
+  bool optimistic_{false};
+  /** The page version seen when the optimistic guard was taken. */
+  uint64_t version_{0};
 };
 
 class WritePageGuard {
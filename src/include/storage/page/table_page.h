@@ -107,6 +107,8 @@ class TablePage {
 
   static constexpr size_t TUPLE_INFO_SIZE = 16;
   static_assert(sizeof(TupleInfo) == TUPLE_INFO_SIZE);
+  static_assert(BUSTUB_PAGE_SIZE <= UINT16_MAX + 1, "tuple offsets and sizes are 16 bits");
+  static_assert(BUSTUB_PAGE_SIZE / TUPLE_INFO_SIZE <= UINT16_MAX, "tuple counts are 16 bits");
 };
 
 static_assert(sizeof(TablePage) == TABLE_PAGE_HEADER_SIZE);
@@ -16,12 +16,14 @@
 #include <mutex>  // NOLINT
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "common/config.h"
 #include "concurrency/lock_manager.h"
 #include "concurrency/transaction.h"
 #include "recovery/log_manager.h"
+#include "storage/disk/extent_allocator.h"
 #include "storage/page/table_page.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
@@ -41,9 +43,9 @@ class TableHeap {
   /**
    * Create a table heap without a transaction. (open table)
    * @param buffer_pool_manager the buffer pool manager
-   * @param first_page_id the id of the first page
+   * @param tablespace the tablespace that holds the pages of the table
    */
-  explicit TableHeap(BufferPoolManager *bpm);
+  explicit TableHeap(BufferPoolManager *bpm, tablespace_id_t tablespace = DEFAULT_TABLESPACE);
 
   /**
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return std::nullopt.
@@ -64,9 +66,10 @@ class TableHeap {
   /**
    * Read a tuple from the table.
    * @param rid rid of the tuple to read
+   * @param access_type how the page of the tuple is accessed, AccessType::Scan when reading the table sequentially
    * @return the meta and tuple
    */
-  auto GetTuple(RID rid) -> std::pair<TupleMeta, Tuple>;
+  auto GetTuple(RID rid, AccessType access_type = AccessType::Unknown) -> std::pair<TupleMeta, Tuple>;
 
   /**
    * Read a tuple meta from the table. Note: if you want to get tuple and meta together, use `GetTuple` instead
@@ -104,11 +107,20 @@ class TableHeap {
   /** Used for binder tests */
   explicit TableHeap(bool create_table_heap = false);
 
+  /**
+   * @return up to `max_count` page ids of the table, in page chain order, starting with the `from`-th page of the chain
+   */
+  auto GetPageIds(size_t from, size_t max_count) -> std::vector<page_id_t>;
+
   BufferPoolManager *bpm_;
   page_id_t first_page_id_{INVALID_PAGE_ID};
+  /** Allocates the pages of the chain from extents, so that the chain is laid out sequentially on disk. */
+  ExtentAllocator extent_allocator_;
 
   std::mutex latch_;
   page_id_t last_page_id_{INVALID_PAGE_ID}; /* protected by latch_ */
+  /** The pages of the chain, in order, so that scans can pin pages ahead without walking the chain. */
+  std::vector<page_id_t> page_ids_; /* protected by latch_ */
 };
 
 }  // namespace bustub
@@ -13,12 +13,14 @@
 #pragma once
 
 #include <cassert>
+#include <deque>
 #include <memory>
 #include <utility>
 
 #include "common/macros.h"
 #include "common/rid.h"
 #include "concurrency/transaction.h"
+#include "storage/page/page_guard.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -27,6 +29,12 @@ class TableHeap;
 
 /**
  * TableIterator enables the sequential scan of a TableHeap.
+ *
+ * The iterator keeps a window of at most BufferPoolManager::GetScanBatchSize() pages pinned: the page it is on and
+ * the pages after it. Pages are unpinned as soon as the scan moves past them, and the window is topped up with one
+ * FetchPagesBasic() call once half of it was consumed, so that walking the heap takes a partition latch once per
+ * batch instead of once per tuple. Pages are only read latched while a tuple is read. If the buffer pool has no frame
+ * left for the page the scan is on, the iterator throws an Exception.
  */
 class TableIterator {
   friend class Cursor;
@@ -34,7 +42,13 @@ class TableIterator {
  public:
   DISALLOW_COPY(TableIterator);
 
-  TableIterator(TableHeap *table_heap, RID rid, RID stop_at_rid);
+  /**
+   * @param table_heap the heap to scan
+   * @param rid the first tuple of the scan
+   * @param page_index the position of the page of `rid` in the page chain of the heap
+   * @param stop_at_rid the tuple to stop at, or an invalid rid to scan to the end of the heap
+   */
+  TableIterator(TableHeap *table_heap, RID rid, size_t page_index, RID stop_at_rid);
   TableIterator(TableIterator &&) = default;
 
   ~TableIterator() = default;
@@ -48,9 +62,23 @@ class TableIterator {
   auto operator++() -> TableIterator &;
 
  private:
+  /** Ask the buffer pool to read ahead the page chain starting at the given page, every half read-ahead window. */
+  void ReadAhead(page_id_t page_id);
+
+  /** @return the pinned page of rid_, after unpinning the pages before it and topping up the window after it */
+  auto CurrentPage() -> BasicPageGuard &;
+
   TableHeap *table_heap_;
   RID rid_;
 
+  /** Number of pages to enter before the next read-ahead request. */
+  size_t pages_until_read_ahead_{0};
+
+  /** Pinned window of the page chain. The front is the page of rid_ once CurrentPage() was called. */
+  std::deque<BasicPageGuard> pages_;
+  /** Position in the page chain of the first page that was not pinned yet. */
+  size_t next_page_index_{0};
+
   // When creating table iterator, we will record the maximum RID that we should scan.
   // Otherwise we will have dead loops when updating while scanning. (In project 4, update should be implemented as
   // deletion + insertion.)
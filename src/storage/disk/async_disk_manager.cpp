@@ -0,0 +1,378 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// async_disk_manager.cpp
+//
+// Identification: src/storage/disk/async_disk_manager.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/async_disk_manager.h"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <utility>
+
+#include "common/logger.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/** @brief Thin wrapper of the io_uring_enter system call, retried when interrupted by a signal. */
+static auto IoUringEnter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags) -> int {
+  int ret;
+  do {
+    ret = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+  } while (ret < 0 && errno == EINTR);
+  return ret;
+}
+
+AsyncDiskManager::AsyncDiskManager(DiskManager *disk_manager, size_t queue_depth, bool use_io_uring)
+    : disk_manager_(disk_manager), queue_depth_(queue_depth) {
+  BUSTUB_ENSURE(queue_depth_ > 0, "queue depth must be positive");
+  if (use_io_uring && disk_manager_->db_fd_ >= 0 && SetUpIoUring()) {
+    completion_thread_ = std::thread(&AsyncDiskManager::RunCompletions, this);
+    return;
+  }
+  for (size_t i = 0; i < std::min(queue_depth_, DISK_IO_WORKERS); ++i) {
+    workers_.emplace_back(&AsyncDiskManager::RunWorker, this);
+  }
+}
+
+AsyncDiskManager::~AsyncDiskManager() {
+  {
+    std::unique_lock<std::mutex> lock(latch_);
+    slot_cv_.wait(lock, [&] { return in_flight_ == 0; });
+    running_ = false;
+    if (UsesIoUring()) {
+      SubmitToIoUring(nullptr);
+    }
+  }
+  work_cv_.notify_all();
+  if (completion_thread_.joinable()) {
+    completion_thread_.join();
+  }
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+  CloseIoUring();
+}
+
+void AsyncDiskManager::ReadPage(page_id_t page_id, char *page_data, IoCallback callback) {
+  Submit({false, page_id, page_data, std::move(callback), {}, nullptr});
+}
+
+void AsyncDiskManager::WritePage(page_id_t page_id, const char *page_data, IoCallback callback) {
+  // The buffer is only read from, the request type is shared with reads.
+  Submit({true, page_id, const_cast<char *>(page_data), std::move(callback), {}, nullptr});  // NOLINT
+}
+
+void AsyncDiskManager::WritePages(page_id_t page_id, const std::vector<const char *> &pages_data,
+                                  IoCallback callback) {
+  if (pages_data.empty()) {
+    callback(true);
+    return;
+  }
+  // The callback runs once the last run is written.
+  struct Batch {
+    std::atomic<size_t> pending_;
+    std::atomic<bool> success_{true};
+    IoCallback callback_;
+  };
+  std::vector<std::pair<size_t, size_t>> runs;
+  for (size_t i = 0; i < pages_data.size();) {
+    size_t run = DiskManager::GetAdjacentRun(page_id + static_cast<page_id_t>(i),
+                                             std::min(pages_data.size() - i, WRITE_RUN_MAX_PAGES));
+    runs.emplace_back(i, run);
+    i += run;
+  }
+  auto batch = std::make_shared<Batch>();
+  batch->pending_ = runs.size();
+  batch->callback_ = std::move(callback);
+  auto on_run_done = [batch](bool success) {
+    if (!success) {
+      batch->success_ = false;
+    }
+    if (--batch->pending_ == 0) {
+      batch->callback_(batch->success_);
+    }
+  };
+  for (auto [first, run] : runs) {
+    // The buffers are only read from, the request type is shared with reads.
+    IoRequest request{true, page_id + static_cast<page_id_t>(first), const_cast<char *>(pages_data[first]),  // NOLINT
+                      on_run_done, {}, nullptr};
+    if (run > 1) {
+      for (size_t i = first; i < first + run; i++) {
+        request.iovecs_.push_back({const_cast<char *>(pages_data[i]), BUSTUB_PAGE_SIZE});  // NOLINT
+      }
+    }
+    Submit(std::move(request));
+  }
+}
+
+auto AsyncDiskManager::ReadPage(page_id_t page_id, char *page_data) -> std::future<bool> {
+  auto promise = std::make_shared<std::promise<bool>>();
+  auto future = promise->get_future();
+  ReadPage(page_id, page_data, [promise](bool success) { promise->set_value(success); });
+  return future;
+}
+
+auto AsyncDiskManager::WritePage(page_id_t page_id, const char *page_data) -> std::future<bool> {
+  auto promise = std::make_shared<std::promise<bool>>();
+  auto future = promise->get_future();
+  WritePage(page_id, page_data, [promise](bool success) { promise->set_value(success); });
+  return future;
+}
+
+auto AsyncDiskManager::WritePages(page_id_t page_id, const std::vector<const char *> &pages_data)
+    -> std::future<bool> {
+  auto promise = std::make_shared<std::promise<bool>>();
+  auto future = promise->get_future();
+  WritePages(page_id, pages_data, [promise](bool success) { promise->set_value(success); });
+  return future;
+}
+
+void AsyncDiskManager::Submit(IoRequest request) {
+  if (UsesIoUring()) {
+    // io_uring needs the descriptor of the request's file, and the file must stay open until the request completes.
+    tablespace_id_t tablespace = DiskManager::GetTablespaceId(request.page_id_);
+    if (tablespace != DEFAULT_TABLESPACE) {
+      request.file_ = disk_manager_->GetTablespace(tablespace);
+      if (request.file_ == nullptr) {
+        LOG_DEBUG("I/O on page %d of a tablespace that does not exist", request.page_id_);
+        request.callback_(false);
+        return;
+      }
+    }
+  }
+  std::unique_lock<std::mutex> lock(latch_);
+  slot_cv_.wait(lock, [&] { return in_flight_ < queue_depth_; });
+  in_flight_++;
+  if (UsesIoUring()) {
+    SubmitToIoUring(new IoRequest(std::move(request)));
+    return;
+  }
+  queue_.push_back(std::move(request));
+  lock.unlock();
+  work_cv_.notify_one();
+}
+
+auto AsyncDiskManager::SetUpIoUring() -> bool {
+  io_uring_params params{};
+  ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, static_cast<unsigned>(queue_depth_), &params));
+  if (ring_fd_ < 0) {
+    LOG_DEBUG("io_uring is not available, using worker threads");
+    return false;
+  }
+  // IORING_OP_READ and IORING_OP_WRITE came with the same kernel release as this feature flag.
+  if ((params.features & IORING_FEAT_RW_CUR_POS) == 0) {
+    CloseIoUring();
+    return false;
+  }
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+  sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                  IORING_OFF_SQ_RING);
+  if (sq_ring_ == MAP_FAILED) {
+    sq_ring_ = nullptr;
+    CloseIoUring();
+    return false;
+  }
+  if (single_mmap) {
+    // Both rings share one mapping, which is unmapped with the submission ring.
+    cq_ring_ = sq_ring_;
+    cq_ring_size_ = 0;
+  } else {
+    cq_ring_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                    IORING_OFF_CQ_RING);
+    if (cq_ring_ == MAP_FAILED) {
+      cq_ring_ = nullptr;
+      CloseIoUring();
+      return false;
+    }
+  }
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  sqes_ = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+  if (sqes_ == MAP_FAILED) {
+    sqes_ = nullptr;
+    CloseIoUring();
+    return false;
+  }
+  auto *sq = static_cast<char *>(sq_ring_);
+  auto *cq = static_cast<char *>(cq_ring_);
+  sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+  sq_mask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+  cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+  cq_mask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+  cqes_ = cq + params.cq_off.cqes;
+  return true;
+}
+
+void AsyncDiskManager::CloseIoUring() {
+  if (sqes_ != nullptr) {
+    munmap(sqes_, sqes_size_);
+    sqes_ = nullptr;
+  }
+  if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  cq_ring_ = nullptr;
+  if (sq_ring_ != nullptr) {
+    munmap(sq_ring_, sq_ring_size_);
+    sq_ring_ = nullptr;
+  }
+  if (ring_fd_ >= 0) {
+    close(ring_fd_);
+    ring_fd_ = -1;
+  }
+}
+
+void AsyncDiskManager::SubmitToIoUring(IoRequest *request) {
+  // Only submitters write the tail, and they hold latch_.
+  unsigned tail = *sq_tail_;
+  unsigned index = tail & sq_mask_;
+  auto *sqe = static_cast<io_uring_sqe *>(sqes_) + index;
+  std::memset(sqe, 0, sizeof(*sqe));
+  if (request == nullptr) {
+    sqe->opcode = IORING_OP_NOP;
+    sqe->fd = -1;
+  } else if (!request->iovecs_.empty()) {
+    sqe->opcode = IORING_OP_WRITEV;
+    sqe->fd = FileOf(*request)->db_fd_;
+    sqe->addr = reinterpret_cast<uint64_t>(request->iovecs_.data());
+    sqe->len = request->iovecs_.size();
+    sqe->off = DiskManager::GetPageOffset(DiskManager::GetLocalPageId(request->page_id_));
+  } else {
+    sqe->opcode = request->is_write_ ? IORING_OP_WRITE : IORING_OP_READ;
+    sqe->fd = FileOf(*request)->db_fd_;
+    sqe->addr = reinterpret_cast<uint64_t>(request->page_data_);
+    sqe->len = BUSTUB_PAGE_SIZE;
+    sqe->off = DiskManager::GetPageOffset(DiskManager::GetLocalPageId(request->page_id_));
+  }
+  sqe->user_data = reinterpret_cast<uint64_t>(request);
+  sq_array_[index] = index;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  // At most queue_depth_ requests are in flight, so neither ring can overflow and the submission cannot be refused.
+  if (IoUringEnter(ring_fd_, 1, 0, 0) < 0) {
+    LOG_DEBUG("io_uring_enter failed: %s", std::strerror(errno));
+  }
+}
+
+void AsyncDiskManager::RunCompletions() {
+  while (true) {
+    unsigned head = __atomic_load_n(cq_head_, __ATOMIC_RELAXED);
+    if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+      IoUringEnter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS);
+      continue;
+    }
+    auto *cqe = static_cast<io_uring_cqe *>(cqes_) + (head & cq_mask_);
+    auto *request = reinterpret_cast<IoRequest *>(cqe->user_data);
+    int result = cqe->res;
+    __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+    if (request == nullptr) {
+      // The shutdown request is only submitted once nothing else is in flight.
+      return;
+    }
+    FinishIoUringRequest(request, result);
+    delete request;
+  }
+}
+
+void AsyncDiskManager::FinishIoUringRequest(IoRequest *request, int result) {
+  if (result < 0) {
+    LOG_DEBUG("I/O error on page %d: %s", request->page_id_, std::strerror(-result));
+    Complete(request, false);
+    return;
+  }
+  auto done = static_cast<size_t>(result);
+  if (!request->iovecs_.empty()) {
+    size_t num_pages = request->iovecs_.size();
+    if (done < num_pages * BUSTUB_PAGE_SIZE) {
+      // A short vectored write is rare enough to be redone synchronously.
+      Complete(request, disk_manager_->WritePages(request->page_id_, PagesOf(*request)));
+      return;
+    }
+    disk_manager_->num_writes_ += num_pages;
+    disk_manager_->num_writes_saved_ += num_pages - 1;
+    Complete(request, true);
+    return;
+  }
+  if (!request->is_write_) {
+    // Like DiskManager::ReadPage(), the part of a page beyond the end of the file reads as zeros.
+    std::memset(request->page_data_ + done, 0, BUSTUB_PAGE_SIZE - done);
+    Complete(request, true);
+    return;
+  }
+  // A short write is rare enough to finish synchronously.
+  size_t offset = DiskManager::GetPageOffset(DiskManager::GetLocalPageId(request->page_id_));
+  while (done < BUSTUB_PAGE_SIZE) {
+    ssize_t written =
+        pwrite(FileOf(*request)->db_fd_, request->page_data_ + done, BUSTUB_PAGE_SIZE - done, offset + done);
+    if (written <= 0) {
+      LOG_DEBUG("I/O error while writing page %d", request->page_id_);
+      Complete(request, false);
+      return;
+    }
+    done += written;
+  }
+  disk_manager_->num_writes_ += 1;
+  Complete(request, true);
+}
+
+void AsyncDiskManager::RunWorker() {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (true) {
+    work_cv_.wait(lock, [&] { return !running_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return;
+    }
+    IoRequest request = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+    bool success;
+    if (!request.iovecs_.empty()) {
+      success = disk_manager_->WritePages(request.page_id_, PagesOf(request));
+    } else if (request.is_write_) {
+      success = disk_manager_->WritePage(request.page_id_, request.page_data_);
+    } else {
+      success = disk_manager_->ReadPage(request.page_id_, request.page_data_);
+    }
+    Complete(&request, success);
+    lock.lock();
+  }
+}
+
+auto AsyncDiskManager::PagesOf(const IoRequest &request) -> std::vector<const char *> {
+  std::vector<const char *> pages_data;
+  pages_data.reserve(request.iovecs_.size());
+  for (const auto &iov : request.iovecs_) {
+    pages_data.push_back(static_cast<const char *>(iov.iov_base));
+  }
+  return pages_data;
+}
+
+void AsyncDiskManager::Complete(IoRequest *request, bool success) {
+  request->callback_(success);
+  {
+    std::scoped_lock lock(latch_);
+    in_flight_--;
+  }
+  slot_cv_.notify_all();
+}
+
+}  // namespace bustub
@@ -0,0 +1,359 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_disk_manager.cpp
+//
+// Identification: src/storage/disk/compressed_disk_manager.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/compressed_disk_manager.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "storage/disk/page_codec.h"
+
+namespace bustub {
+
+/** Magic number at the start of a compressed database file ("BTCZ"). */
+static constexpr uint32_t COMPRESSED_FILE_MAGIC = 0x5a435442;
+/** Version of the compressed file format. */
+static constexpr uint32_t COMPRESSED_FILE_VERSION = 1;
+
+/** The start of the header block of a compressed database file. The rest of the block is zero. */
+struct CompressedFileHeader {
+  uint32_t magic_;
+  uint32_t version_;
+  uint32_t page_size_;
+  uint32_t slot_unit_;
+};
+
+/** The start of a slot. A free slot holds INVALID_PAGE_ID. */
+struct SlotHeader {
+  uint64_t write_counter_;
+  page_id_t page_id_;
+  uint32_t units_;
+  /** Bytes of compressed page after the header, BUSTUB_PAGE_SIZE for a page stored raw. */
+  uint32_t size_;
+  uint32_t reserved_;
+};
+
+/** @return the number of slot units a slot holding `size` bytes of page takes */
+static constexpr auto UnitsFor(size_t size) -> uint32_t {
+  return (sizeof(SlotHeader) + size + CompressedDiskManager::SLOT_UNIT - 1) / CompressedDiskManager::SLOT_UNIT;
+}
+
+/** The size of the slot of a raw page, the largest slot there is. */
+static constexpr uint32_t MAX_SLOT_UNITS = UnitsFor(BUSTUB_PAGE_SIZE);
+
+static_assert(sizeof(CompressedFileHeader) <= CompressedDiskManager::SLOT_UNIT,
+              "the file header must fit in the header block");
+static_assert(BUSTUB_PAGE_SIZE <= PageCodec::MAX_OFFSET + 1, "PageCodec cannot compress pages this large");
+
+/**
+ * Constructor: open/create the compressed database file & the log file
+ */
+CompressedDiskManager::CompressedDiskManager(const std::string &db_file) {
+  file_name_ = db_file;
+  if (!OpenLogFile(db_file)) {
+    return;
+  }
+  try {
+    OpenSlotFile(db_file);
+  } catch (...) {
+    close(log_fd_);
+    log_fd_ = -1;
+    throw;
+  }
+}
+
+CompressedDiskManager::~CompressedDiskManager() {
+  if (slot_fd_ >= 0) {
+    close(slot_fd_);
+  }
+}
+
+/**
+ * Compress the page, then write it in place if it fits its slot, or move it to a slot of its new size
+ */
+auto CompressedDiskManager::WritePage(page_id_t page_id, const char *page_data) -> bool {
+  if (GetTablespaceId(page_id) != DEFAULT_TABLESPACE) {
+    return DiskManager::WritePage(page_id, page_data);
+  }
+  alignas(SlotHeader) char slot_data[MAX_SLOT_UNITS * SLOT_UNIT];
+  char *payload = slot_data + sizeof(SlotHeader);
+  // a page is only worth compressing if that saves a unit, otherwise it is stored raw and costs no decompression
+  size_t size = PageCodec::Compress(page_data, BUSTUB_PAGE_SIZE, payload,
+                                    (MAX_SLOT_UNITS - 1) * SLOT_UNIT - sizeof(SlotHeader));
+  if (size == 0) {
+    memcpy(payload, page_data, BUSTUB_PAGE_SIZE);
+    size = BUSTUB_PAGE_SIZE;
+  }
+  uint32_t units = UnitsFor(size);
+  Slot old_slot;
+  Slot slot;
+  bool moved;
+  uint64_t write_counter;
+  {
+    std::scoped_lock scoped_slot_latch(slot_latch_);
+    if (slots_.size() <= static_cast<size_t>(page_id)) {
+      slots_.resize(page_id + 1);
+    }
+    old_slot = slots_[page_id];
+    moved = old_slot.units_ < units;
+    if (moved) {
+      slot = {TakeFreeSlot(units), units, static_cast<uint32_t>(size)};
+    } else {
+      slot = {old_slot.offset_, old_slot.units_, static_cast<uint32_t>(size)};
+    }
+    write_counter = next_write_counter_++;
+  }
+  SlotHeader header{write_counter, page_id, slot.units_, slot.size_, 0};
+  memcpy(slot_data, &header, sizeof(header));
+  num_writes_ += 1;
+  if (!PwriteFull(slot_fd_, slot_data, sizeof(header) + size, slot.offset_)) {
+    LOG_DEBUG("I/O error while writing");
+    if (moved) {
+      FreeSlot(slot.offset_, slot.units_);
+    }
+    return false;
+  }
+  num_bytes_written_ += sizeof(header) + size;
+  {
+    std::scoped_lock scoped_slot_latch(slot_latch_);
+    slots_[page_id] = slot;
+  }
+  // the old copy is only given up once the new one is on disk
+  if (moved && old_slot.units_ != 0) {
+    FreeSlot(old_slot.offset_, old_slot.units_);
+  }
+  return true;
+}
+
+/**
+ * Read the slot of the page through the indirection map and decompress it into the frame
+ */
+auto CompressedDiskManager::ReadPage(page_id_t page_id, char *page_data) -> bool {
+  if (GetTablespaceId(page_id) != DEFAULT_TABLESPACE) {
+    return DiskManager::ReadPage(page_id, page_data);
+  }
+  Slot slot;
+  {
+    std::scoped_lock scoped_slot_latch(slot_latch_);
+    if (static_cast<size_t>(page_id) < slots_.size()) {
+      slot = slots_[page_id];
+    }
+  }
+  if (slot.units_ == 0) {
+    memset(page_data, 0, BUSTUB_PAGE_SIZE);
+    return true;
+  }
+  alignas(SlotHeader) char slot_data[MAX_SLOT_UNITS * SLOT_UNIT];
+  size_t length = sizeof(SlotHeader) + slot.size_;
+  if (PreadFull(slot_fd_, slot_data, length, slot.offset_) != static_cast<ssize_t>(length)) {
+    LOG_DEBUG("I/O error while reading");
+    memset(page_data, 0, BUSTUB_PAGE_SIZE);
+    return false;
+  }
+  num_bytes_read_ += length;
+  SlotHeader header;
+  memcpy(&header, slot_data, sizeof(header));
+  const char *payload = slot_data + sizeof(SlotHeader);
+  if (header.page_id_ != page_id || header.size_ != slot.size_) {
+    LOG_DEBUG("slot of page %d holds another page", page_id);
+    memset(page_data, 0, BUSTUB_PAGE_SIZE);
+    return false;
+  }
+  if (slot.size_ == BUSTUB_PAGE_SIZE) {
+    memcpy(page_data, payload, BUSTUB_PAGE_SIZE);
+    return true;
+  }
+  if (!PageCodec::Decompress(payload, slot.size_, page_data, BUSTUB_PAGE_SIZE)) {
+    LOG_DEBUG("page %d is corrupt", page_id);
+    memset(page_data, 0, BUSTUB_PAGE_SIZE);
+    return false;
+  }
+  return true;
+}
+
+void CompressedDiskManager::DeallocatePage(page_id_t page_id) {
+  if (GetTablespaceId(page_id) == DEFAULT_TABLESPACE) {
+    FreePageSlot(page_id);
+  }
+  DiskManager::DeallocatePage(page_id);
+}
+
+void CompressedDiskManager::DeallocateExtent(page_id_t page_id, size_t count) {
+  if (GetTablespaceId(page_id) == DEFAULT_TABLESPACE) {
+    for (size_t i = 0; i < count; i++) {
+      FreePageSlot(page_id + static_cast<page_id_t>(i));
+    }
+  }
+  DiskManager::DeallocateExtent(page_id, count);
+}
+
+auto CompressedDiskManager::GetNumSlotBytes() -> size_t {
+  std::scoped_lock scoped_slot_latch(slot_latch_);
+  size_t bytes = 0;
+  for (const auto &slot : slots_) {
+    bytes += static_cast<size_t>(slot.units_) * SLOT_UNIT;
+  }
+  return bytes;
+}
+
+auto CompressedDiskManager::NewTablespace(const std::string &file_name) -> std::unique_ptr<DiskManager> {
+  auto disk_manager = std::unique_ptr<CompressedDiskManager>(new CompressedDiskManager());
+  disk_manager->OpenSlotFile(file_name);
+  return disk_manager;
+}
+
+/**
+ * Open the database file, stamping the header block into a new file and checking it in an existing one
+ */
+void CompressedDiskManager::OpenSlotFile(const std::string &db_file) {
+  file_name_ = db_file;
+  free_slots_.resize(MAX_SLOT_UNITS + 1);
+  slot_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
+  if (slot_fd_ < 0) {
+    throw Exception("can't open db file");
+  }
+  char header_block[SLOT_UNIT];
+  ssize_t read_count = PreadFull(slot_fd_, header_block, SLOT_UNIT, 0);
+  CompressedFileHeader header;
+  bool valid;
+  if (read_count == 0) {
+    memset(header_block, 0, SLOT_UNIT);
+    header = {COMPRESSED_FILE_MAGIC, COMPRESSED_FILE_VERSION, BUSTUB_PAGE_SIZE, SLOT_UNIT};
+    memcpy(header_block, &header, sizeof(header));
+    valid = PwriteFull(slot_fd_, header_block, SLOT_UNIT, 0);
+  } else {
+    memcpy(&header, header_block, sizeof(header));
+    valid = read_count >= static_cast<ssize_t>(sizeof(header)) && header.magic_ == COMPRESSED_FILE_MAGIC &&
+            header.version_ == COMPRESSED_FILE_VERSION && header.page_size_ == BUSTUB_PAGE_SIZE &&
+            header.slot_unit_ == SLOT_UNIT;
+  }
+  if (!valid) {
+    close(slot_fd_);
+    slot_fd_ = -1;
+    throw Exception("not a compressed database file of this format version and page size: " + db_file);
+  }
+  LoadSlots();
+}
+
+/**
+ * Walk the slots from the header block to the end of the file. The newest copy of a page wins, older copies left
+ * behind by a crash while the page moved are freed. A slot cut short by a crash at the end of the file is dropped.
+ * Page ids without a slot become free pages.
+ */
+void CompressedDiskManager::LoadSlots() {
+  int64_t file_size = GetFileSize(file_name_);
+  std::vector<uint64_t> write_counters;
+  std::vector<Slot> stale_slots;
+  size_t offset = SLOT_UNIT;
+  while (offset + sizeof(SlotHeader) <= static_cast<size_t>(std::max<int64_t>(file_size, 0))) {
+    SlotHeader header;
+    if (PreadFull(slot_fd_, reinterpret_cast<char *>(&header), sizeof(header), offset) !=
+            static_cast<ssize_t>(sizeof(header)) ||
+        header.units_ == 0 || header.units_ > MAX_SLOT_UNITS) {
+      break;
+    }
+    if (header.page_id_ == INVALID_PAGE_ID) {
+      free_slots_[header.units_].push_back(offset);
+      offset += static_cast<size_t>(header.units_) * SLOT_UNIT;
+      continue;
+    }
+    if (header.page_id_ < 0 || header.page_id_ >= MAX_TABLESPACE_PAGES || header.size_ == 0 ||
+        header.size_ > BUSTUB_PAGE_SIZE || UnitsFor(header.size_) > header.units_ ||
+        offset + sizeof(header) + header.size_ > static_cast<size_t>(file_size)) {
+      break;
+    }
+    if (slots_.size() <= static_cast<size_t>(header.page_id_)) {
+      slots_.resize(header.page_id_ + 1);
+      write_counters.resize(header.page_id_ + 1, 0);
+    }
+    Slot slot{offset, header.units_, header.size_};
+    if (slots_[header.page_id_].units_ == 0 || write_counters[header.page_id_] < header.write_counter_) {
+      if (slots_[header.page_id_].units_ != 0) {
+        stale_slots.push_back(slots_[header.page_id_]);
+      }
+      slots_[header.page_id_] = slot;
+      write_counters[header.page_id_] = header.write_counter_;
+    } else {
+      stale_slots.push_back(slot);
+    }
+    next_write_counter_ = std::max(next_write_counter_, header.write_counter_ + 1);
+    offset += static_cast<size_t>(header.units_) * SLOT_UNIT;
+  }
+  end_offset_ = offset;
+  for (const auto &slot : stale_slots) {
+    FreeSlot(slot.offset_, slot.units_);
+  }
+
+  std::scoped_lock scoped_free_map_latch(free_map_latch_);
+  next_page_id_ = static_cast<page_id_t>(slots_.size());
+  first_free_page_id_ = next_page_id_;
+  num_free_pages_ = 0;
+  for (page_id_t page_id = 0; page_id < next_page_id_; page_id++) {
+    if (slots_[page_id].units_ == 0) {
+      SetFree(page_id, true);
+      num_free_pages_++;
+      first_free_page_id_ = std::min(first_free_page_id_, page_id);
+    }
+  }
+}
+
+/**
+ * Private helper function to find room for a slot: a free slot of exactly that size, so that slots never have to be
+ * split or merged, or else the end of the file. Requires slot_latch_.
+ */
+auto CompressedDiskManager::TakeFreeSlot(uint32_t units) -> size_t {
+  auto &free_slots = free_slots_[units];
+  if (!free_slots.empty()) {
+    size_t offset = free_slots.back();
+    free_slots.pop_back();
+    return offset;
+  }
+  size_t offset = end_offset_;
+  end_offset_ += static_cast<size_t>(units) * SLOT_UNIT;
+  return offset;
+}
+
+/**
+ * Private helper function to free a slot. Its header is overwritten first, so that the page it held does not come
+ * back after a restart, and only then is it handed out again.
+ */
+void CompressedDiskManager::FreeSlot(size_t offset, uint32_t units) {
+  SlotHeader header{0, INVALID_PAGE_ID, units, 0, 0};
+  if (!PwriteFull(slot_fd_, reinterpret_cast<const char *>(&header), sizeof(header), offset)) {
+    LOG_DEBUG("I/O error while freeing a slot");
+  }
+  std::scoped_lock scoped_slot_latch(slot_latch_);
+  free_slots_[units].push_back(offset);
+}
+
+void CompressedDiskManager::FreePageSlot(page_id_t page_id) {
+  Slot slot;
+  {
+    std::scoped_lock scoped_slot_latch(slot_latch_);
+    if (page_id < 0 || static_cast<size_t>(page_id) >= slots_.size()) {
+      return;
+    }
+    slot = slots_[page_id];
+    slots_[page_id] = Slot{};
+  }
+  if (slot.units_ != 0) {
+    FreeSlot(slot.offset_, slot.units_);
+  }
+}
+
+}  // namespace bustub
@@ -10,9 +10,16 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <cstdio>
 #include <cstring>
+#include <fstream>
 #include <iostream>
 #include <mutex>  // NOLINT
 #include <string>
@@ -26,100 +33,558 @@ namespace bustub {
 
 static char *buffer_used;
 
+/** Magic number at the start of a warm-start manifest ("BTWM"), followed by the number of page ids and the ids. */
+static constexpr uint32_t WARM_MANIFEST_MAGIC = 0x4d575442;
+
+/** Magic number at the start of a database file ("BTDB"). */
+static constexpr uint32_t DB_FILE_MAGIC = 0x42445442;
+/** Version of the database file format, bumped whenever the layout of the file changes. */
+static constexpr uint32_t DB_FILE_VERSION = 1;
+
+/** The start of the header page of a database file. The rest of the page is zero. */
+struct DbFileHeader {
+  uint32_t magic_;
+  uint32_t version_;
+  uint32_t page_size_;
+  uint32_t pages_per_free_map_;
+};
+
+static_assert(BUSTUB_PAGE_SIZE % DIRECT_IO_ALIGNMENT == 0, "pages must be whole O_DIRECT blocks");
+static_assert(sizeof(DbFileHeader) <= BUSTUB_PAGE_SIZE, "the file header must fit in the header page");
+static_assert(DiskManager::MAX_TABLESPACE_PAGES % DiskManager::PAGES_PER_FREE_MAP == 0,
+              "a tablespace must hold whole free-map groups, so that write runs never cross into another tablespace");
+static_assert(static_cast<int64_t>(MAX_TABLESPACES) << TABLESPACE_PAGE_BITS <= (static_cast<int64_t>(1) << 31),
+              "tablespace and page number must fit in a page id");
+
+/** @return true if `data` can be handed to an O_DIRECT read or write as is */
+static auto IsAligned(const void *data) -> bool { return reinterpret_cast<uintptr_t>(data) % DIRECT_IO_ALIGNMENT == 0; }
+
+/**
+ * Loop over pread() until the buffer is full or the file ends
+ */
+auto DiskManager::PreadFull(int fd, char *data, size_t size, size_t offset) -> ssize_t {
+  size_t done = 0;
+  while (done < size) {
+    ssize_t ret = pread(fd, data + done, size - done, offset + done);
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret < 0) {
+      return -1;
+    }
+    if (ret == 0) {
+      break;
+    }
+    done += ret;
+  }
+  return static_cast<ssize_t>(done);
+}
+
+/**
+ * Loop over pwrite() until the whole buffer is written
+ */
+auto DiskManager::PwriteFull(int fd, const char *data, size_t size, size_t offset) -> bool {
+  size_t done = 0;
+  while (done < size) {
+    ssize_t ret = pwrite(fd, data + done, size - done, offset + done);
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret <= 0) {
+      return false;
+    }
+    done += ret;
+  }
+  return true;
+}
+
 /**
  * Constructor: open/create a single database file & log file
  * @input db_file: database file name
  */
-DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
-  std::string::size_type n = file_name_.rfind('.');
+DiskManager::DiskManager(const std::string &db_file, bool direct_io) : file_name_(db_file), direct_io_(direct_io) {
+  if (!OpenLogFile(db_file)) {
+    return;
+  }
+  try {
+    OpenDbFile(db_file);
+  } catch (...) {
+    close(log_fd_);
+    log_fd_ = -1;
+    throw;
+  }
+  buffer_used = nullptr;
+}
+
+/**
+ * Open the log file, and name the warm-start manifest, after the database file
+ */
+auto DiskManager::OpenLogFile(const std::string &db_file) -> bool {
+  std::string::size_type n = db_file.rfind('.');
   if (n == std::string::npos) {
     LOG_DEBUG("wrong file format");
-    return;
+    return false;
   }
-  log_name_ = file_name_.substr(0, n) + ".log";
+  log_name_ = db_file.substr(0, n) + ".log";
+  warm_manifest_name_ = db_file.substr(0, n) + ".warm";
 
-  log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::app | std::ios::out);
-  // directory or file does not exist
-  if (!log_io_.is_open()) {
-    log_io_.clear();
-    // create a new file
-    log_io_.open(log_name_, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
-    if (!log_io_.is_open()) {
-      throw Exception("can't open dblog file");
-    }
+  // the log is only ever appended to, O_APPEND keeps concurrent writers from overwriting each other
+  log_fd_ = open(log_name_.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+  if (log_fd_ < 0) {
+    throw Exception("can't open dblog file");
   }
+  return true;
+}
 
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
-    if (!db_io_.is_open()) {
-      throw Exception("can't open db file");
+/**
+ * Open the database file, with O_DIRECT in direct I/O mode if the file system supports it
+ */
+void DiskManager::OpenDbFile(const std::string &db_file) {
+  file_name_ = db_file;
+  if (direct_io_) {
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT | O_DIRECT, 0644);
+    // some file systems, e.g. tmpfs, do not support O_DIRECT
+    if (db_fd_ < 0 && errno == EINVAL) {
+      LOG_WARN("O_DIRECT is not supported for %s, using buffered I/O", db_file.c_str());
+      direct_io_ = false;
     }
   }
-  buffer_used = nullptr;
+  if (!direct_io_) {
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
+  }
+  if (db_fd_ < 0) {
+    throw Exception("can't open db file");
+  }
+  if (!CheckFileHeader()) {
+    close(db_fd_);
+    db_fd_ = -1;
+    throw Exception("not a database file of this format version and page size: " + db_file);
+  }
+  LoadFreeMap();
+}
+
+DiskManager::~DiskManager() {
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+  }
+  if (log_fd_ >= 0) {
+    close(log_fd_);
+  }
 }
 
 /**
- * Close all file streams
+ * Close all file descriptors
  */
 void DiskManager::ShutDown() {
   {
-    std::scoped_lock scoped_db_io_latch(db_io_latch_);
-    db_io_.close();
+    std::shared_lock lock(tablespace_latch_);
+    for (auto &tablespace : tablespaces_) {
+      if (tablespace != nullptr) {
+        tablespace->ShutDown();
+      }
+    }
+  }
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+    db_fd_ = -1;
+  }
+  if (log_fd_ >= 0) {
+    close(log_fd_);
+    log_fd_ = -1;
   }
-  log_io_.close();
 }
 
 /**
  * Write the contents of the specified page into disk file
  */
-void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  size_t offset = static_cast<size_t>(page_id) * BUSTUB_PAGE_SIZE;
-  // set write cursor to offset
+auto DiskManager::WritePage(page_id_t page_id, const char *page_data) -> bool {
+  if (GetTablespaceId(page_id) != DEFAULT_TABLESPACE) {
+    auto tablespace = GetTablespace(GetTablespaceId(page_id));
+    if (tablespace == nullptr) {
+      LOG_DEBUG("write to page %d of a tablespace that does not exist", page_id);
+      return false;
+    }
+    return tablespace->WritePage(GetLocalPageId(page_id), page_data);
+  }
+  size_t offset = GetPageOffset(page_id);
   num_writes_ += 1;
-  db_io_.seekp(offset);
-  db_io_.write(page_data, BUSTUB_PAGE_SIZE);
-  // check for I/O error
-  if (db_io_.bad()) {
+  alignas(DIRECT_IO_ALIGNMENT) char bounce[BUSTUB_PAGE_SIZE];
+  if (direct_io_ && !IsAligned(page_data)) {
+    memcpy(bounce, page_data, BUSTUB_PAGE_SIZE);
+    page_data = bounce;
+  }
+  if (!PwriteFull(db_fd_, page_data, BUSTUB_PAGE_SIZE, offset)) {
     LOG_DEBUG("I/O error while writing");
-    return;
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Write runs of consecutive pages with one pwritev() each. A run ends at a bitmap page of the free-page map, after
+ * WRITE_RUN_MAX_PAGES pages, or, in direct I/O mode, at a buffer that is not aligned.
+ */
+auto DiskManager::WritePages(page_id_t page_id, const std::vector<const char *> &pages_data) -> bool {
+  bool success = true;
+  if (db_fd_ < 0) {
+    for (size_t i = 0; i < pages_data.size(); i++) {
+      success = WritePage(page_id + static_cast<page_id_t>(i), pages_data[i]) && success;
+    }
+    return success;
+  }
+  if (GetTablespaceId(page_id) != DEFAULT_TABLESPACE) {
+    auto tablespace = GetTablespace(GetTablespaceId(page_id));
+    if (tablespace == nullptr) {
+      LOG_DEBUG("write to page %d of a tablespace that does not exist", page_id);
+      return false;
+    }
+    return tablespace->WritePages(GetLocalPageId(page_id), pages_data);
+  }
+  std::vector<iovec> iovecs;
+  size_t i = 0;
+  while (i < pages_data.size()) {
+    auto run_page_id = page_id + static_cast<page_id_t>(i);
+    size_t run = GetAdjacentRun(run_page_id, std::min(pages_data.size() - i, WRITE_RUN_MAX_PAGES));
+    iovecs.clear();
+    for (size_t j = i; j < i + run && (!direct_io_ || IsAligned(pages_data[j])); j++) {
+      iovecs.push_back({const_cast<char *>(pages_data[j]), BUSTUB_PAGE_SIZE});  // NOLINT
+    }
+    if (iovecs.size() <= 1) {
+      success = WritePage(run_page_id, pages_data[i]) && success;
+      i++;
+      continue;
+    }
+    run = iovecs.size();
+    num_writes_ += run;
+    num_writes_saved_ += run - 1;
+    size_t offset = GetPageOffset(run_page_id);
+    size_t done = 0;
+    ssize_t ret = pwritev(db_fd_, iovecs.data(), static_cast<int>(iovecs.size()), offset);
+    if (ret > 0) {
+      done = ret;
+    }
+    // Finish a short write page by page, where the vectored write stopped.
+    while (done < run * BUSTUB_PAGE_SIZE) {
+      size_t page = done / BUSTUB_PAGE_SIZE;
+      size_t in_page = done % BUSTUB_PAGE_SIZE;
+      if (!PwriteFull(db_fd_, pages_data[i + page] + in_page, BUSTUB_PAGE_SIZE - in_page, offset + done)) {
+        LOG_DEBUG("I/O error while writing");
+        success = false;
+        break;
+      }
+      done += BUSTUB_PAGE_SIZE - in_page;
+    }
+    i += run;
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
+  return success;
 }
 
 /**
  * Read the contents of the specified page into the given memory area
  */
-void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  int offset = page_id * BUSTUB_PAGE_SIZE;
-  // check if read beyond file length
-  if (offset > GetFileSize(file_name_)) {
-    LOG_DEBUG("I/O error reading past end of file");
-    // std::cerr << "I/O error while reading" << std::endl;
-  } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, BUSTUB_PAGE_SIZE);
-    if (db_io_.bad()) {
-      LOG_DEBUG("I/O error while reading");
-      return;
+auto DiskManager::ReadPage(page_id_t page_id, char *page_data) -> bool {
+  if (GetTablespaceId(page_id) != DEFAULT_TABLESPACE) {
+    auto tablespace = GetTablespace(GetTablespaceId(page_id));
+    if (tablespace == nullptr) {
+      LOG_DEBUG("read of page %d of a tablespace that does not exist", page_id);
+      memset(page_data, 0, BUSTUB_PAGE_SIZE);
+      return false;
     }
-    // if file ends before reading BUSTUB_PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < BUSTUB_PAGE_SIZE) {
-      LOG_DEBUG("Read less than a page");
-      db_io_.clear();
-      // std::cerr << "Read less than a page" << std::endl;
-      memset(page_data + read_count, 0, BUSTUB_PAGE_SIZE - read_count);
+    return tablespace->ReadPage(GetLocalPageId(page_id), page_data);
+  }
+  size_t offset = GetPageOffset(page_id);
+  alignas(DIRECT_IO_ALIGNMENT) char bounce[BUSTUB_PAGE_SIZE];
+  bool use_bounce = direct_io_ && !IsAligned(page_data);
+  ssize_t read_count = PreadFull(db_fd_, use_bounce ? bounce : page_data, BUSTUB_PAGE_SIZE, offset);
+  bool success = read_count >= 0;
+  if (!success) {
+    LOG_DEBUG("I/O error while reading");
+    read_count = 0;
+  }
+  if (use_bounce) {
+    memcpy(page_data, bounce, read_count);
+  }
+  // if file ends before reading BUSTUB_PAGE_SIZE
+  if (read_count < BUSTUB_PAGE_SIZE) {
+    LOG_DEBUG("Read less than a page");
+    memset(page_data + read_count, 0, BUSTUB_PAGE_SIZE - read_count);
+  }
+  return success;
+}
+
+/**
+ * Hand out the lowest free page, or grow the database by one page
+ */
+auto DiskManager::AllocatePage(tablespace_id_t tablespace) -> page_id_t {
+  if (tablespace != DEFAULT_TABLESPACE) {
+    auto disk_manager = GetTablespace(tablespace);
+    if (disk_manager == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "no tablespace " + std::to_string(tablespace));
     }
+    return MakePageId(tablespace, disk_manager->AllocatePage());
   }
+  std::scoped_lock scoped_free_map_latch(free_map_latch_);
+  if (num_free_pages_ == 0) {
+    if (next_page_id_ >= MAX_TABLESPACE_PAGES) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "the database file is full: " + file_name_);
+    }
+    return next_page_id_++;
+  }
+  page_id_t page_id = first_free_page_id_;
+  while (!IsFree(page_id)) {
+    // skip whole bytes of allocated pages
+    page_id = free_map_[page_id / 8] == 0 ? (page_id / 8 + 1) * 8 : page_id + 1;
+  }
+  SetFree(page_id, false);
+  num_free_pages_--;
+  first_free_page_id_ = page_id + 1;
+  // the page must not look free after a restart, or it would be handed out twice
+  WriteFreeMap(page_id);
+  return page_id;
+}
+
+/**
+ * Hand out the lowest run of `count` free pages within one free-map group, or grow the database by `count` pages
+ */
+auto DiskManager::AllocateExtent(size_t count, tablespace_id_t tablespace) -> page_id_t {
+  if (tablespace != DEFAULT_TABLESPACE) {
+    auto disk_manager = GetTablespace(tablespace);
+    if (disk_manager == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "no tablespace " + std::to_string(tablespace));
+    }
+    return MakePageId(tablespace, disk_manager->AllocateExtent(count));
+  }
+  std::scoped_lock scoped_free_map_latch(free_map_latch_);
+  auto size = static_cast<page_id_t>(count);
+  if (num_free_pages_ >= count) {
+    page_id_t run_start = INVALID_PAGE_ID;
+    for (page_id_t page_id = first_free_page_id_; page_id < next_page_id_; page_id++) {
+      if (!IsFree(page_id)) {
+        run_start = INVALID_PAGE_ID;
+        // skip whole bytes of allocated pages
+        if (page_id % 8 == 0 && static_cast<size_t>(page_id / 8) < free_map_.size() && free_map_[page_id / 8] == 0) {
+          page_id += 7;
+        }
+        continue;
+      }
+      // a run ends at a bitmap page, the pages after it are not adjacent in the file
+      if (run_start == INVALID_PAGE_ID || page_id % PAGES_PER_FREE_MAP == 0) {
+        run_start = page_id;
+      }
+      if (page_id - run_start + 1 < size) {
+        continue;
+      }
+      for (page_id_t extent_page_id = run_start; extent_page_id <= page_id; extent_page_id++) {
+        SetFree(extent_page_id, false);
+      }
+      num_free_pages_ -= count;
+      if (first_free_page_id_ == run_start) {
+        first_free_page_id_ = page_id + 1;
+      }
+      WriteFreeMap(run_start);
+      return run_start;
+    }
+  }
+  if (next_page_id_ + size > MAX_TABLESPACE_PAGES) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "the database file is full: " + file_name_);
+  }
+  page_id_t page_id = next_page_id_;
+  next_page_id_ += size;
+  return page_id;
+}
+
+/**
+ * Mark a page free in the free-page map
+ */
+void DiskManager::DeallocatePage(page_id_t page_id) {
+  if (GetTablespaceId(page_id) != DEFAULT_TABLESPACE) {
+    auto tablespace = GetTablespace(GetTablespaceId(page_id));
+    if (tablespace != nullptr) {
+      tablespace->DeallocatePage(GetLocalPageId(page_id));
+    }
+    return;
+  }
+  std::scoped_lock scoped_free_map_latch(free_map_latch_);
+  if (page_id < 0 || page_id >= next_page_id_ || IsFree(page_id)) {
+    return;
+  }
+  SetFree(page_id, true);
+  num_free_pages_++;
+  first_free_page_id_ = std::min(first_free_page_id_, page_id);
+  WriteFreeMap(page_id);
+}
+
+/**
+ * Mark a run of pages free, writing every bitmap page it touches once
+ */
+void DiskManager::DeallocateExtent(page_id_t page_id, size_t count) {
+  if (GetTablespaceId(page_id) != DEFAULT_TABLESPACE) {
+    auto tablespace = GetTablespace(GetTablespaceId(page_id));
+    if (tablespace != nullptr) {
+      tablespace->DeallocateExtent(GetLocalPageId(page_id), count);
+    }
+    return;
+  }
+  std::scoped_lock scoped_free_map_latch(free_map_latch_);
+  page_id_t end_page_id = std::min<page_id_t>(page_id + static_cast<page_id_t>(count), next_page_id_);
+  page_id = std::max(page_id, 0);
+  for (page_id_t group_start = page_id; group_start < end_page_id;) {
+    page_id_t group_end = std::min<page_id_t>(end_page_id, (group_start / PAGES_PER_FREE_MAP + 1) * PAGES_PER_FREE_MAP);
+    for (page_id_t free_page_id = group_start; free_page_id < group_end; free_page_id++) {
+      if (!IsFree(free_page_id)) {
+        SetFree(free_page_id, true);
+        num_free_pages_++;
+      }
+    }
+    first_free_page_id_ = std::min(first_free_page_id_, group_start);
+    WriteFreeMap(group_start);
+    group_start = group_end;
+  }
+}
+
+auto DiskManager::GetNextPageId(tablespace_id_t tablespace) const -> page_id_t {
+  if (tablespace == DEFAULT_TABLESPACE) {
+    return next_page_id_;
+  }
+  auto disk_manager = GetTablespace(tablespace);
+  return MakePageId(tablespace, disk_manager == nullptr ? 0 : disk_manager->GetNextPageId());
+}
+
+/**
+ * Open the file of a tablespace and give it the lowest unused tablespace id
+ */
+auto DiskManager::CreateTablespace(const std::string &file_name) -> tablespace_id_t {
+  std::shared_ptr<DiskManager> disk_manager = NewTablespace(file_name);
+  std::unique_lock lock(tablespace_latch_);
+  for (tablespace_id_t tablespace = DEFAULT_TABLESPACE + 1; tablespace < MAX_TABLESPACES; tablespace++) {
+    if (tablespaces_[tablespace] == nullptr) {
+      tablespaces_[tablespace] = std::move(disk_manager);
+      return tablespace;
+    }
+  }
+  throw Exception(ExceptionType::OUT_OF_RANGE, "too many tablespaces");
+}
+
+/**
+ * Forget a tablespace and unlink its file. No page is read or written, so this takes the same time for any size; the
+ * descriptor is closed once the last I/O still holding the tablespace's disk manager is done.
+ */
+auto DiskManager::DropTablespace(tablespace_id_t tablespace) -> bool {
+  std::shared_ptr<DiskManager> disk_manager;
+  {
+    std::unique_lock lock(tablespace_latch_);
+    if (tablespace <= DEFAULT_TABLESPACE || tablespace >= MAX_TABLESPACES) {
+      return false;
+    }
+    disk_manager = std::move(tablespaces_[tablespace]);
+  }
+  if (disk_manager == nullptr) {
+    return false;
+  }
+  if (!disk_manager->file_name_.empty() && unlink(disk_manager->file_name_.c_str()) != 0) {
+    LOG_DEBUG("cannot delete the file of tablespace %d", tablespace);
+  }
+  return true;
+}
+
+auto DiskManager::NewTablespace(const std::string &file_name) -> std::unique_ptr<DiskManager> {
+  auto disk_manager = std::make_unique<DiskManager>();
+  disk_manager->direct_io_ = direct_io_;
+  disk_manager->OpenDbFile(file_name);
+  return disk_manager;
+}
+
+auto DiskManager::GetTablespace(tablespace_id_t tablespace) const -> std::shared_ptr<DiskManager> {
+  if (tablespace <= DEFAULT_TABLESPACE || tablespace >= MAX_TABLESPACES) {
+    return nullptr;
+  }
+  std::shared_lock lock(tablespace_latch_);
+  return tablespaces_[tablespace];
+}
+
+auto DiskManager::GetNumFreePages() -> size_t {
+  std::scoped_lock scoped_free_map_latch(free_map_latch_);
+  return num_free_pages_;
+}
+
+/**
+ * Drop the trailing free pages and truncate the database file after the last allocated page
+ */
+auto DiskManager::Compact() -> size_t {
+  std::scoped_lock scoped_free_map_latch(free_map_latch_);
+  page_id_t old_next_page_id = next_page_id_;
+  page_id_t next_page_id = old_next_page_id;
+  while (next_page_id > 0 && IsFree(next_page_id - 1)) {
+    next_page_id--;
+    SetFree(next_page_id, false);
+    num_free_pages_--;
+  }
+  if (next_page_id == old_next_page_id) {
+    return 0;
+  }
+  next_page_id_ = next_page_id;
+  first_free_page_id_ = std::min(first_free_page_id_, next_page_id);
+  free_map_.resize((next_page_id + PAGES_PER_FREE_MAP - 1) / PAGES_PER_FREE_MAP * BUSTUB_PAGE_SIZE);
+  if (db_fd_ >= 0) {
+    if (next_page_id > 0) {
+      WriteFreeMap(next_page_id - 1);
+    }
+    size_t size = next_page_id == 0 ? BUSTUB_PAGE_SIZE : GetPageOffset(next_page_id - 1) + BUSTUB_PAGE_SIZE;
+    int64_t file_size = GetFileSize(file_name_);
+    if (file_size > 0 && static_cast<size_t>(file_size) > size && ftruncate(db_fd_, size) != 0) {
+      LOG_DEBUG("I/O error while truncating");
+    }
+  }
+  return old_next_page_id - next_page_id;
+}
+
+/**
+ * Write the manifest to a temporary file and rename it over the old one, so that a crash never leaves half a manifest
+ */
+void DiskManager::WriteWarmManifest(const std::vector<page_id_t> &page_ids) {
+  std::scoped_lock scoped_warm_manifest_latch(warm_manifest_latch_);
+  if (warm_manifest_name_.empty()) {
+    warm_manifest_ = page_ids;
+    return;
+  }
+  std::string tmp_name = warm_manifest_name_ + ".tmp";
+  {
+    std::ofstream out(tmp_name, std::ios::binary | std::ios::trunc);
+    auto count = static_cast<uint32_t>(page_ids.size());
+    out.write(reinterpret_cast<const char *>(&WARM_MANIFEST_MAGIC), sizeof(WARM_MANIFEST_MAGIC));
+    out.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    out.write(reinterpret_cast<const char *>(page_ids.data()), page_ids.size() * sizeof(page_id_t));
+    out.flush();
+    if (!out.good()) {
+      LOG_DEBUG("I/O error while writing the warm-start manifest");
+      return;
+    }
+  }
+  if (std::rename(tmp_name.c_str(), warm_manifest_name_.c_str()) != 0) {
+    LOG_DEBUG("cannot replace the warm-start manifest");
+  }
+}
+
+auto DiskManager::ReadWarmManifest() -> std::vector<page_id_t> {
+  std::scoped_lock scoped_warm_manifest_latch(warm_manifest_latch_);
+  if (warm_manifest_name_.empty()) {
+    return warm_manifest_;
+  }
+  std::ifstream in(warm_manifest_name_, std::ios::binary);
+  uint32_t magic = 0;
+  uint32_t count = 0;
+  in.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+  in.read(reinterpret_cast<char *>(&count), sizeof(count));
+  if (!in.good() || magic != WARM_MANIFEST_MAGIC ||
+      static_cast<int64_t>(count * sizeof(page_id_t) + 2 * sizeof(uint32_t)) != GetFileSize(warm_manifest_name_)) {
+    return {};
+  }
+  std::vector<page_id_t> page_ids(count);
+  in.read(reinterpret_cast<char *>(page_ids.data()), count * sizeof(page_id_t));
+  if (!in.good()) {
+    return {};
+  }
+  return page_ids;
 }
 
 /**
@@ -143,16 +608,20 @@ void DiskManager::WriteLog(char *log_data, int size) {
   }
 
   num_flushes_ += 1;
-  // sequence write
-  log_io_.write(log_data, size);
-
-  // check for I/O error
-  if (log_io_.bad()) {
-    LOG_DEBUG("I/O error while writing log");
-    return;
+  // sequence write: the log file is opened with O_APPEND, so every write lands at its end
+  size_t done = 0;
+  while (done < static_cast<size_t>(size)) {
+    ssize_t ret = write(log_fd_, log_data + done, size - done);
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    // check for I/O error
+    if (ret <= 0) {
+      LOG_DEBUG("I/O error while writing log");
+      return;
+    }
+    done += ret;
   }
-  // needs to flush to keep disk file in sync
-  log_io_.flush();
   flush_log_ = false;
 }
 
@@ -167,17 +636,13 @@ auto DiskManager::ReadLog(char *log_data, int size, int offset) -> bool {
     // LOG_DEBUG("file size is %d", GetFileSize(log_name_));
     return false;
   }
-  log_io_.seekp(offset);
-  log_io_.read(log_data, size);
-
-  if (log_io_.bad()) {
+  ssize_t read_count = PreadFull(log_fd_, log_data, size, offset);
+  if (read_count < 0) {
     LOG_DEBUG("I/O error while reading log");
     return false;
   }
   // if log file ends before reading "size"
-  int read_count = log_io_.gcount();
   if (read_count < size) {
-    log_io_.clear();
     memset(log_data + read_count, 0, size - read_count);
   }
 
@@ -199,13 +664,121 @@ auto DiskManager::GetNumWrites() const -> int { return num_writes_; }
  */
 auto DiskManager::GetFlushState() const -> bool { return flush_log_; }
 
+/**
+ * Private helper function to map a page id to its file offset. Group g of data pages starts after g + 1 bitmap pages.
+ */
+auto DiskManager::GetPageOffset(page_id_t page_id) -> size_t {
+  // the header page, then the bitmap pages of this and the previous groups
+  size_t slot = static_cast<size_t>(page_id) + page_id / PAGES_PER_FREE_MAP + 2;
+  return slot * BUSTUB_PAGE_SIZE;
+}
+
+auto DiskManager::GetFreeMapOffset(page_id_t page_id) -> size_t {
+  return (1 + static_cast<size_t>(page_id / PAGES_PER_FREE_MAP) * (PAGES_PER_FREE_MAP + 1)) * BUSTUB_PAGE_SIZE;
+}
+
+/**
+ * Private helper function to stamp a new database file with the header page, or to check the header of an existing
+ * one. Files written before the header existed start with a data or bitmap page and are refused.
+ */
+auto DiskManager::CheckFileHeader() -> bool {
+  alignas(DIRECT_IO_ALIGNMENT) char header_page[BUSTUB_PAGE_SIZE];
+  ssize_t read_count = PreadFull(db_fd_, header_page, BUSTUB_PAGE_SIZE, 0);
+  if (read_count == 0) {
+    memset(header_page, 0, BUSTUB_PAGE_SIZE);
+    DbFileHeader header{DB_FILE_MAGIC, DB_FILE_VERSION, BUSTUB_PAGE_SIZE, PAGES_PER_FREE_MAP};
+    memcpy(header_page, &header, sizeof(header));
+    return PwriteFull(db_fd_, header_page, BUSTUB_PAGE_SIZE, 0);
+  }
+  if (read_count < static_cast<ssize_t>(sizeof(DbFileHeader))) {
+    return false;
+  }
+  DbFileHeader header;
+  memcpy(&header, header_page, sizeof(header));
+  if (header.magic_ != DB_FILE_MAGIC) {
+    LOG_WARN("%s is not a database file, or was written before the file format was versioned", file_name_.c_str());
+    return false;
+  }
+  if (header.version_ != DB_FILE_VERSION || header.page_size_ != BUSTUB_PAGE_SIZE ||
+      header.pages_per_free_map_ != static_cast<uint32_t>(PAGES_PER_FREE_MAP)) {
+    LOG_WARN("%s has format version %u and %u byte pages, expected version %u and %d byte pages", file_name_.c_str(),
+             header.version_, header.page_size_, DB_FILE_VERSION, BUSTUB_PAGE_SIZE);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Private helper function to read the free-page map when the database file is opened. The file size tells how many
+ * pages have been allocated; a page that was freed before it was ever written lies past the end and is dropped.
+ */
+void DiskManager::LoadFreeMap() {
+  int64_t file_size = GetFileSize(file_name_) - BUSTUB_PAGE_SIZE;
+  // the slots after the header page
+  size_t num_slots = file_size <= 0 ? 0 : (static_cast<size_t>(file_size) + BUSTUB_PAGE_SIZE - 1) / BUSTUB_PAGE_SIZE;
+  size_t slots_per_group = PAGES_PER_FREE_MAP + 1;
+  size_t num_groups = (num_slots + slots_per_group - 1) / slots_per_group;
+  free_map_.assign(num_groups * BUSTUB_PAGE_SIZE, 0);
+  // the map is read through an aligned buffer, so that this works with O_DIRECT
+  alignas(DIRECT_IO_ALIGNMENT) char bitmap[BUSTUB_PAGE_SIZE];
+  for (size_t group = 0; group < num_groups; group++) {
+    ssize_t read_count =
+        PreadFull(db_fd_, bitmap, BUSTUB_PAGE_SIZE, GetFreeMapOffset(group * PAGES_PER_FREE_MAP));
+    if (read_count > 0) {
+      memcpy(&free_map_[group * BUSTUB_PAGE_SIZE], bitmap, read_count);
+    }
+  }
+  next_page_id_ = static_cast<page_id_t>(num_slots - num_groups);
+  first_free_page_id_ = next_page_id_;
+  num_free_pages_ = 0;
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(num_groups * PAGES_PER_FREE_MAP); page_id++) {
+    if (!IsFree(page_id)) {
+      continue;
+    }
+    if (page_id >= next_page_id_) {
+      SetFree(page_id, false);
+      continue;
+    }
+    first_free_page_id_ = std::min(first_free_page_id_, page_id);
+    num_free_pages_++;
+  }
+}
+
+/**
+ * Private helper function to persist the bitmap page covering a page. Memory-backed disk managers have no file and
+ * keep the map in memory only.
+ */
+void DiskManager::WriteFreeMap(page_id_t page_id) {
+  if (db_fd_ < 0) {
+    return;
+  }
+  size_t group = page_id / PAGES_PER_FREE_MAP;
+  alignas(DIRECT_IO_ALIGNMENT) char bitmap[BUSTUB_PAGE_SIZE];
+  memcpy(bitmap, &free_map_[group * BUSTUB_PAGE_SIZE], BUSTUB_PAGE_SIZE);
+  if (!PwriteFull(db_fd_, bitmap, BUSTUB_PAGE_SIZE, GetFreeMapOffset(page_id))) {
+    LOG_DEBUG("I/O error while writing the free-page map");
+  }
+}
+
+void DiskManager::SetFree(page_id_t page_id, bool free) {
+  size_t size = (page_id / PAGES_PER_FREE_MAP + 1) * BUSTUB_PAGE_SIZE;
+  if (free_map_.size() < size) {
+    free_map_.resize(size, 0);
+  }
+  if (free) {
+    free_map_[page_id / 8] |= 1 << (page_id % 8);
+  } else {
+    free_map_[page_id / 8] &= ~(1 << (page_id % 8));
+  }
+}
+
 /**
  * Private helper function to get disk file size
  */
-auto DiskManager::GetFileSize(const std::string &file_name) -> int {
+auto DiskManager::GetFileSize(const std::string &file_name) -> int64_t {
   struct stat stat_buf;
   int rc = stat(file_name.c_str(), &stat_buf);
-  return rc == 0 ? static_cast<int>(stat_buf.st_size) : -1;
+  return rc == 0 ? static_cast<int64_t>(stat_buf.st_size) : -1;
 }
 
 }  // namespace bustub
@@ -32,19 +32,31 @@ DiskManagerMemory::DiskManagerMemory(size_t pages) { memory_ = new char[pages *
 /**
  * Write the contents of the specified page into disk file
  */
-void DiskManagerMemory::WritePage(page_id_t page_id, const char *page_data) {
+auto DiskManagerMemory::WritePage(page_id_t page_id, const char *page_data) -> bool {
+  if (GetTablespaceId(page_id) != DEFAULT_TABLESPACE) {
+    return DiskManager::WritePage(page_id, page_data);
+  }
   size_t offset = static_cast<size_t>(page_id) * BUSTUB_PAGE_SIZE;
   // set write cursor to offset
   num_writes_ += 1;
   memcpy(memory_ + offset, page_data, BUSTUB_PAGE_SIZE);
+  return true;
 }
 
 /**
  * Read the contents of the specified page into the given memory area
  */
-void DiskManagerMemory::ReadPage(page_id_t page_id, char *page_data) {
+auto DiskManagerMemory::ReadPage(page_id_t page_id, char *page_data) -> bool {
+  if (GetTablespaceId(page_id) != DEFAULT_TABLESPACE) {
+    return DiskManager::ReadPage(page_id, page_data);
+  }
   int64_t offset = static_cast<int64_t>(page_id) * BUSTUB_PAGE_SIZE;
   memcpy(page_data, memory_ + offset, BUSTUB_PAGE_SIZE);
+  return true;
+}
+
+auto DiskManagerMemory::NewTablespace(const std::string &file_name) -> std::unique_ptr<DiskManager> {
+  return std::make_unique<DiskManagerUnlimitedMemory>();
 }
 
 }  // namespace bustub
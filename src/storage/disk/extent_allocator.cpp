@@ -0,0 +1,48 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extent_allocator.cpp
+//
+// Identification: src/storage/disk/extent_allocator.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/extent_allocator.h"
+
+namespace bustub {
+
+ExtentAllocator::~ExtentAllocator() {
+  if (disk_manager_ != nullptr && next_page_id_ < end_page_id_) {
+    disk_manager_->DeallocateExtent(next_page_id_, end_page_id_ - next_page_id_);
+  }
+}
+
+auto ExtentAllocator::AllocatePage(DiskManager *disk_manager) -> page_id_t {
+  std::scoped_lock lock(latch_);
+  if (next_page_id_ == end_page_id_) {
+    disk_manager_ = disk_manager;
+    next_page_id_ = disk_manager->AllocateExtent(extent_size_, tablespace_);
+    end_page_id_ = next_page_id_ + static_cast<page_id_t>(extent_size_);
+    num_extents_++;
+  }
+  return next_page_id_++;
+}
+
+void ExtentAllocator::ReleasePage(DiskManager *disk_manager, page_id_t page_id) {
+  std::scoped_lock lock(latch_);
+  if (page_id != INVALID_PAGE_ID && page_id == next_page_id_ - 1) {
+    next_page_id_--;
+    return;
+  }
+  disk_manager->DeallocatePage(page_id);
+}
+
+auto ExtentAllocator::GetNumExtents() -> size_t {
+  std::scoped_lock lock(latch_);
+  return num_extents_;
+}
+
+}  // namespace bustub
@@ -0,0 +1,115 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// mmap_disk_manager.cpp
+//
+// Identification: src/storage/disk/mmap_disk_manager.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/mmap_disk_manager.h"
+
+#include <sys/mman.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+namespace bustub {
+
+/**
+ * Constructor: open the database file and map as much of it as exists
+ */
+MmapDiskManager::MmapDiskManager(const std::string &db_file, size_t max_map_size)
+    : DiskManager(db_file), max_map_size_(max_map_size / BUSTUB_PAGE_SIZE * BUSTUB_PAGE_SIZE) {
+  // Reserve the address range only; the file is mapped over it piece by piece.
+  void *base = mmap(nullptr, max_map_size_, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (base == MAP_FAILED) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot reserve the address range of the mapping");
+  }
+  map_base_ = static_cast<char *>(base);
+  GrowMapping();
+}
+
+MmapDiskManager::~MmapDiskManager() { munmap(map_base_, max_map_size_); }
+
+/**
+ * Copy the page out of the mapping, or read it with pread() if it lies past the mapped end of the file
+ */
+auto MmapDiskManager::ReadPage(page_id_t page_id, char *page_data) -> bool {
+  const char *mapped = GetMappedPage(page_id);
+  if (mapped == nullptr) {
+    return DiskManager::ReadPage(page_id, page_data);
+  }
+  memcpy(page_data, mapped, BUSTUB_PAGE_SIZE);
+  return true;
+}
+
+auto MmapDiskManager::GetMappedPage(page_id_t page_id) -> const char * {
+  // Only the database file is mapped, the files of tablespaces are read with pread().
+  if (page_id < 0 || GetTablespaceId(page_id) != DEFAULT_TABLESPACE) {
+    return nullptr;
+  }
+  size_t offset = GetPageOffset(page_id);
+  if (offset + BUSTUB_PAGE_SIZE > mapped_size_ && !(GrowMapping() && offset + BUSTUB_PAGE_SIZE <= mapped_size_)) {
+    return nullptr;
+  }
+  return map_base_ + offset;
+}
+
+auto MmapDiskManager::Compact() -> size_t {
+  std::scoped_lock scoped_map_latch(map_latch_);
+  size_t dropped = DiskManager::Compact();
+  size_t file_size = std::max<int64_t>(GetFileSize(file_name_), 0);
+  size_t mapped_size = mapped_size_;
+  if (file_size < mapped_size) {
+    // Put the reservation back over the truncated part, touching it would fault.
+    mapped_size_ = file_size / BUSTUB_PAGE_SIZE * BUSTUB_PAGE_SIZE;
+    mmap(map_base_ + mapped_size_, mapped_size - mapped_size_, PROT_NONE,
+         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+  }
+  return dropped;
+}
+
+void MmapDiskManager::AdviseSequentialRead(page_id_t page_id, size_t count) {
+  if (GetTablespaceId(page_id) != DEFAULT_TABLESPACE) {
+    return;
+  }
+  size_t begin = GetPageOffset(page_id);
+  size_t end = std::min(GetPageOffset(page_id + static_cast<page_id_t>(count)), static_cast<size_t>(mapped_size_));
+  if (begin < end) {
+    madvise(map_base_ + begin, end - begin, MADV_WILLNEED);
+  }
+}
+
+/**
+ * Map the part of the file that has been written since the last time, right after the part that is already mapped
+ */
+auto MmapDiskManager::GrowMapping() -> bool {
+  std::scoped_lock scoped_map_latch(map_latch_);
+  if (db_fd_ < 0) {
+    return false;
+  }
+  int64_t file_size = GetFileSize(file_name_);
+  size_t new_size = std::min(static_cast<size_t>(std::max<int64_t>(file_size, 0)) / BUSTUB_PAGE_SIZE * BUSTUB_PAGE_SIZE,
+                             max_map_size_);
+  size_t mapped_size = mapped_size_;
+  if (new_size <= mapped_size) {
+    return false;
+  }
+  void *mapped = mmap(map_base_ + mapped_size, new_size - mapped_size, PROT_READ, MAP_SHARED | MAP_FIXED, db_fd_,
+                      static_cast<off_t>(mapped_size));
+  if (mapped == MAP_FAILED) {
+    LOG_DEBUG("cannot map the database file");
+    return false;
+  }
+  mapped_size_ = new_size;
+  return true;
+}
+
+}  // namespace bustub
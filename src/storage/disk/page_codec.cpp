@@ -0,0 +1,170 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_codec.cpp
+//
+// Identification: src/storage/disk/page_codec.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/page_codec.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace bustub {
+
+/** The hash table of 4-byte prefixes has 2^HASH_BITS entries. */
+static constexpr int HASH_BITS = 12;
+/** A nibble of the token with this value continues in extra length bytes. */
+static constexpr size_t NIBBLE_MAX = 15;
+
+static auto Load32(const uint8_t *data) -> uint32_t {
+  uint32_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+static auto Hash(uint32_t prefix) -> uint32_t { return (prefix * 2654435761U) >> (32 - HASH_BITS); }
+
+/** Append the part of a length that does not fit in its nibble. @return false if `out` is full */
+static auto EmitLength(uint8_t *out, size_t *op, size_t capacity, size_t length) -> bool {
+  while (length >= 255) {
+    if (*op >= capacity) {
+      return false;
+    }
+    out[(*op)++] = 255;
+    length -= 255;
+  }
+  if (*op >= capacity) {
+    return false;
+  }
+  out[(*op)++] = static_cast<uint8_t>(length);
+  return true;
+}
+
+/**
+ * Append a sequence: `literal_count` literals, then a match of `match_length` bytes `offset` bytes back, or no match
+ * if `match_length` is 0. @return false if `out` is full
+ */
+static auto EmitSequence(uint8_t *out, size_t *op, size_t capacity, const uint8_t *literals, size_t literal_count,
+                         size_t offset, size_t match_length) -> bool {
+  if (*op >= capacity) {
+    return false;
+  }
+  size_t match_code = match_length == 0 ? 0 : match_length - PageCodec::MIN_MATCH;
+  out[(*op)++] = static_cast<uint8_t>(std::min(literal_count, NIBBLE_MAX) << 4 | std::min(match_code, NIBBLE_MAX));
+  if (literal_count >= NIBBLE_MAX && !EmitLength(out, op, capacity, literal_count - NIBBLE_MAX)) {
+    return false;
+  }
+  if (literal_count > capacity - *op) {
+    return false;
+  }
+  memcpy(out + *op, literals, literal_count);
+  *op += literal_count;
+  if (match_length == 0) {
+    return true;
+  }
+  if (capacity - *op < 2) {
+    return false;
+  }
+  out[(*op)++] = static_cast<uint8_t>(offset);
+  out[(*op)++] = static_cast<uint8_t>(offset >> 8);
+  return match_code < NIBBLE_MAX || EmitLength(out, op, capacity, match_code - NIBBLE_MAX);
+}
+
+/** Add the extra bytes of a length to it. @return false if the input ends first */
+static auto ReadLength(const uint8_t *in, size_t *ip, size_t size, size_t *length) -> bool {
+  uint8_t byte;
+  do {
+    if (*ip >= size) {
+      return false;
+    }
+    byte = in[(*ip)++];
+    *length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+auto PageCodec::Compress(const char *src, size_t size, char *dst, size_t capacity) -> size_t {
+  const auto *in = reinterpret_cast<const uint8_t *>(src);
+  auto *out = reinterpret_cast<uint8_t *>(dst);
+  // positions fit in 16 bits because inputs are at most MAX_OFFSET + 1 bytes
+  std::array<uint16_t, 1 << HASH_BITS> last_position{};
+  size_t ip = 0;
+  size_t anchor = 0;
+  size_t op = 0;
+  while (ip + MIN_MATCH <= size) {
+    uint32_t prefix = Load32(in + ip);
+    uint32_t hash = Hash(prefix);
+    size_t candidate = last_position[hash];
+    last_position[hash] = static_cast<uint16_t>(ip);
+    if (candidate >= ip || ip - candidate > MAX_OFFSET || Load32(in + candidate) != prefix) {
+      ip++;
+      continue;
+    }
+    size_t match_length = MIN_MATCH;
+    while (ip + match_length < size && in[candidate + match_length] == in[ip + match_length]) {
+      match_length++;
+    }
+    if (!EmitSequence(out, &op, capacity, in + anchor, ip - anchor, ip - candidate, match_length)) {
+      return 0;
+    }
+    ip += match_length;
+    anchor = ip;
+  }
+  if (!EmitSequence(out, &op, capacity, in + anchor, size - anchor, 0, 0)) {
+    return 0;
+  }
+  return op;
+}
+
+auto PageCodec::Decompress(const char *src, size_t size, char *dst, size_t dst_size) -> bool {
+  const auto *in = reinterpret_cast<const uint8_t *>(src);
+  auto *out = reinterpret_cast<uint8_t *>(dst);
+  size_t ip = 0;
+  size_t op = 0;
+  while (ip < size) {
+    uint8_t token = in[ip++];
+    size_t literal_count = token >> 4;
+    if (literal_count == NIBBLE_MAX && !ReadLength(in, &ip, size, &literal_count)) {
+      return false;
+    }
+    if (literal_count > size - ip || literal_count > dst_size - op) {
+      return false;
+    }
+    memcpy(out + op, in + ip, literal_count);
+    ip += literal_count;
+    op += literal_count;
+    // the last sequence has no match
+    if (ip == size) {
+      break;
+    }
+    if (size - ip < 2) {
+      return false;
+    }
+    size_t offset = in[ip] | static_cast<size_t>(in[ip + 1]) << 8;
+    ip += 2;
+    size_t match_length = token & NIBBLE_MAX;
+    if (match_length == NIBBLE_MAX && !ReadLength(in, &ip, size, &match_length)) {
+      return false;
+    }
+    match_length += MIN_MATCH;
+    if (offset == 0 || offset > op || match_length > dst_size - op) {
+      return false;
+    }
+    // a match may overlap its own output, e.g. a run of one byte has offset 1
+    for (size_t i = 0; i < match_length; i++) {
+      out[op + i] = out[op + i - offset];
+    }
+    op += match_length;
+  }
+  return op == dst_size;
+}
+
+}  // namespace bustub
@@ -0,0 +1,163 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// simulated_disk_manager.cpp
+//
+// Identification: src/storage/disk/simulated_disk_manager.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/simulated_disk_manager.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>  // NOLINT
+#include <utility>
+
+#include "common/util/string_util.h"
+
+namespace bustub {
+
+namespace {
+
+/** Rough models of common devices, for pages of a few KB. */
+auto DiskModelPreset(const std::string &name, DiskModel *model) -> bool {
+  using std::chrono::microseconds;
+  if (name == "none") {
+    *model = DiskModel{};
+  } else if (name == "nvme") {
+    *model = DiskModel{microseconds(20), 0.3, 1.0, static_cast<size_t>(3000) << 20, 32};
+  } else if (name == "ssd") {
+    *model = DiskModel{microseconds(100), 0.5, 0.5, static_cast<size_t>(500) << 20, 8};
+  } else if (name == "hdd") {
+    *model = DiskModel{microseconds(8000), 0.3, 0.02, static_cast<size_t>(150) << 20, 1};
+  } else {
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+auto ParseDiskModel(const std::string &spec, DiskModel *model) -> bool {
+  auto parts = StringUtil::Split(StringUtil::Lower(spec), ',');
+  if (parts.empty() || !DiskModelPreset(parts[0], model)) {
+    return false;
+  }
+  for (size_t i = 1; i < parts.size(); i++) {
+    auto eq = parts[i].find('=');
+    if (eq == std::string::npos) {
+      return false;
+    }
+    auto key = parts[i].substr(0, eq);
+    auto value = parts[i].substr(eq + 1);
+    try {
+      if (key == "latency_us") {
+        model->latency_ = std::chrono::microseconds(std::stoll(value));
+      } else if (key == "sigma") {
+        model->latency_sigma_ = std::stod(value);
+      } else if (key == "sequential_factor") {
+        model->sequential_factor_ = std::stod(value);
+      } else if (key == "bandwidth_mbps") {
+        model->bandwidth_ = static_cast<size_t>(std::stoll(value)) << 20;
+      } else if (key == "parallelism") {
+        model->parallelism_ = std::max<size_t>(std::stoll(value), 1);
+      } else {
+        return false;
+      }
+    } catch (const std::logic_error &) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void WriteIoTrace(std::ostream &out, const std::vector<DiskIo> &trace) {
+  for (const auto &io : trace) {
+    out << io.submit_us_ << ' ' << io.page_id_ << ' ' << (io.is_write_ ? "write" : "read") << ' '
+        << (io.sequential_ ? "seq" : "rand") << ' ' << io.queue_us_ << ' ' << io.service_us_ << '\n';
+  }
+}
+
+auto SimulatedDiskManager::WritePage(page_id_t page_id, const char *page_data) -> bool {
+  SimulateIo(page_id, true);
+  return DiskManagerUnlimitedMemory::WritePage(page_id, page_data);
+}
+
+auto SimulatedDiskManager::ReadPage(page_id_t page_id, char *page_data) -> bool {
+  SimulateIo(page_id, false);
+  return DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+}
+
+void SimulatedDiskManager::SetDiskModel(const DiskModel &model) {
+  std::scoped_lock lock(latch_);
+  model_ = model;
+  model_.parallelism_ = std::max<size_t>(model_.parallelism_, 1);
+  // The median of a log-normal distribution is e^mu, the latency is applied as a factor of the median.
+  latency_dist_ = std::lognormal_distribution<double>(0, model_.latency_sigma_);
+  slot_cv_.notify_all();
+}
+
+auto SimulatedDiskManager::GetDiskModel() -> DiskModel {
+  std::scoped_lock lock(latch_);
+  return model_;
+}
+
+void SimulatedDiskManager::StartIoTrace() {
+  std::scoped_lock lock(latch_);
+  trace_.clear();
+  trace_start_ = std::chrono::steady_clock::now();
+  tracing_ = true;
+}
+
+auto SimulatedDiskManager::StopIoTrace() -> std::vector<DiskIo> {
+  std::scoped_lock lock(latch_);
+  tracing_ = false;
+  return std::move(trace_);
+}
+
+void SimulatedDiskManager::SimulateIo(page_id_t page_id, bool is_write) {
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  using std::chrono::steady_clock;
+  auto submit = steady_clock::now();
+  std::unique_lock<std::mutex> lock(latch_);
+  slot_cv_.wait(lock, [&] { return busy_slots_ < model_.parallelism_; });
+  auto start = steady_clock::now();
+  busy_slots_++;
+  bool sequential = last_page_id_ != INVALID_PAGE_ID && page_id == last_page_id_ + 1;
+  last_page_id_ = page_id;
+  double latency_us = static_cast<double>(model_.latency_.count());
+  if (model_.latency_sigma_ > 0) {
+    latency_us *= latency_dist_(rng_);
+  }
+  if (sequential) {
+    latency_us *= model_.sequential_factor_;
+  }
+  auto done = start + microseconds(std::llround(latency_us));
+  if (model_.bandwidth_ > 0) {
+    // The transfers of concurrent I/Os take turns on the bandwidth.
+    auto transfer = microseconds(static_cast<int64_t>(BUSTUB_PAGE_SIZE) * 1000000 / model_.bandwidth_);
+    transfer_end_ = std::max(transfer_end_, start) + transfer;
+    done = std::max(done, transfer_end_);
+  }
+  lock.unlock();
+
+  std::this_thread::sleep_until(done);
+
+  lock.lock();
+  busy_slots_--;
+  if (tracing_) {
+    auto end = steady_clock::now();
+    trace_.push_back({static_cast<uint64_t>(duration_cast<microseconds>(submit - trace_start_).count()), page_id,
+                      is_write, sequential, static_cast<uint64_t>(duration_cast<microseconds>(start - submit).count()),
+                      static_cast<uint64_t>(duration_cast<microseconds>(end - start).count())});
+  }
+  lock.unlock();
+  slot_cv_.notify_one();
+}
+
+}  // namespace bustub
@@ -9,15 +9,20 @@
 
 namespace bustub {
 
+/** How often an optimistic operation is attempted before it falls back to latch crabbing. */
+static constexpr int OPTIMISTIC_ATTEMPTS = 8;
+
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_TYPE::BPlusTree(std::string name, page_id_t header_page_id, BufferPoolManager *buffer_pool_manager,
-                          const KeyComparator &comparator, int leaf_max_size, int internal_max_size)
+                          const KeyComparator &comparator, int leaf_max_size, int internal_max_size,
+                          tablespace_id_t tablespace)
     : index_name_(std::move(name)),
       bpm_(buffer_pool_manager),
       comparator_(std::move(comparator)),
       leaf_max_size_(leaf_max_size),
       internal_max_size_(internal_max_size),
-      header_page_id_(header_page_id) {
+      header_page_id_(header_page_id),
+      extent_allocator_(EXTENT_SIZE, tablespace) {
   WritePageGuard guard = bpm_->FetchPageWrite(header_page_id_);
   auto root_page = guard.AsMut<BPlusTreeHeaderPage>();
   root_page->root_page_id_ = INVALID_PAGE_ID;
@@ -59,7 +64,7 @@ void BPLUSTREE_TYPE::SplitLeaf(MappingType insert_value, page_id_t &right_page_i
   auto leaf_page = ctx.write_set_.back().AsMut<LeafPage>();
   int insert_idx = BinarySearch(insert_value.first, leaf_page);
   // std::cout << "leaf insert index:" << insert_idx << std::endl;
-  BasicPageGuard basic_guard = bpm_->NewPageGuarded(&right_page_id);
+  BasicPageGuard basic_guard = bpm_->NewPageGuarded(&right_page_id, &extent_allocator_);
   auto right_page = basic_guard.AsMut<LeafPage>();
   right_page->Init(leaf_max_size_);
   // std::cout << "i'm here1 !" << '\n';
@@ -91,7 +96,7 @@ void BPLUSTREE_TYPE::SplitInternal(page_id_t &right_page_id, KeyType &new_key, C
   int split_idx = internal_page->GetMaxSize() / 2 + 1;
   new_key = internal_page->KeyAt(split_idx);
   // std::cout << "split_idx" << split_idx << "new_key" << new_key << '\n';
-  BasicPageGuard basic_guard = bpm_->NewPageGuarded(&right_page_id);
+  BasicPageGuard basic_guard = bpm_->NewPageGuarded(&right_page_id, &extent_allocator_);
   auto right_page = basic_guard.AsMut<InternalPage>();
   right_page->Init(internal_max_size_);
   // std:: cout << "right_page_id:" << right_page_id << '\n';
@@ -119,7 +124,7 @@ void BPLUSTREE_TYPE::InsertIntoInternal(KeyType key, page_id_t left_page_id, pag
   if (internal_page_id == header_page_id_) {  // The internal page not exsisted
     // std::cout << std::this_thread::get_id() << "The internal page not exsisted" << std::endl;
     page_id_t root_page_id = INVALID_PAGE_ID;
-    BasicPageGuard basic_guard = bpm_->NewPageGuarded(&root_page_id);
+    BasicPageGuard basic_guard = bpm_->NewPageGuarded(&root_page_id, &extent_allocator_);
     // std::cout << "root_page_id:" << root_page_id << '\n';
     auto root_page = basic_guard.AsMut<InternalPage>();
     root_page->Init(internal_max_size_);
@@ -338,6 +343,129 @@ void BPLUSTREE_TYPE::RemoveParentWriteLock(Context &ctx, page_id_t pos_page_id)
   }
 }
 
+/*
+ * Optimistic lock coupling: every page is copied through an optimistic guard and the copy is only used once the
+ * guard validates, so torn reads never reach the search code. A child's version is taken before its parent is
+ * validated, which proves that the child id read from the parent was still current.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::OptimisticDescend(const KeyType &key, ReadPageGuard *parent, page_id_t *leaf_page_id,
+                                       char *leaf_data) -> bool {
+  ReadPageGuard guard = bpm_->FetchPageOptimistic(header_page_id_);
+  bpm_->SwizzlePage(guard);
+  page_id_t page_id = guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (!guard.Validate()) {
+    return false;
+  }
+  while (page_id != INVALID_PAGE_ID) {
+    ReadPageGuard child_guard = bpm_->FetchPageOptimistic(page_id);
+    if (!guard.Validate()) {
+      return false;
+    }
+    memcpy(leaf_data, child_guard.GetData(), BUSTUB_PAGE_SIZE);
+    if (!child_guard.Validate()) {
+      return false;
+    }
+    if (reinterpret_cast<const BPlusTreePage *>(leaf_data)->IsLeafPage()) {
+      break;
+    }
+    bpm_->SwizzlePage(child_guard);
+    const auto internal_page = reinterpret_cast<const InternalPage *>(leaf_data);
+    int idx = BinarySearch(key, internal_page);
+    guard = std::move(child_guard);
+    page_id = internal_page->ValueAt(idx - 1);
+  }
+  *leaf_page_id = page_id;
+  *parent = std::move(guard);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::TryGetValueOptimistic(const KeyType &key, std::vector<ValueType> *result, bool *found)
+    -> OptimisticResult {
+  ReadPageGuard parent;
+  page_id_t leaf_page_id;
+  alignas(std::max_align_t) char leaf_data[BUSTUB_PAGE_SIZE];
+  if (!OptimisticDescend(key, &parent, &leaf_page_id, leaf_data)) {
+    return OptimisticResult::RETRY;
+  }
+  *found = false;
+  if (leaf_page_id == INVALID_PAGE_ID) {
+    return OptimisticResult::OK;
+  }
+  const auto leaf_page = reinterpret_cast<const LeafPage *>(leaf_data);
+  for (int i = BinarySearch(key, leaf_page); i < leaf_page->GetSize(); i++) {
+    if (comparator_(leaf_page->KeyAt(i), key) != 0) {
+      break;
+    }
+    result->push_back(leaf_page->ValueAt(i));
+    *found = true;
+  }
+  return OptimisticResult::OK;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::TryInsertOptimistic(const KeyType &key, const ValueType &value, bool *inserted)
+    -> OptimisticResult {
+  ReadPageGuard parent;
+  page_id_t leaf_page_id;
+  alignas(std::max_align_t) char leaf_data[BUSTUB_PAGE_SIZE];
+  if (!OptimisticDescend(key, &parent, &leaf_page_id, leaf_data)) {
+    return OptimisticResult::RETRY;
+  }
+  if (leaf_page_id == INVALID_PAGE_ID) {  // The tree is empty and needs a root.
+    return OptimisticResult::PESSIMISTIC;
+  }
+  WritePageGuard leaf_guard = bpm_->FetchPageWrite(leaf_page_id);
+  // Splitting or merging the leaf before we latched it would have written its parent.
+  if (!parent.Validate()) {
+    return OptimisticResult::RETRY;
+  }
+  const auto leaf_page = leaf_guard.As<LeafPage>();
+  int insert_idx = BinarySearch(key, leaf_page);
+  if (insert_idx < leaf_page->GetSize() && comparator_(leaf_page->KeyAt(insert_idx), key) == 0) {
+    *inserted = false;
+    return OptimisticResult::OK;
+  }
+  if (leaf_page->GetSize() >= leaf_page->GetMaxSize()) {  // The leaf has to be split.
+    return OptimisticResult::PESSIMISTIC;
+  }
+  auto leaf_page_mut = leaf_guard.AsMut<LeafPage>();
+  for (int i = leaf_page_mut->GetSize() - 1; i >= insert_idx; i--) {
+    leaf_page_mut->SetAt(i + 1, leaf_page_mut->KeyAt(i), leaf_page_mut->ValueAt(i));
+  }
+  leaf_page_mut->SetAt(insert_idx, key, value);
+  leaf_page_mut->IncreaseSize(1);
+  *inserted = true;
+  return OptimisticResult::OK;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::TryRemoveOptimistic(const KeyType &key) -> OptimisticResult {
+  ReadPageGuard parent;
+  page_id_t leaf_page_id;
+  alignas(std::max_align_t) char leaf_data[BUSTUB_PAGE_SIZE];
+  if (!OptimisticDescend(key, &parent, &leaf_page_id, leaf_data)) {
+    return OptimisticResult::RETRY;
+  }
+  if (leaf_page_id == INVALID_PAGE_ID) {
+    return OptimisticResult::OK;
+  }
+  Context ctx;
+  ctx.write_set_.emplace_back(bpm_->FetchPageWrite(leaf_page_id));
+  if (!parent.Validate()) {
+    return OptimisticResult::RETRY;
+  }
+  const auto leaf_page = ctx.write_set_.back().As<LeafPage>();
+  if (leaf_page->GetSize() <= leaf_page->GetMinSize() &&
+      leaf_page->GetParentPageId() != INVALID_PAGE_ID) {  // The leaf may underflow.
+    return OptimisticResult::PESSIMISTIC;
+  }
+  int leaf_key_idx = -1;
+  RemoveFromLeaf(key, leaf_key_idx, ctx);
+  return OptimisticResult::OK;
+}
+
 /*
  * Helper function to decide whether current b+tree is empty
  */
@@ -356,15 +484,23 @@ auto BPLUSTREE_TYPE::IsEmpty() const -> bool {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn) -> bool {
+  for (int attempt = 0; attempt < OPTIMISTIC_ATTEMPTS; attempt++) {
+    bool found;
+    if (TryGetValueOptimistic(key, result, &found) == OptimisticResult::OK) {
+      return found;
+    }
+  }
   // Declaration of context instance.
   Context ctx;
   (void)ctx;
-  ctx.read_set_.emplace_back(bpm_->FetchPageRead(header_page_id_));
-  page_id_t root_page_id = GetRootPageId();
+  // The header and the internal pages are swizzled, so resident paths are traversed without the page table.
+  ctx.read_set_.emplace_back(bpm_->FetchPageReadSwizzled(header_page_id_));
+  bpm_->SwizzlePage(ctx.read_set_.back());
+  page_id_t root_page_id = ctx.read_set_.back().As<BPlusTreeHeaderPage>()->root_page_id_;
   page_id_t pos_page_id = root_page_id;
   ctx.root_page_id_ = root_page_id;
   while (true) {  // Find the leafnode first
-    ctx.read_set_.emplace_back(bpm_->FetchPageRead(pos_page_id));
+    ctx.read_set_.emplace_back(bpm_->FetchPageReadSwizzled(pos_page_id));
     auto page = ctx.read_set_.back().As<BPlusTreePage>();
     if (!ctx.IsRootPage(pos_page_id)) {
       ctx.read_set_.pop_front();
@@ -384,6 +520,7 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
       }
       return true;
     }
+    bpm_->SwizzlePage(ctx.read_set_.back());
     const auto internal_page = ctx.read_set_.back().As<InternalPage>();
     int idx = BinarySearch(key, internal_page);
     pos_page_id = internal_page->ValueAt(idx - 1);
@@ -403,6 +540,17 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *txn) -> bool {
+  // Most inserts only touch their leaf: find it without latches and write-latch just the leaf.
+  for (int attempt = 0; attempt < OPTIMISTIC_ATTEMPTS; attempt++) {
+    bool inserted;
+    OptimisticResult res = TryInsertOptimistic(key, value, &inserted);
+    if (res == OptimisticResult::OK) {
+      return inserted;
+    }
+    if (res == OptimisticResult::PESSIMISTIC) {
+      break;
+    }
+  }
   // Declaration of context instance.
   Context ctx;
   (void)ctx;
@@ -414,7 +562,7 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
   ctx.root_page_id_ = root_page_id;
   if (root_page_id == INVALID_PAGE_ID) {
     // std::cout << "creat root page" << std::endl;
-    BasicPageGuard basic_guard = bpm_->NewPageGuarded(&root_page_id);
+    BasicPageGuard basic_guard = bpm_->NewPageGuarded(&root_page_id, &extent_allocator_);
     // Fetching a newpage as the rootpage failed
     auto leaf_page = basic_guard.AsMut<LeafPage>();
     leaf_page->Init(leaf_max_size_);
@@ -485,6 +633,15 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
+  for (int attempt = 0; attempt < OPTIMISTIC_ATTEMPTS; attempt++) {
+    OptimisticResult res = TryRemoveOptimistic(key);
+    if (res == OptimisticResult::OK) {
+      return;
+    }
+    if (res == OptimisticResult::PESSIMISTIC) {
+      break;
+    }
+  }
   // Declaration of context instance.
   Context ctx;
   (void)ctx;
@@ -672,7 +829,9 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
     const auto page = read_guard.As<BPlusTreePage>();
     if (page->IsLeafPage()) {
       leaf_page_id = read_guard.PageId();
-      return INDEXITERATOR_TYPE(leaf_page_id, 0, bpm_);
+      read_guard.Drop();
+      return INDEXITERATOR_TYPE(leaf_page_id, 0, bpm_,
+                                [this](const KeyType &key, size_t max_count) { return LeafRun(key, max_count); });
     }
     const auto internal_page = read_guard.As<InternalPage>();
     pos_page_id = internal_page->ValueAt(0);
@@ -710,7 +869,32 @@ auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
   ReadPageGuard read_guard = bpm_->FetchPageRead(leaf_page_id);
   const auto leaf_page = read_guard.As<LeafPage>();
   int key_index = BinarySearch(key, leaf_page);
-  return INDEXITERATOR_TYPE(leaf_page_id, key_index, bpm_);
+  read_guard.Drop();
+  return INDEXITERATOR_TYPE(leaf_page_id, key_index, bpm_,
+                            [this](const KeyType &key, size_t max_count) { return LeafRun(key, max_count); });
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::LeafRun(const KeyType &key, size_t max_count) -> std::vector<page_id_t> {
+  std::vector<page_id_t> run;
+  page_id_t page_id = GetRootPageId();
+  while (page_id != INVALID_PAGE_ID) {
+    ReadPageGuard read_guard = bpm_->FetchPageRead(page_id);
+    if (read_guard.As<BPlusTreePage>()->IsLeafPage()) {
+      if (run.empty()) {
+        // The root is a leaf, it has no siblings.
+        run.push_back(page_id);
+      }
+      break;
+    }
+    auto internal_page = read_guard.As<InternalPage>();
+    run.clear();
+    for (int i = BinarySearch(key, internal_page) - 1; i < internal_page->GetSize() && run.size() < max_count; i++) {
+      run.push_back(internal_page->ValueAt(i));
+    }
+    page_id = run.front();
+  }
+  return run;
 }
 
 /*
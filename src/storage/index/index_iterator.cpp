@@ -3,6 +3,7 @@
  */
 #include <cassert>
 
+#include "buffer/buffer_pool_manager.h"
 #include "storage/index/index_iterator.h"
 
 namespace bustub {
@@ -12,12 +13,17 @@ namespace bustub {
  * set your own input parameters
  */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::IndexIterator(page_id_t leaf_page_id, int index, BufferPoolManager *bpm)
-    : leaf_page_id_(leaf_page_id), bpm_(bpm), index_(index) {
+INDEXITERATOR_TYPE::IndexIterator(page_id_t leaf_page_id, int index, BufferPoolManager *bpm, LeafRunFn leaf_run)
+    : leaf_page_id_(leaf_page_id), bpm_(bpm), index_(index), leaf_run_(std::move(leaf_run)) {
   if (leaf_page_id_ != INVALID_PAGE_ID) {
-    ReadPageGuard read_guard = bpm_->FetchPageRead(leaf_page_id);
-    leaf_page_ = read_guard.As<B_PLUS_TREE_LEAF_PAGE_TYPE>();
-    pair_ = MappingType(leaf_page_->KeyAt(index_), leaf_page_->ValueAt(index_));
+    leaves_.emplace_back(bpm_->FetchPageBasic(leaf_page_id_));
+    auto &leaf = leaves_.front();
+    leaf_page_ = leaf.As<B_PLUS_TREE_LEAF_PAGE_TYPE>();
+    leaf.RLatch();
+    if (index_ < leaf_page_->GetSize()) {
+      pair_ = MappingType(leaf_page_->KeyAt(index_), leaf_page_->ValueAt(index_));
+    }
+    leaf.RUnlatch();
   }
 }
 
@@ -34,21 +40,51 @@ auto INDEXITERATOR_TYPE::operator*() -> const MappingType & { return pair_; }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
+  leaves_.front().RLatch();
   index_++;
   if (IsEnd()) {
+    leaves_.front().RUnlatch();
     return *this;
   }
   if (index_ == leaf_page_->GetSize() && leaf_page_->GetNextPageId() != INVALID_PAGE_ID) {
     // The last key-value pair of this leaf page.
-    leaf_page_id_ = leaf_page_->GetNextPageId();
-    ReadPageGuard read_guard = bpm_->FetchPageRead(leaf_page_id_);
-    leaf_page_ = read_guard.As<B_PLUS_TREE_LEAF_PAGE_TYPE>();
+    NextLeaf();
     index_ = 0;
   }
   pair_ = MappingType(leaf_page_->KeyAt(index_), leaf_page_->ValueAt(index_));
+  leaves_.front().RUnlatch();
   return *this;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::NextLeaf() {
+  // Called with the current leaf read latched, returns with the next one read latched.
+  page_id_t next_page_id = leaf_page_->GetNextPageId();
+  KeyType last_key = leaf_page_->KeyAt(leaf_page_->GetSize() - 1);
+  leaves_.front().RUnlatch();
+  if (leaves_.size() == 1 && leaf_run_) {
+    // The run starts with the current leaf; only use it if it goes where the leaf chain goes.
+    auto run = leaf_run_(last_key, bpm_->GetScanBatchSize() + 1);
+    if (run.size() > 1 && run[0] == leaf_page_id_ && run[1] == next_page_id) {
+      run.erase(run.begin());
+      for (auto &guard : bpm_->FetchPagesBasic(run)) {
+        if (!guard.HasPage()) {
+          break;
+        }
+        leaves_.emplace_back(std::move(guard));
+      }
+    }
+  }
+  leaves_.pop_front();
+  if (leaves_.empty() || leaves_.front().PageId() != next_page_id) {
+    leaves_.clear();
+    leaves_.emplace_back(bpm_->FetchPageBasic(next_page_id));
+  }
+  leaf_page_id_ = next_page_id;
+  leaf_page_ = leaves_.front().As<B_PLUS_TREE_LEAF_PAGE_TYPE>();
+  leaves_.front().RLatch();
+}
+
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
 
 template class IndexIterator<GenericKey<8>, RID, GenericComparator<8>>;
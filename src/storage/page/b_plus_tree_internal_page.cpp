@@ -65,4 +65,7 @@ template class BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator
 template class BPlusTreeInternalPage<GenericKey<16>, page_id_t, GenericComparator<16>>;
 template class BPlusTreeInternalPage<GenericKey<32>, page_id_t, GenericComparator<32>>;
 template class BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+
+static_assert(sizeof(BPlusTreeInternalPage<GenericKey<4>, page_id_t, GenericComparator<4>>) <= BUSTUB_PAGE_SIZE);
+static_assert(sizeof(BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>) <= BUSTUB_PAGE_SIZE);
 }  // namespace bustub
@@ -73,4 +73,7 @@ template class BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTreeLeafPage<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTreeLeafPage<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTreeLeafPage<GenericKey<64>, RID, GenericComparator<64>>;
+
+static_assert(sizeof(BPlusTreeLeafPage<GenericKey<4>, RID, GenericComparator<4>>) <= BUSTUB_PAGE_SIZE);
+static_assert(sizeof(BPlusTreeLeafPage<GenericKey<64>, RID, GenericComparator<64>>) <= BUSTUB_PAGE_SIZE);
 }  // namespace bustub
@@ -51,4 +51,8 @@ template class HashTableBlockPage<GenericKey<16>, RID, GenericComparator<16>>;
 template class HashTableBlockPage<GenericKey<32>, RID, GenericComparator<32>>;
 template class HashTableBlockPage<GenericKey<64>, RID, GenericComparator<64>>;
 
+static_assert(sizeof(HashTableBlockPage<int, int, IntComparator>) <= BUSTUB_PAGE_SIZE);
+static_assert(sizeof(HashTableBlockPage<GenericKey<4>, RID, GenericComparator<4>>) <= BUSTUB_PAGE_SIZE);
+static_assert(sizeof(HashTableBlockPage<GenericKey<64>, RID, GenericComparator<64>>) <= BUSTUB_PAGE_SIZE);
+
 }  // namespace bustub
@@ -173,6 +173,10 @@ template class HashTableBucketPage<GenericKey<16>, RID, GenericComparator<16>>;
 template class HashTableBucketPage<GenericKey<32>, RID, GenericComparator<32>>;
 template class HashTableBucketPage<GenericKey<64>, RID, GenericComparator<64>>;
 
+static_assert(sizeof(HashTableBucketPage<int, int, IntComparator>) <= BUSTUB_PAGE_SIZE);
+static_assert(sizeof(HashTableBucketPage<GenericKey<4>, RID, GenericComparator<4>>) <= BUSTUB_PAGE_SIZE);
+static_assert(sizeof(HashTableBucketPage<GenericKey<64>, RID, GenericComparator<64>>) <= BUSTUB_PAGE_SIZE);
+
 // template class HashTableBucketPage<hash_t, TmpTuple, HashComparator>;
 
 }  // namespace bustub
@@ -156,4 +156,6 @@ void HashTableDirectoryPage::PrintDirectory() {
   LOG_DEBUG("================ END DIRECTORY ================");
 }
 
+static_assert(sizeof(HashTableDirectoryPage) <= BUSTUB_PAGE_SIZE);
+
 }  // namespace bustub
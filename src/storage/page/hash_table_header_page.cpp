@@ -31,4 +31,6 @@ void HashTableHeaderPage::SetSize(size_t size) {}
 
 auto HashTableHeaderPage::GetSize() const -> size_t { return 0; }
 
+static_assert(sizeof(HashTableHeaderPage) <= BUSTUB_PAGE_SIZE);
+
 }  // namespace bustub
@@ -7,19 +7,26 @@ BasicPageGuard::BasicPageGuard(BasicPageGuard &&that) noexcept {
   this->bpm_ = that.bpm_;
   this->page_ = that.page_;
   this->is_dirty_ = that.is_dirty_;
+  this->swizzled_ = that.swizzled_;
   that.bpm_ = nullptr;
   that.page_ = nullptr;
   that.is_dirty_ = false;
+  that.swizzled_ = false;
 }
 
 void BasicPageGuard::Drop() {
   if (page_ == nullptr) {
     return;
   }
-  bpm_->UnpinPage(page_->GetPageId(), is_dirty_);
+  if (swizzled_) {
+    bpm_->UnpinSwizzledPage(page_);
+  } else if (bpm_ != nullptr) {
+    bpm_->UnpinPage(page_->GetPageId(), is_dirty_);
+  }
   bpm_ = nullptr;
   page_ = nullptr;
   is_dirty_ = false;
+  swizzled_ = false;
 }
 
 auto BasicPageGuard::operator=(BasicPageGuard &&that) noexcept -> BasicPageGuard & {
@@ -29,29 +36,49 @@ auto BasicPageGuard::operator=(BasicPageGuard &&that) noexcept -> BasicPageGuard
   this->bpm_ = that.bpm_;
   this->page_ = that.page_;
   this->is_dirty_ = that.is_dirty_;
+  this->swizzled_ = that.swizzled_;
   that.bpm_ = nullptr;
   that.page_ = nullptr;
   that.is_dirty_ = false;
+  that.swizzled_ = false;
   return *this;
 }
 
 BasicPageGuard::~BasicPageGuard() { Drop(); };  // NOLINT
 
-ReadPageGuard::ReadPageGuard(ReadPageGuard &&that) noexcept { guard_ = std::move(that.guard_); };
+ReadPageGuard::ReadPageGuard(ReadPageGuard &&that) noexcept {
+  guard_ = std::move(that.guard_);
+  optimistic_ = that.optimistic_;
+  version_ = that.version_;
+  that.optimistic_ = false;
+};
 
 auto ReadPageGuard::operator=(ReadPageGuard &&that) noexcept -> ReadPageGuard & {
-  if (guard_.page_ != nullptr) {
+  if (guard_.page_ != nullptr && !optimistic_) {
     guard_.page_->RUnlatch();
   }
   guard_ = std::move(that.guard_);
+  optimistic_ = that.optimistic_;
+  version_ = that.version_;
+  that.optimistic_ = false;
   return *this;
 }
 
 void ReadPageGuard::Drop() {
-  if (guard_.page_ != nullptr) {
+  if (guard_.page_ != nullptr && !optimistic_) {
     guard_.page_->RUnlatch();
   }
   guard_.Drop();
+  optimistic_ = false;
+}
+
+auto ReadPageGuard::Validate() const -> bool {
+  if (!optimistic_) {
+    return true;
+  }
+  // Keep the reads of the page data from being reordered after the version check.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return guard_.page_->GetVersion() == version_;
 }
 
 ReadPageGuard::~ReadPageGuard() { Drop(); }  // NOLINT
@@ -36,12 +36,12 @@ auto TablePage::GetNextTupleOffset(const TupleMeta &meta, const Tuple &tuple) co
   } else {
     slot_end_offset = BUSTUB_PAGE_SIZE;
   }
-  auto tuple_offset = slot_end_offset - tuple.GetLength();
   auto offset_size = TABLE_PAGE_HEADER_SIZE + TUPLE_INFO_SIZE * (num_tuples_ + 1);
-  if (tuple_offset < offset_size) {
+  // a tuple longer than the free space must not wrap the offset around
+  if (slot_end_offset < offset_size + tuple.GetLength()) {
     return std::nullopt;
   }
-  return tuple_offset;
+  return slot_end_offset - tuple.GetLength();
 }
 
 auto TablePage::InsertTuple(const TupleMeta &meta, const Tuple &tuple) -> std::optional<uint16_t> {
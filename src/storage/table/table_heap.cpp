@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
 #include <mutex>  // NOLINT
 #include <utility>
@@ -26,10 +27,12 @@
 
 namespace bustub {
 
-TableHeap::TableHeap(BufferPoolManager *bpm) : bpm_(bpm) {
+TableHeap::TableHeap(BufferPoolManager *bpm, tablespace_id_t tablespace)
+    : bpm_(bpm), extent_allocator_(EXTENT_SIZE, tablespace) {
   // Initialize the first table page.
-  auto guard = bpm->NewPageGuarded(&first_page_id_);
+  auto guard = bpm->NewPageGuarded(&first_page_id_, &extent_allocator_);
   last_page_id_ = first_page_id_;
+  page_ids_.push_back(first_page_id_);
   auto first_page = guard.AsMut<TablePage>();
   BUSTUB_ASSERT(first_page != nullptr,
                 "Couldn't create a page for the table heap. Have you completed the buffer pool manager project?");
@@ -52,7 +55,7 @@ auto TableHeap::InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManag
     BUSTUB_ENSURE(page->GetNumTuples() != 0, "tuple is too large, cannot insert");
 
     page_id_t next_page_id = INVALID_PAGE_ID;
-    auto npg = bpm_->NewPage(&next_page_id);
+    auto npg = bpm_->NewPage(&next_page_id, &extent_allocator_);
     BUSTUB_ENSURE(next_page_id != INVALID_PAGE_ID, "cannot allocate page");
 
     page->SetNextPageId(next_page_id);
@@ -67,6 +70,7 @@ auto TableHeap::InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManag
     auto next_page_guard = WritePageGuard{bpm_, npg};
 
     last_page_id_ = next_page_id;
+    page_ids_.push_back(next_page_id);
     page_guard = std::move(next_page_guard);
   }
   auto last_page_id = last_page_id_;
@@ -93,8 +97,8 @@ void TableHeap::UpdateTupleMeta(const TupleMeta &meta, RID rid) {
   page->UpdateTupleMeta(meta, rid);
 }
 
-auto TableHeap::GetTuple(RID rid) -> std::pair<TupleMeta, Tuple> {
-  auto page_guard = bpm_->FetchPageRead(rid.GetPageId());
+auto TableHeap::GetTuple(RID rid, AccessType access_type) -> std::pair<TupleMeta, Tuple> {
+  auto page_guard = bpm_->FetchPageRead(rid.GetPageId(), access_type);
   auto page = page_guard.As<TablePage>();
   auto [meta, tuple] = page->GetTuple(rid);
   tuple.rid_ = rid;
@@ -107,16 +111,23 @@ auto TableHeap::GetTupleMeta(RID rid) -> TupleMeta {
   return page->GetTupleMeta(rid);
 }
 
+auto TableHeap::GetPageIds(size_t from, size_t max_count) -> std::vector<page_id_t> {
+  std::lock_guard<std::mutex> guard(latch_);
+  from = std::min(from, page_ids_.size());
+  auto to = from + std::min(max_count, page_ids_.size() - from);
+  return {page_ids_.begin() + from, page_ids_.begin() + to};
+}
+
 auto TableHeap::MakeIterator() -> TableIterator {
   std::unique_lock<std::mutex> guard(latch_);
   auto last_page_id = last_page_id_;
   guard.unlock();
   auto page_guard = bpm_->FetchPageRead(last_page_id);
   auto page = page_guard.As<TablePage>();
-  return {this, {first_page_id_, 0}, {last_page_id, page->GetNumTuples()}};
+  return {this, {first_page_id_, 0}, 0, {last_page_id, page->GetNumTuples()}};
 }
 
-auto TableHeap::MakeEagerIterator() -> TableIterator { return {this, {first_page_id_, 0}, {INVALID_PAGE_ID, 0}}; }
+auto TableHeap::MakeEagerIterator() -> TableIterator { return {this, {first_page_id_, 0}, 0, {INVALID_PAGE_ID, 0}}; }
 
 void TableHeap::UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid) {
   auto page_guard = bpm_->FetchPageWrite(rid.GetPageId());
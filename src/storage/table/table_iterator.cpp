@@ -10,35 +10,108 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
 #include <optional>
 
 #include "common/config.h"
 #include "common/exception.h"
 #include "concurrency/transaction.h"
+#include "fmt/format.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
 
-TableIterator::TableIterator(TableHeap *table_heap, RID rid, RID stop_at_rid)
-    : table_heap_(table_heap), rid_(rid), stop_at_rid_(stop_at_rid) {
+static auto NextTablePageId(const char *page_data) -> page_id_t {
+  return reinterpret_cast<const TablePage *>(page_data)->GetNextPageId();
+}
+
+TableIterator::TableIterator(TableHeap *table_heap, RID rid, size_t page_index, RID stop_at_rid)
+    : table_heap_(table_heap), rid_(rid), next_page_index_(page_index), stop_at_rid_(stop_at_rid) {
   // If the rid doesn't correspond to a tuple (i.e., the table has just been initialized), then
   // we set rid_ to invalid.
-  auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
+  auto &page_guard = CurrentPage();
+  page_guard.RLatch();
   auto page = page_guard.As<TablePage>();
-  if (rid_.GetSlotNum() >= page->GetNumTuples()) {
+  auto num_tuples = page->GetNumTuples();
+  auto next_page_id = page->GetNextPageId();
+  page_guard.RUnlatch();
+  if (rid_.GetSlotNum() >= num_tuples) {
     rid_ = RID{INVALID_PAGE_ID, 0};
+    pages_.clear();
+  } else {
+    ReadAhead(next_page_id);
+  }
+}
+
+auto TableIterator::CurrentPage() -> BasicPageGuard & {
+  page_id_t page_id = rid_.GetPageId();
+  // Unpin the pages the scan has moved past.
+  while (!pages_.empty() && pages_.front().PageId() != page_id) {
+    pages_.pop_front();
+  }
+  auto *bpm = table_heap_->bpm_;
+  size_t window = bpm->GetScanBatchSize();
+  bool pinned_stop_page = !pages_.empty() && pages_.back().PageId() == stop_at_rid_.GetPageId();
+  if (pages_.size() <= window / 2 && !pinned_stop_page) {
+    // Top the window up in one batch, without pinning pages past the one the scan stops on.
+    auto page_ids = table_heap_->GetPageIds(next_page_index_, window - pages_.size());
+    auto stop_page = std::find(page_ids.begin(), page_ids.end(), stop_at_rid_.GetPageId());
+    if (stop_page != page_ids.end()) {
+      page_ids.erase(stop_page + 1, page_ids.end());
+    }
+    // Stop at the first page the buffer pool had no frame for, it is pinned on its own once the scan gets there.
+    for (auto &guard : bpm->FetchPagesBasic(page_ids, AccessType::Scan)) {
+      if (!guard.HasPage()) {
+        break;
+      }
+      pages_.emplace_back(std::move(guard));
+      next_page_index_++;
+    }
   }
+  if (pages_.empty()) {
+    pages_.emplace_back(bpm->FetchPageBasic(page_id, AccessType::Scan));
+    if (!pages_.front().HasPage()) {
+      pages_.clear();
+      throw Exception(ExceptionType::OUT_OF_MEMORY,
+                      fmt::format("no free frame to pin page {} of a table scan", page_id));
+    }
+    next_page_index_++;
+  }
+  BUSTUB_ASSERT(pages_.front().PageId() == page_id, "the scan left the page chain of its table");
+  return pages_.front();
 }
 
-auto TableIterator::GetTuple() -> std::pair<TupleMeta, Tuple> { return table_heap_->GetTuple(rid_); }
+void TableIterator::ReadAhead(page_id_t page_id) {
+  auto *bpm = table_heap_->bpm_;
+  if (pages_until_read_ahead_ > 0) {
+    pages_until_read_ahead_--;
+    return;
+  }
+  size_t window = bpm->GetReadAheadWindow();
+  if (window == 0 || page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  bpm->ReadAheadChain(page_id, NextTablePageId);
+  pages_until_read_ahead_ = std::max<size_t>(window / 2, 1) - 1;
+}
+
+auto TableIterator::GetTuple() -> std::pair<TupleMeta, Tuple> {
+  auto &page_guard = CurrentPage();
+  page_guard.RLatch();
+  auto [meta, tuple] = page_guard.As<TablePage>()->GetTuple(rid_);
+  page_guard.RUnlatch();
+  tuple.rid_ = rid_;
+  return std::make_pair(meta, std::move(tuple));
+}
 
 auto TableIterator::GetRID() -> RID { return rid_; }
 
 auto TableIterator::IsEnd() -> bool { return rid_.GetPageId() == INVALID_PAGE_ID; }
 
 auto TableIterator::operator++() -> TableIterator & {
-  auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
+  auto &page_guard = CurrentPage();
+  page_guard.RLatch();
   auto page = page_guard.As<TablePage>();
   auto next_tuple_id = rid_.GetSlotNum() + 1;
 
@@ -60,9 +133,13 @@ auto TableIterator::operator++() -> TableIterator & {
     auto next_page_id = page->GetNextPageId();
     // if next page is invalid, RID is set to invalid page; otherwise, it's the first tuple in that page.
     rid_ = RID{next_page_id, 0};
+    ReadAhead(next_page_id);
   }
 
-  page_guard.Drop();
+  page_guard.RUnlatch();
+  if (IsEnd()) {
+    pages_.clear();
+  }
 
   return *this;
 }
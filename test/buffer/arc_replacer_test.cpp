@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer_test.cpp
+//
+// Identification: test/buffer/arc_replacer_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/arc_replacer.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(ArcReplacerTest, SampleTest) {
+  ArcReplacer replacer(4);
+
+  // Scenario: load pages 10..13 into frames 0..3, they all go to T1. A second access moves frame 0 to T2.
+  for (frame_id_t frame_id = 0; frame_id < 4; ++frame_id) {
+    replacer.RecordAccess(frame_id, AccessType::Get, 10 + frame_id);
+    replacer.SetEvictable(frame_id, true);
+  }
+  replacer.RecordAccess(0, AccessType::Get, 10);
+  ASSERT_EQ(4, replacer.Size());
+  ASSERT_EQ(0, replacer.GetTarget());
+
+  // Scenario: T1 is larger than its target, so its LRU frames go first. Pages 11 and 12 move to B1.
+  int value;
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(1, value);
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(2, value);
+
+  // Scenario: page 11 is loaded again while in B1, so T1 was too small. Its target grows, the page goes to T2.
+  replacer.RecordAccess(1, AccessType::Get, 11);
+  replacer.SetEvictable(1, true);
+  EXPECT_EQ(1, replacer.GetTarget());
+
+  // Scenario: T1 holds one frame, which is its target, so the LRU frame of T2 goes. Page 10 moves to B2.
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(0, value);
+
+  // Scenario: page 10 is loaded again while in B2, so T2 was too small and the target of T1 shrinks.
+  replacer.RecordAccess(0, AccessType::Get, 10);
+  replacer.SetEvictable(0, true);
+  EXPECT_EQ(0, replacer.GetTarget());
+
+  // Scenario: a scan loading page 12 from B1 neither adapts the target nor promotes the page.
+  replacer.RecordAccess(2, AccessType::Scan, 12);
+  replacer.SetEvictable(2, true);
+  EXPECT_EQ(0, replacer.GetTarget());
+  EXPECT_EQ((std::vector<frame_id_t>{3, 2, 1, 0}), replacer.EvictionCandidates(4));
+
+  // Scenario: pinned and removed frames are never evicted.
+  replacer.SetEvictable(3, false);
+  replacer.Remove(2);
+  ASSERT_EQ(2, replacer.Size());
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(1, value);
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(0, value);
+  EXPECT_FALSE(replacer.Evict(&value));
+}
+
+}  // namespace bustub
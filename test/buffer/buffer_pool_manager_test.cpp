@@ -12,12 +12,20 @@
 
 #include "buffer/buffer_pool_manager.h"
 
+#include <algorithm>
+#include <chrono>  // NOLINT
 #include <cstdio>
 #include <limits>
 #include <random>
+#include <sstream>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
+#include "common/exception.h"
 #include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/simulated_disk_manager.h"
 
 namespace bustub {
 
@@ -37,6 +45,8 @@ TEST(BufferPoolManagerTest, BinaryDataTest) {
   static_assert(upper_bound - lower_bound == 255);
   std::uniform_int_distribution<int> uniform_dist(lower_bound, upper_bound);
 
+  // Start from an empty file, the page ids below assume it.
+  remove(db_name.c_str());
   auto *disk_manager = new DiskManager(db_name);
   auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, k);
 
@@ -96,6 +106,982 @@ TEST(BufferPoolManagerTest, BinaryDataTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+// Check that a partitioned buffer pool routes every page to its own partition
+TEST(BufferPoolManagerTest, PartitionedTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 8;
+  const size_t num_instances = 4;
+  const size_t k = 2;
+
+  // Start from an empty file, the page ids below assume it.
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, k, nullptr, num_instances);
+  EXPECT_EQ(num_instances, bpm->GetNumInstances());
+
+  // Scenario: Each partition holds two frames, so the first eight pages fit.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+  }
+
+  // Scenario: Every partition is now pinned full, so no page can be created.
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+
+  // Scenario: Unpinning a page only frees a frame in its own partition.
+  EXPECT_EQ(true, bpm->UnpinPage(1, true));
+  EXPECT_EQ(nullptr, bpm->FetchPage(10));
+  auto *page9 = bpm->FetchPage(9);
+  ASSERT_NE(nullptr, page9);
+  EXPECT_EQ(true, bpm->UnpinPage(9, false));
+
+  // Scenario: Page 1 was written back when it was evicted, and comes back once its partition has room.
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(buffer_pool_size); ++page_id) {
+    if (page_id != 1) {
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+    }
+  }
+  auto *page1 = bpm->FetchPage(1);
+  ASSERT_NE(nullptr, page1);
+  EXPECT_EQ(0, strcmp(page1->GetData(), "page 1"));
+  EXPECT_EQ(true, bpm->UnpinPage(1, false));
+
+  // Scenario: A deleted page leaves the page table of its partition.
+  EXPECT_EQ(true, bpm->DeletePage(1));
+  EXPECT_EQ(false, bpm->UnpinPage(1, false));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+// Check that NewPage reuses the ids of deleted pages
+TEST(BufferPoolManagerTest, DeletedPageReuseTest) {
+  const std::string db_name = "test.db";
+  remove(db_name.c_str());
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get());
+
+  page_id_t page_id;
+  for (page_id_t i = 0; i < 4; i++) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: The id of a deleted page is handed out again, and the new page starts out zeroed.
+  EXPECT_EQ(false, bpm->DeletePage(bpm->FetchPage(1)->GetPageId()));
+  EXPECT_EQ(true, bpm->UnpinPage(1, false));
+  EXPECT_EQ(true, bpm->DeletePage(1));
+  EXPECT_EQ(1, disk_manager->GetNumFreePages());
+  auto *page = bpm->NewPage(&page_id);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(1, page_id);
+  EXPECT_EQ(0, page->GetData()[0]);
+  EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+
+  // Scenario: A stale copy of a deleted page that was fetched again is taken over by the page that reuses its id.
+  EXPECT_EQ(true, bpm->DeletePage(2));
+  auto *stale_page = bpm->FetchPage(2);
+  ASSERT_NE(nullptr, stale_page);
+  EXPECT_EQ(true, bpm->UnpinPage(2, false));
+  page = bpm->NewPage(&page_id);
+  EXPECT_EQ(2, page_id);
+  EXPECT_EQ(stale_page, page);
+  EXPECT_EQ(0, page->GetData()[0]);
+  EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+
+  // Scenario: Without free pages, the database grows.
+  EXPECT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(4, page_id);
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, DeleteDuringWriteBackTest) {
+  auto disk_manager = std::make_unique<SimulatedDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManager>(1, disk_manager.get());
+
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(0, page_id);
+  EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+
+  // Scenario: Page 0 is deleted while its write-back is in flight. Its id is freed once the write lands.
+  disk_manager->SetDiskModel(DiskModel{std::chrono::milliseconds(100)});
+  std::thread evictor([&] {
+    page_id_t new_page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&new_page_id));
+    EXPECT_EQ(1, new_page_id);
+    EXPECT_EQ(true, bpm->UnpinPage(new_page_id, false));
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  EXPECT_EQ(true, bpm->DeletePage(0));
+  EXPECT_EQ(0, disk_manager->GetNumFreePages());
+  evictor.join();
+  EXPECT_EQ(1, disk_manager->GetNumFreePages());
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(0, page_id);
+}
+
+// NOLINTNEXTLINE
+// Check that a slow disk read does not block fetches of resident pages
+TEST(BufferPoolManagerTest, MissDoesNotBlockHitTest) {
+  const size_t buffer_pool_size = 4;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k);
+
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size * 2; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  // Pages 4..7 are resident now, pages 0..3 were written back.
+  auto *hot_page = bpm->FetchPage(7);
+  ASSERT_NE(nullptr, hot_page);
+  EXPECT_EQ(true, bpm->UnpinPage(7, false));
+
+  const size_t latency_ms = 500;
+  disk_manager->SetLatency(latency_ms);
+  std::thread miss_thread([&] {
+    auto *page = bpm->FetchPage(0);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->GetData(), "page 0"));
+    EXPECT_EQ(true, bpm->UnpinPage(0, false));
+  });
+
+  // Scenario: While the miss is waiting on the disk, a hit returns right away.
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  auto start = std::chrono::steady_clock::now();
+  hot_page = bpm->FetchPage(7);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  ASSERT_NE(nullptr, hot_page);
+  EXPECT_EQ(0, strcmp(hot_page->GetData(), "page 7"));
+  EXPECT_EQ(true, bpm->UnpinPage(7, false));
+  EXPECT_LT(elapsed, std::chrono::milliseconds(latency_ms / 2));
+
+  miss_thread.join();
+}
+
+// NOLINTNEXTLINE
+// Check that the page cleaner writes dirty victims back before they are evicted
+TEST(BufferPoolManagerTest, PageCleanerTest) {
+  const size_t buffer_pool_size = 10;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k);
+
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: With a clean target of the whole pool, the cleaner writes every dirty page back.
+  bpm->StartPageCleaner(1.0);
+  for (int i = 0; i < 100 && bpm->GetBackgroundWrites() < buffer_pool_size; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  bpm->StopPageCleaner();
+  EXPECT_EQ(buffer_pool_size, bpm->GetBackgroundWrites());
+
+  // Scenario: Replacing the whole pool needs no foreground write, and the data survives.
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  }
+  EXPECT_EQ(0, bpm->GetForegroundWrites());
+  auto *page0 = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "page 0"));
+  EXPECT_EQ(false, page0->IsDirty());
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ReadAheadTest) {
+  const size_t buffer_pool_size = 256;
+  const size_t num_pages = 512;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k);
+  bpm->SetReadAheadWindow(8);
+
+  // Each page stores the id of the page that follows it, in reverse order, so that the chain is not sequential.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < num_pages; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    *reinterpret_cast<page_id_t *>(page->GetData()) = page_id_temp == 0 ? INVALID_PAGE_ID : page_id_temp - 1;
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  auto wait_for_prefetch = [&](size_t count) {
+    for (int i = 0; i < 100 && bpm->GetReadAheadPages() < count; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(count, bpm->GetReadAheadPages());
+  };
+
+  // Scenario: A sequential scan triggers read-ahead of the pages after it, which are then hits.
+  for (page_id_t pid = 0; pid <= 4; ++pid) {
+    ASSERT_NE(nullptr, bpm->FetchPage(pid, AccessType::Scan));
+    EXPECT_EQ(true, bpm->UnpinPage(pid, false, AccessType::Scan));
+  }
+  wait_for_prefetch(8);
+  for (page_id_t pid = 5; pid <= 12; ++pid) {
+    ASSERT_NE(nullptr, bpm->FetchPage(pid, AccessType::Scan));
+    EXPECT_EQ(true, bpm->UnpinPage(pid, false, AccessType::Scan));
+  }
+  EXPECT_EQ(8, bpm->GetReadAheadHits());
+  // The scan kept going, so pages 13 to 20 are read ahead as well.
+  wait_for_prefetch(16);
+
+  // Scenario: Read-ahead along a page chain follows the links stored in the pages. Pages below 256 were evicted
+  // while the later pages were created.
+  bpm->ReadAheadChain(31, [](const char *data) { return *reinterpret_cast<const page_id_t *>(data); });
+  wait_for_prefetch(24);
+  for (page_id_t pid = 31; pid > 23; --pid) {
+    ASSERT_NE(nullptr, bpm->FetchPage(pid, AccessType::Scan));
+    EXPECT_EQ(true, bpm->UnpinPage(pid, false, AccessType::Scan));
+  }
+  EXPECT_EQ(16, bpm->GetReadAheadHits());
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ScanRingTest) {
+  const size_t buffer_pool_size = 64;
+  const size_t num_cold_pages = 1000;
+  const size_t num_hot_pages = 32;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k);
+
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < num_cold_pages + num_hot_pages; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: Scanning every cold page only recycles the few frames of the scan ring, so the hot pages, which were
+  // accessed more recently than the cold pages left in the pool, stay cached.
+  for (page_id_t pid = 0; pid < static_cast<page_id_t>(num_cold_pages); ++pid) {
+    ASSERT_NE(nullptr, bpm->FetchPage(pid, AccessType::Scan));
+    EXPECT_EQ(true, bpm->UnpinPage(pid, false, AccessType::Scan));
+  }
+  for (size_t i = num_cold_pages; i < num_cold_pages + num_hot_pages; ++i) {
+    auto pid = static_cast<page_id_t>(i);
+    ASSERT_NE(nullptr, bpm->FetchPage(pid, AccessType::Get));
+    EXPECT_EQ(true, bpm->UnpinPage(pid, false, AccessType::Get));
+  }
+  EXPECT_EQ(num_hot_pages, bpm->GetFetchHits(AccessType::Get));
+  EXPECT_EQ(0, bpm->GetFetchMisses(AccessType::Get));
+
+  // Scenario: A page of the ring that is then fetched by a lookup leaves the ring and is not recycled by the next scan.
+  ASSERT_NE(nullptr, bpm->FetchPage(0, AccessType::Scan));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false, AccessType::Scan));
+  ASSERT_NE(nullptr, bpm->FetchPage(0, AccessType::Get));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false, AccessType::Get));
+  for (page_id_t pid = 1; pid < static_cast<page_id_t>(num_cold_pages); ++pid) {
+    ASSERT_NE(nullptr, bpm->FetchPage(pid, AccessType::Scan));
+    EXPECT_EQ(true, bpm->UnpinPage(pid, false, AccessType::Scan));
+  }
+  ASSERT_NE(nullptr, bpm->FetchPage(0, AccessType::Get));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false, AccessType::Get));
+  EXPECT_EQ(num_hot_pages + 2, bpm->GetFetchHits(AccessType::Get));
+  EXPECT_EQ(0, bpm->GetFetchMisses(AccessType::Get));
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, FrameArenaTest) {
+  const size_t buffer_pool_size = 10;
+  const size_t k = 2;
+
+  for (auto allocation : {FrameAllocation::Arena, FrameAllocation::HugePageArena}) {
+    auto old_allocation = frame_allocation;
+    frame_allocation = allocation;
+    auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k);
+    frame_allocation = old_allocation;
+    EXPECT_EQ(allocation, bpm->GetFrameAllocation());
+
+    // Scenario: The frames are adjacent slices of one aligned region.
+    auto *pages = bpm->GetPages();
+    size_t alignment = allocation == FrameAllocation::HugePageArena ? 2 * 1024 * 1024 : BUSTUB_PAGE_SIZE;
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(pages[0].GetData()) % alignment);
+    for (size_t i = 1; i < buffer_pool_size; ++i) {
+      EXPECT_EQ(pages[0].GetData() + i * BUSTUB_PAGE_SIZE, pages[i].GetData());
+    }
+
+    // Scenario: Pages survive eviction and reloading through the arena.
+    page_id_t page_id_temp;
+    for (size_t i = 0; i < buffer_pool_size * 2; ++i) {
+      auto *page = bpm->NewPage(&page_id_temp);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+      EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+    }
+    for (page_id_t pid = 0; pid < static_cast<page_id_t>(buffer_pool_size * 2); ++pid) {
+      auto *page = bpm->FetchPage(pid);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(std::string("page ") + std::to_string(pid), page->GetData());
+      EXPECT_EQ(true, bpm->UnpinPage(pid, false));
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, SwizzleTest) {
+  const size_t buffer_pool_size = 10;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k);
+  bpm->SetSwizzleFraction(0.5);
+
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  auto fetch_and_swizzle = [&](page_id_t page_id) {
+    auto guard = bpm->FetchPageReadSwizzled(page_id);
+    ASSERT_EQ(page_id, guard.PageId());
+    bpm->SwizzlePage(guard);
+  };
+
+  // Scenario: Once swizzled, a page is fetched through its swip without the page table.
+  fetch_and_swizzle(0);
+  EXPECT_EQ(0, bpm->GetSwizzledFetches());
+  auto page_table_hits = bpm->GetFetchHits(AccessType::Unknown);
+  fetch_and_swizzle(0);
+  EXPECT_EQ(1, bpm->GetSwizzledFetches());
+  EXPECT_EQ(page_table_hits, bpm->GetFetchHits(AccessType::Unknown));
+
+  // Scenario: A swizzled page is never evicted.
+  for (size_t i = 0; i < buffer_pool_size * 2; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  }
+  fetch_and_swizzle(0);
+  EXPECT_EQ(2, bpm->GetSwizzledFetches());
+
+  // Scenario: Swizzling more than half of the pool cools the oldest swizzled page, which then takes the normal path.
+  for (page_id_t pid = 1; pid <= 5; ++pid) {
+    fetch_and_swizzle(pid);
+  }
+  fetch_and_swizzle(0);
+  EXPECT_EQ(2, bpm->GetSwizzledFetches());
+
+  // Scenario: When every frame is swizzled, new pages still get frames by cooling swizzled pages.
+  bpm->SetSwizzleFraction(1.0);
+  for (page_id_t pid = 0; pid < static_cast<page_id_t>(buffer_pool_size); ++pid) {
+    fetch_and_swizzle(pid);
+  }
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  }
+
+  // Scenario: Disabling swizzling cools every page.
+  fetch_and_swizzle(0);
+  bpm->SetSwizzleFraction(0);
+  auto swizzled_fetches = bpm->GetSwizzledFetches();
+  fetch_and_swizzle(0);
+  EXPECT_EQ(swizzled_fetches, bpm->GetSwizzledFetches());
+  EXPECT_EQ(true, bpm->DeletePage(0));
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, StatsTest) {
+  const size_t buffer_pool_size = 4;
+  // Plain LRU, so the new pages below evict the old ones.
+  const size_t k = 1;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k, nullptr, 2);
+
+  // Scenario: Creating pages fills the pool without hits, misses or evictions.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  auto stats = bpm->GetStats();
+  EXPECT_EQ(0, stats.TotalHits());
+  EXPECT_EQ(0, stats.TotalMisses());
+  EXPECT_EQ(0, stats.evictions_);
+  EXPECT_EQ(0, stats.HitRate());
+
+  // Scenario: Hits and misses are counted per access type, across partitions.
+  for (page_id_t pid = 0; pid < static_cast<page_id_t>(buffer_pool_size); ++pid) {
+    ASSERT_NE(nullptr, bpm->FetchPage(pid, AccessType::Get));
+    EXPECT_EQ(true, bpm->UnpinPage(pid, false));
+  }
+  ASSERT_NE(nullptr, bpm->FetchPage(0, AccessType::Scan));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+  stats = bpm->GetStats();
+  EXPECT_EQ(buffer_pool_size, stats.hits_[static_cast<size_t>(AccessType::Get)]);
+  EXPECT_EQ(1, stats.hits_[static_cast<size_t>(AccessType::Scan)]);
+  EXPECT_EQ(0, stats.TotalMisses());
+  EXPECT_EQ(1.0, stats.HitRate());
+
+  // Scenario: New pages evict the dirty pages, which are written back on the way. Fetching them again misses.
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  }
+  ASSERT_NE(nullptr, bpm->FetchPage(0, AccessType::Get));
+  stats = bpm->GetStats();
+  EXPECT_EQ(buffer_pool_size + 1, stats.evictions_);
+  EXPECT_EQ(buffer_pool_size, stats.foreground_writes_);
+  EXPECT_EQ(buffer_pool_size, stats.write_latency_.count_);
+  EXPECT_EQ(1, stats.misses_[static_cast<size_t>(AccessType::Get)]);
+  EXPECT_EQ(1, stats.miss_latency_.count_);
+
+  // Scenario: With every frame pinned, failed fetches and failed new pages are counted.
+  for (page_id_t pid = 1; pid < static_cast<page_id_t>(buffer_pool_size); ++pid) {
+    ASSERT_NE(nullptr, bpm->FetchPage(pid));
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(nullptr, bpm->FetchPage(buffer_pool_size + 1));
+  EXPECT_EQ(2, bpm->GetStats().no_free_frames_);
+
+  // Scenario: Explicit flushes are counted apart from write-backs.
+  EXPECT_EQ(true, bpm->FlushPage(0));
+  stats = bpm->GetStats();
+  EXPECT_EQ(1, stats.flushes_);
+  EXPECT_EQ(buffer_pool_size + 1, stats.write_latency_.count_);
+
+  // Scenario: Every statistic is reported by name.
+  auto rows = stats.ToRows();
+  auto find_row = [&](const std::string &name) {
+    auto iter = std::find_if(rows.begin(), rows.end(), [&](const auto &row) { return row.first == name; });
+    return iter == rows.end() ? std::string("<missing>") : iter->second;
+  };
+  EXPECT_EQ(std::to_string(stats.TotalHits()), find_row("hits"));
+  EXPECT_EQ(std::to_string(stats.evictions_), find_row("evictions"));
+  EXPECT_EQ("1", find_row("flushes"));
+  EXPECT_NE("<missing>", find_row("miss_latency_p99_us"));
+  EXPECT_EQ("0", find_row("read_ahead_window"));
+
+  // Scenario: The read-ahead window is reported as configured.
+  bpm->SetReadAheadWindow(4);
+  EXPECT_EQ(4, bpm->GetStats().read_ahead_window_);
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, BatchFetchTest) {
+  const size_t buffer_pool_size = 6;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k, nullptr, 2);
+
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size * 2; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  auto expected_data = [](page_id_t page_id) { return "page " + std::to_string(page_id); };
+
+  // Scenario: A batch mixes cached and evicted pages of both partitions. Every page is pinned and loaded.
+  auto stats = bpm->GetStats();
+  std::vector<page_id_t> page_ids = {0, 7, 2, 9};
+  auto guards = bpm->FetchPagesBasic(page_ids, AccessType::Scan);
+  ASSERT_EQ(page_ids.size(), guards.size());
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    ASSERT_TRUE(guards[i].HasPage());
+    EXPECT_EQ(page_ids[i], guards[i].PageId());
+    EXPECT_EQ(expected_data(page_ids[i]), guards[i].GetData());
+  }
+  auto batch_stats = bpm->GetStats();
+  EXPECT_EQ(2, batch_stats.hits_[static_cast<size_t>(AccessType::Scan)]);
+  EXPECT_EQ(2, batch_stats.misses_[static_cast<size_t>(AccessType::Scan)]);
+  EXPECT_EQ(stats.evictions_ + 2, batch_stats.evictions_);
+  guards.clear();
+
+  // Scenario: A page listed twice is pinned twice, and stays pinned until both guards are dropped.
+  guards = bpm->FetchPagesBasic({4, 4});
+  ASSERT_TRUE(guards[0].HasPage());
+  ASSERT_TRUE(guards[1].HasPage());
+  EXPECT_EQ(guards[0].GetData(), guards[1].GetData());
+  EXPECT_EQ(expected_data(4), guards[0].GetData());
+  guards[0].Drop();
+  EXPECT_EQ(false, bpm->DeletePage(4));
+  guards.clear();
+
+  // Scenario: A partition only holds three frames, so a batch of five of its pages only pins three of them.
+  guards = bpm->FetchPagesBasic({0, 2, 4, 6, 8});
+  EXPECT_EQ(3, std::count_if(guards.begin(), guards.end(), [](const BasicPageGuard &guard) { return guard.HasPage(); }));
+  EXPECT_EQ(2, bpm->GetStats().no_free_frames_);
+  guards.clear();
+
+  // Scenario: Read guards of a batch hold the read latch until they are dropped.
+  {
+    auto read_guards = bpm->FetchPagesRead({1, 3, 10});
+    for (auto &guard : read_guards) {
+      ASSERT_TRUE(guard.HasPage());
+      EXPECT_EQ(expected_data(guard.PageId()), guard.GetData());
+    }
+  }
+  auto write_guard = bpm->FetchPageWrite(3);
+  EXPECT_EQ(expected_data(3), write_guard.GetData());
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, LatencyHistogramTest) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(0, histogram.Snapshot().PercentileUs(99));
+  EXPECT_EQ(0, histogram.Snapshot().MeanUs());
+
+  // 90 fast samples below 1us, 9 around 100us and one of 10ms.
+  for (int i = 0; i < 90; ++i) {
+    histogram.Record(std::chrono::nanoseconds(500));
+  }
+  for (int i = 0; i < 9; ++i) {
+    histogram.Record(std::chrono::microseconds(100));
+  }
+  histogram.Record(std::chrono::milliseconds(10));
+
+  auto snapshot = histogram.Snapshot();
+  EXPECT_EQ(100, snapshot.count_);
+  EXPECT_EQ(1, snapshot.PercentileUs(50));
+  EXPECT_EQ(1, snapshot.PercentileUs(90));
+  EXPECT_EQ(128, snapshot.PercentileUs(99));
+  EXPECT_EQ(16384, snapshot.PercentileUs(100));
+  EXPECT_NEAR((90 * 0.5 + 9 * 100 + 10000) / 100.0, snapshot.MeanUs(), 1e-9);
+
+  // Merging adds up the samples.
+  snapshot.Merge(histogram.Snapshot());
+  EXPECT_EQ(200, snapshot.count_);
+  EXPECT_EQ(128, snapshot.PercentileUs(99));
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ReplacementPolicyTest) {
+  const size_t buffer_pool_size = 10;
+  const size_t k = 2;
+
+  for (auto policy :
+       {ReplacementPolicy::LRUK, ReplacementPolicy::Clock, ReplacementPolicy::TwoQueue, ReplacementPolicy::ARC}) {
+    auto old_policy = replacement_policy;
+    replacement_policy = policy;
+    auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k, nullptr, 2);
+    replacement_policy = old_policy;
+    EXPECT_EQ(policy, bpm->GetReplacementPolicy());
+
+    // Scenario: Pages survive eviction and reloading, whatever the victims are.
+    page_id_t page_id_temp;
+    for (size_t i = 0; i < buffer_pool_size * 3; ++i) {
+      auto *page = bpm->NewPage(&page_id_temp);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+      EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+    }
+    std::mt19937 gen(15445);
+    std::uniform_int_distribution<page_id_t> dist(0, buffer_pool_size * 3 - 1);
+    for (size_t i = 0; i < 200; ++i) {
+      page_id_t pid = dist(gen);
+      auto *page = bpm->FetchPage(pid, i % 4 == 0 ? AccessType::Scan : AccessType::Get);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(std::string("page ") + std::to_string(pid), page->GetData());
+      EXPECT_EQ(true, bpm->UnpinPage(pid, false));
+    }
+
+    // Scenario: Pinned pages are never chosen as victims.
+    std::vector<page_id_t> pinned;
+    for (size_t i = 0; i < buffer_pool_size; ++i) {
+      ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+      pinned.push_back(page_id_temp);
+    }
+    EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+    for (auto pid : pinned) {
+      EXPECT_EQ(true, bpm->UnpinPage(pid, false));
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, AccessTraceTest) {
+  const size_t buffer_pool_size = 10;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k);
+
+  page_id_t page_id_temp;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+
+  // Scenario: Only the accesses made while tracing are recorded, in order.
+  bpm->StartAccessTrace();
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  ASSERT_NE(nullptr, bpm->FetchPage(0, AccessType::Get));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+  ASSERT_NE(nullptr, bpm->FetchPage(1, AccessType::Scan));
+  EXPECT_EQ(true, bpm->UnpinPage(1, false));
+  auto trace = bpm->StopAccessTrace();
+  ASSERT_NE(nullptr, bpm->FetchPage(0));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+
+  ASSERT_EQ(3, trace.size());
+  EXPECT_EQ(1, trace[0].page_id_);
+  EXPECT_EQ(AccessType::Unknown, trace[0].access_type_);
+  EXPECT_EQ(0, trace[1].page_id_);
+  EXPECT_EQ(AccessType::Get, trace[1].access_type_);
+  EXPECT_EQ(1, trace[2].page_id_);
+  EXPECT_EQ(AccessType::Scan, trace[2].access_type_);
+  EXPECT_TRUE(bpm->StopAccessTrace().empty());
+
+  // Scenario: A trace survives a round trip through its text format.
+  std::stringstream text;
+  WriteAccessTrace(text, trace);
+  auto reloaded = ReadAccessTrace(text);
+  ASSERT_EQ(trace.size(), reloaded.size());
+  for (size_t i = 0; i < trace.size(); ++i) {
+    EXPECT_EQ(trace[i].page_id_, reloaded[i].page_id_);
+    EXPECT_EQ(trace[i].access_type_, reloaded[i].access_type_);
+  }
+  std::stringstream malformed("# comment\n\n3 get\n4 write\n");
+  EXPECT_THROW(ReadAccessTrace(malformed), Exception);
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ResizeTest) {
+  const size_t buffer_pool_size = 10;
+  const size_t k = 2;
+
+  for (auto allocation : {FrameAllocation::PerPage, FrameAllocation::Arena}) {
+    auto old_allocation = frame_allocation;
+    frame_allocation = allocation;
+    auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k, nullptr, 2);
+    frame_allocation = old_allocation;
+    EXPECT_EQ(buffer_pool_size * BUFFER_POOL_MAX_GROWTH, bpm->GetMaxPoolSize());
+
+    page_id_t page_id_temp;
+    for (size_t i = 0; i < buffer_pool_size; ++i) {
+      auto *page = bpm->NewPage(&page_id_temp);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+      EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+    }
+
+    // Scenario: Growing keeps the cached pages and adds free frames, so new pages evict nothing.
+    ASSERT_TRUE(bpm->ResizePool(buffer_pool_size * 2));
+    EXPECT_EQ(buffer_pool_size * 2, bpm->GetPoolSize());
+    for (size_t i = 0; i < buffer_pool_size; ++i) {
+      auto *page = bpm->NewPage(&page_id_temp);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+      EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+    }
+    for (page_id_t pid = 0; pid < static_cast<page_id_t>(buffer_pool_size * 2); ++pid) {
+      auto *page = bpm->FetchPage(pid);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(std::string("page ") + std::to_string(pid), page->GetData());
+      EXPECT_EQ(true, bpm->UnpinPage(pid, false));
+    }
+    EXPECT_EQ(0, bpm->GetStats().evictions_);
+    EXPECT_EQ(buffer_pool_size * 2, bpm->GetFetchHits(AccessType::Unknown));
+
+    // Scenario: A pinned frame cannot be released, shrinking stops above it.
+    page_id_t pinned_page_id = INVALID_PAGE_ID;
+    for (page_id_t pid = 0; pid < static_cast<page_id_t>(buffer_pool_size * 2); ++pid) {
+      auto *page = bpm->FetchPage(pid);
+      ASSERT_NE(nullptr, page);
+      if (page - bpm->GetPages() == static_cast<std::ptrdiff_t>(buffer_pool_size)) {
+        pinned_page_id = pid;
+        break;
+      }
+      EXPECT_EQ(true, bpm->UnpinPage(pid, false));
+    }
+    ASSERT_NE(INVALID_PAGE_ID, pinned_page_id);
+    EXPECT_FALSE(bpm->ResizePool(buffer_pool_size / 2, std::chrono::milliseconds(0)));
+    EXPECT_EQ(buffer_pool_size + 1, bpm->GetPoolSize());
+
+    // Scenario: Once unpinned, the frames are released and the dirty pages they held survive on disk.
+    EXPECT_EQ(true, bpm->UnpinPage(pinned_page_id, false));
+    ASSERT_TRUE(bpm->ResizePool(buffer_pool_size / 2));
+    EXPECT_EQ(buffer_pool_size / 2, bpm->GetPoolSize());
+    for (page_id_t pid = 0; pid < static_cast<page_id_t>(buffer_pool_size * 2); ++pid) {
+      auto *page = bpm->FetchPage(pid);
+      ASSERT_NE(nullptr, page);
+      EXPECT_LT(page - bpm->GetPages(), static_cast<std::ptrdiff_t>(buffer_pool_size / 2));
+      EXPECT_EQ(std::string("page ") + std::to_string(pid), page->GetData());
+      EXPECT_EQ(true, bpm->UnpinPage(pid, false));
+    }
+    std::vector<page_id_t> pinned;
+    for (size_t i = 0; i < buffer_pool_size / 2; ++i) {
+      ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+      pinned.push_back(page_id_temp);
+    }
+    EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+    for (auto pid : pinned) {
+      EXPECT_EQ(true, bpm->UnpinPage(pid, false));
+    }
+
+    // Scenario: Released frames can be grown into again.
+    ASSERT_TRUE(bpm->ResizePool(buffer_pool_size));
+    for (size_t i = 0; i < buffer_pool_size; ++i) {
+      ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ConcurrentResizeTest) {
+  const size_t buffer_pool_size = 16;
+  const size_t k = 2;
+  const page_id_t num_pages = 64;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k, nullptr, 2);
+  page_id_t page_id_temp;
+  for (page_id_t pid = 0; pid < num_pages; ++pid) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: Readers keep fetching pages while the pool shrinks and grows under them.
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> threads;
+  for (size_t thread_id = 0; thread_id < 4; ++thread_id) {
+    threads.emplace_back([&, thread_id] {
+      std::mt19937 gen(thread_id);
+      std::uniform_int_distribution<page_id_t> dist(0, num_pages - 1);
+      while (!stop) {
+        page_id_t pid = dist(gen);
+        auto *page = bpm->FetchPage(pid);
+        if (page == nullptr) {
+          continue;
+        }
+        EXPECT_EQ(std::string("page ") + std::to_string(pid), page->GetData());
+        bpm->UnpinPage(pid, false);
+      }
+    });
+  }
+  for (size_t size : {8, 32, 4, 64, 16}) {
+    EXPECT_TRUE(bpm->ResizePool(size));
+    EXPECT_EQ(size, bpm->GetPoolSize());
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  stop = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, WarmStartTest) {
+  const size_t buffer_pool_size = 8;
+  const size_t num_pages = 32;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  std::vector<page_id_t> hot_page_ids;
+  {
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size * 2, disk_manager.get(), k, nullptr, 2);
+    page_id_t page_id_temp;
+    for (size_t i = 0; i < num_pages; ++i) {
+      auto *page = bpm->NewPage(&page_id_temp);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+      EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+    }
+    // Every third page is hot, the last few pages are cached but were only touched once.
+    for (page_id_t pid = 0; pid < static_cast<page_id_t>(num_pages); pid += 3) {
+      hot_page_ids.push_back(pid);
+    }
+    for (int round = 0; round < 3; ++round) {
+      for (auto pid : hot_page_ids) {
+        ASSERT_NE(nullptr, bpm->FetchPage(pid));
+        EXPECT_EQ(true, bpm->UnpinPage(pid, false));
+      }
+    }
+    bpm->FlushAllPages();
+    bpm->SaveWarmManifest();
+  }
+  auto manifest = disk_manager->ReadWarmManifest();
+  ASSERT_EQ(buffer_pool_size * 2, manifest.size());
+
+  // Scenario: A smaller pool only loads the hottest pages of the manifest, and fetching them hits.
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k, nullptr, 2);
+  EXPECT_EQ(buffer_pool_size, bpm->StartWarmLoad());
+  bpm->WaitWarmLoad();
+  EXPECT_EQ(buffer_pool_size, bpm->GetStats().warm_loaded_pages_);
+  std::vector<page_id_t> warm_page_ids(manifest.begin(), manifest.begin() + buffer_pool_size);
+  for (auto pid : warm_page_ids) {
+    EXPECT_NE(hot_page_ids.end(), std::find(hot_page_ids.begin(), hot_page_ids.end(), pid));
+    auto *page = bpm->FetchPage(pid);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(std::string("page ") + std::to_string(pid), page->GetData());
+    EXPECT_EQ(true, bpm->UnpinPage(pid, false));
+  }
+  EXPECT_EQ(buffer_pool_size, bpm->GetFetchHits(AccessType::Unknown));
+  EXPECT_EQ(0, bpm->GetFetchMisses(AccessType::Unknown));
+
+  // Scenario: Warm loading never evicts, so a full pool loads nothing.
+  EXPECT_EQ(0, bpm->StartWarmLoad());
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, CoalescedFlushTest) {
+  const size_t buffer_pool_size = 16;
+  const size_t k = 2;
+  const std::string db_name = "test.db";
+  remove(db_name.c_str());
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  {
+    // Consecutive pages are spread over the partitions, the runs are found across all of them.
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k, nullptr, 4);
+    page_id_t page_id_temp;
+    for (size_t i = 0; i < buffer_pool_size; ++i) {
+      auto *page = bpm->NewPage(&page_id_temp);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+      EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+    }
+
+    // Scenario: The 16 cached pages are consecutive, one vectored write saves 15 system calls.
+    bpm->FlushAllPages();
+    EXPECT_EQ(buffer_pool_size, disk_manager->GetNumWrites());
+    EXPECT_EQ(buffer_pool_size - 1, disk_manager->GetNumWritesSaved());
+
+    // Scenario: With a gap in the middle, the pages are written in two runs.
+    bpm->DeletePage(7);
+    bpm->FlushAllPages();
+    EXPECT_EQ(buffer_pool_size * 2 - 1, disk_manager->GetNumWrites());
+    EXPECT_EQ(buffer_pool_size - 1 + buffer_pool_size - 3, disk_manager->GetNumWritesSaved());
+  }
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k);
+  for (page_id_t pid = 0; pid < static_cast<page_id_t>(buffer_pool_size); ++pid) {
+    auto *page = bpm->FetchPage(pid);
+    ASSERT_NE(nullptr, page);
+    if (pid != 7) {
+      EXPECT_EQ(std::string("page ") + std::to_string(pid), page->GetData());
+    }
+    EXPECT_EQ(true, bpm->UnpinPage(pid, false));
+  }
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ExtentTest) {
+  const size_t buffer_pool_size = 4;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k);
+  ExtentAllocator heap(8);
+  ExtentAllocator index(8);
+
+  // Scenario: Two structures growing at the same time each get consecutive pages.
+  std::vector<page_id_t> heap_pages;
+  std::vector<page_id_t> index_pages;
+  for (int i = 0; i < 8; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id, &heap));
+    heap_pages.push_back(page_id);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id, &index));
+    index_pages.push_back(page_id);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+  }
+  for (int i = 1; i < 8; i++) {
+    EXPECT_EQ(heap_pages[i - 1] + 1, heap_pages[i]);
+    EXPECT_EQ(index_pages[i - 1] + 1, index_pages[i]);
+  }
+
+  // Scenario: A page that gets no frame goes back to the extent, the next one takes its place.
+  page_id_t page_id;
+  std::vector<page_id_t> pinned;
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id, &heap));
+    pinned.push_back(page_id);
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id, &heap));
+  EXPECT_EQ(true, bpm->UnpinPage(pinned.back(), true));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id, &heap));
+  EXPECT_EQ(pinned.back() + 1, page_id);
+  EXPECT_EQ(2, heap.GetNumExtents());
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, TablespaceTest) {
+  const size_t buffer_pool_size = 4;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k);
+  tablespace_id_t tablespace = bpm->CreateTablespace("");
+  ExtentAllocator extent(EXTENT_SIZE, tablespace);
+
+  // Scenario: Pages allocated from a tablespace extent belong to the tablespace and survive eviction.
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < buffer_pool_size * 2; i++) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id, &extent);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(tablespace, DiskManager::GetTablespaceId(page_id));
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %zu", i);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+    page_ids.push_back(page_id);
+  }
+  {
+    auto guard = bpm->FetchPageRead(page_ids[0]);
+    EXPECT_STREQ("page 0", guard.GetData());
+  }
+
+  // Scenario: A tablespace with a pinned page cannot be dropped.
+  auto *pinned = bpm->FetchPage(page_ids.back());
+  ASSERT_NE(nullptr, pinned);
+  EXPECT_FALSE(bpm->DropTablespace(tablespace));
+  EXPECT_EQ(true, bpm->UnpinPage(page_ids.back(), false));
+
+  // Scenario: Dropping it discards its cached pages, so every frame is free again.
+  EXPECT_TRUE(bpm->DropTablespace(tablespace));
+  EXPECT_FALSE(bpm->DropTablespace(tablespace));
+  std::vector<page_id_t> new_page_ids;
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_EQ(DEFAULT_TABLESPACE, DiskManager::GetTablespaceId(page_id));
+    new_page_ids.push_back(page_id);
+  }
+  for (auto page_id : new_page_ids) {
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+}
+
 // NOLINTNEXTLINE
 TEST(BufferPoolManagerTest, DISABLED_SampleTest) {
   const std::string db_name = "test.db";
@@ -19,7 +19,7 @@
 
 namespace bustub {
 
-TEST(ClockReplacerTest, DISABLED_SampleTest) {
+TEST(ClockReplacerTest, SampleTest) {
   ClockReplacer clock_replacer(7);
 
   // Scenario: unpin six elements, i.e. add them to the replacer.
@@ -59,4 +59,37 @@ TEST(ClockReplacerTest, DISABLED_SampleTest) {
   EXPECT_EQ(4, value);
 }
 
+TEST(ClockReplacerTest, FrameReplacerTest) {
+  ClockReplacer clock_replacer(4);
+  FrameReplacer &replacer = clock_replacer;
+
+  // Scenario: frames 0 and 1 are accessed by gets, 2 and 3 only by a scan.
+  replacer.RecordAccess(0, AccessType::Get);
+  replacer.RecordAccess(1, AccessType::Get);
+  replacer.RecordAccess(2, AccessType::Scan);
+  replacer.RecordAccess(3, AccessType::Scan);
+  for (frame_id_t frame_id = 0; frame_id < 4; ++frame_id) {
+    replacer.SetEvictable(frame_id, true);
+  }
+  ASSERT_EQ(4, replacer.Size());
+
+  // Scenario: scanned frames get no second chance, so they are the first candidates.
+  EXPECT_EQ((std::vector<frame_id_t>{2, 3, 0, 1}), replacer.EvictionCandidates(4));
+
+  // Scenario: pinned frames are skipped by the hand.
+  replacer.SetEvictable(2, false);
+  int value;
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(3, value);
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(0, value);
+  EXPECT_EQ(1, replacer.Size());
+
+  // Scenario: removing a frame forgets it, untracked frames cannot become evictable.
+  replacer.Remove(1);
+  replacer.SetEvictable(1, true);
+  EXPECT_EQ(0, replacer.Size());
+  EXPECT_FALSE(replacer.Evict(&value));
+}
+
 }  // namespace bustub
@@ -93,4 +93,71 @@ TEST(LRUKReplacerTest, SampleTest) {
   ASSERT_EQ(false, lru_replacer.Evict(&value));
   ASSERT_EQ(0, lru_replacer.Size());
 }
+TEST(LRUKReplacerTest, RandomizedTest) {
+  const size_t num_frames = 64;
+  const size_t k = 3;
+  LRUKReplacer lru_replacer(num_frames, k);
+
+  // Brute-force model: full access histories, evict the maximum backward k-distance by a linear scan.
+  std::vector<std::vector<size_t>> history(num_frames);
+  std::vector<bool> evictable(num_frames, false);
+  size_t now = 0;
+  auto model_victims = [&]() {
+    std::vector<std::pair<std::pair<bool, size_t>, frame_id_t>> order;
+    for (size_t fid = 0; fid < num_frames; ++fid) {
+      if (evictable[fid]) {
+        // +inf distance first, ordered by first access, then by the k-th most recent access.
+        bool finite = history[fid].size() >= k;
+        size_t key = finite ? history[fid][history[fid].size() - k] : history[fid].front();
+        order.push_back({{finite, key}, static_cast<frame_id_t>(fid)});
+      }
+    }
+    std::sort(order.begin(), order.end());
+    std::vector<frame_id_t> victims;
+    for (auto &entry : order) {
+      victims.push_back(entry.second);
+    }
+    return victims;
+  };
+
+  std::mt19937 gen(15445);
+  std::uniform_int_distribution<frame_id_t> frame_dist(0, num_frames - 1);
+  std::uniform_int_distribution<int> op_dist(0, 9);
+  for (int i = 0; i < 20000; ++i) {
+    frame_id_t fid = frame_dist(gen);
+    int op = op_dist(gen);
+    if (op < 5) {
+      lru_replacer.RecordAccess(fid);
+      history[fid].push_back(now++);
+    } else if (op < 8) {
+      bool set_evictable = op < 7;
+      lru_replacer.SetEvictable(fid, set_evictable);
+      if (!history[fid].empty()) {
+        evictable[fid] = set_evictable;
+      }
+    } else if (op < 9) {
+      if (evictable[fid]) {
+        lru_replacer.Remove(fid);
+        history[fid].clear();
+        evictable[fid] = false;
+      }
+    } else {
+      auto victims = model_victims();
+      ASSERT_EQ(victims.size(), lru_replacer.Size());
+      auto num_candidates = std::min<size_t>(victims.size(), 4);
+      ASSERT_EQ(std::vector<frame_id_t>(victims.begin(), victims.begin() + num_candidates),
+                lru_replacer.EvictionCandidates(4));
+      frame_id_t victim;
+      if (victims.empty()) {
+        ASSERT_FALSE(lru_replacer.Evict(&victim));
+      } else {
+        ASSERT_TRUE(lru_replacer.Evict(&victim));
+        ASSERT_EQ(victims.front(), victim);
+        history[victim].clear();
+        evictable[victim] = false;
+      }
+    }
+  }
+}
+
 }  // namespace bustub
@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer_test.cpp
+//
+// Identification: test/buffer/two_queue_replacer_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/two_queue_replacer.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(TwoQueueReplacerTest, SampleTest) {
+  // A1in may hold 4 frames, A1out remembers 8 pages.
+  TwoQueueReplacer replacer(16);
+
+  // Scenario: load pages 0..7 into frames 0..7. Frame 0 is accessed twice, which is a correlated reference.
+  for (frame_id_t frame_id = 0; frame_id < 8; ++frame_id) {
+    replacer.RecordAccess(frame_id, AccessType::Get, frame_id);
+    replacer.SetEvictable(frame_id, true);
+  }
+  replacer.RecordAccess(0, AccessType::Get, 0);
+  ASSERT_EQ(8, replacer.Size());
+
+  // Scenario: A1in is over its share, so it is evicted in FIFO order. Pages 0..3 move to A1out.
+  int value;
+  for (frame_id_t frame_id = 0; frame_id < 4; ++frame_id) {
+    ASSERT_TRUE(replacer.Evict(&value));
+    EXPECT_EQ(frame_id, value);
+  }
+  ASSERT_EQ(4, replacer.Size());
+
+  // Scenario: page 0 comes back with a get and goes to Am. Page 1 comes back with a scan and stays on probation.
+  replacer.RecordAccess(0, AccessType::Get, 0);
+  replacer.SetEvictable(0, true);
+  replacer.RecordAccess(1, AccessType::Scan, 1);
+  replacer.SetEvictable(1, true);
+
+  // Scenario: A1in holds 5 frames, its oldest goes first. Then A1in is within its share and Am is evicted from.
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(4, value);
+  EXPECT_EQ((std::vector<frame_id_t>{0, 5, 6, 7, 1}), replacer.EvictionCandidates(8));
+
+  // Scenario: pinned and removed frames are never evicted.
+  replacer.SetEvictable(0, false);
+  replacer.Remove(5);
+  ASSERT_EQ(3, replacer.Size());
+  for (frame_id_t expected : {6, 7, 1}) {
+    ASSERT_TRUE(replacer.Evict(&value));
+    EXPECT_EQ(expected, value);
+  }
+  EXPECT_FALSE(replacer.Evict(&value));
+  replacer.SetEvictable(0, true);
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(0, value);
+}
+
+}  // namespace bustub
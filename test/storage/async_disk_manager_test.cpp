@@ -0,0 +1,190 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// async_disk_manager_test.cpp
+//
+// Identification: test/storage/async_disk_manager_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <future>  // NOLINT
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/disk/async_disk_manager.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+class AsyncDiskManagerTest : public ::testing::TestWithParam<bool> {
+ protected:
+  // This function is called before every test.
+  void SetUp() override {
+    remove("test.db");
+    remove("test.log");
+    remove("test_ts.db");
+  }
+
+  // This function is called after every test.
+  void TearDown() override {
+    remove("test.db");
+    remove("test.log");
+    remove("test_ts.db");
+  };
+};
+
+/** @brief Write `num_pages` pages through an async disk manager, then read them back both ways. */
+static void ReadWritePages(DiskManager *disk_manager, AsyncDiskManager *async_disk_manager, int num_pages) {
+  std::vector<std::vector<char>> pages(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<std::future<bool>> writes;
+  for (int i = 0; i < num_pages; ++i) {
+    snprintf(pages[i].data(), BUSTUB_PAGE_SIZE, "page %d", i);
+    writes.push_back(async_disk_manager->WritePage(i, pages[i].data()));
+  }
+  for (auto &write : writes) {
+    EXPECT_TRUE(write.get());
+  }
+
+  std::vector<std::vector<char>> buffers(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE, 'x'));
+  std::vector<std::future<bool>> reads;
+  for (int i = 0; i < num_pages; ++i) {
+    reads.push_back(async_disk_manager->ReadPage(i, buffers[i].data()));
+  }
+  for (int i = 0; i < num_pages; ++i) {
+    EXPECT_TRUE(reads[i].get());
+    EXPECT_EQ(0, std::memcmp(pages[i].data(), buffers[i].data(), BUSTUB_PAGE_SIZE));
+  }
+
+  // The pages written asynchronously are visible to the synchronous path.
+  char buf[BUSTUB_PAGE_SIZE];
+  disk_manager->ReadPage(num_pages - 1, buf);
+  EXPECT_EQ(0, std::memcmp(pages[num_pages - 1].data(), buf, BUSTUB_PAGE_SIZE));
+}
+
+// NOLINTNEXTLINE
+TEST_P(AsyncDiskManagerTest, ReadWritePageTest) {
+  DiskManager dm("test.db");
+  {
+    // More pages than the queue depth, so that submitting has to wait for completions.
+    AsyncDiskManager async_dm(&dm, 4, GetParam());
+    EXPECT_EQ(4, async_dm.GetQueueDepth());
+    ReadWritePages(&dm, &async_dm, 64);
+
+    // A page beyond the end of the file reads as zeros.
+    char buf[BUSTUB_PAGE_SIZE];
+    std::memset(buf, 'x', sizeof(buf));
+    EXPECT_TRUE(async_dm.ReadPage(1000, buf).get());
+    char zeros[BUSTUB_PAGE_SIZE] = {0};
+    EXPECT_EQ(0, std::memcmp(zeros, buf, BUSTUB_PAGE_SIZE));
+  }
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_P(AsyncDiskManagerTest, CallbackTest) {
+  DiskManager dm("test.db");
+  std::atomic<int> completed{0};
+  {
+    AsyncDiskManager async_dm(&dm, 8, GetParam());
+    char data[BUSTUB_PAGE_SIZE] = {0};
+    std::strncpy(data, "A test string.", sizeof(data));
+    for (int i = 0; i < 16; ++i) {
+      async_dm.WritePage(i, data, [&](bool success) {
+        EXPECT_TRUE(success);
+        completed++;
+      });
+    }
+    // Destroying the async disk manager waits for the requests in flight.
+  }
+  EXPECT_EQ(16, completed);
+  char buf[BUSTUB_PAGE_SIZE];
+  dm.ReadPage(15, buf);
+  EXPECT_STREQ("A test string.", buf);
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_P(AsyncDiskManagerTest, WritePagesTest) {
+  const size_t num_pages = WRITE_RUN_MAX_PAGES + 8;
+  std::vector<std::vector<char>> pages(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<const char *> pages_data;
+  for (size_t i = 0; i < num_pages; i++) {
+    snprintf(pages[i].data(), BUSTUB_PAGE_SIZE, "page %zu", i);
+    pages_data.push_back(pages[i].data());
+  }
+  DiskManager dm("test.db");
+  {
+    // Two runs: a full one and the rest.
+    AsyncDiskManager async_dm(&dm, 4, GetParam());
+    EXPECT_TRUE(async_dm.WritePages(0, pages_data).get());
+    EXPECT_TRUE(async_dm.WritePages(0, {}).get());
+  }
+  EXPECT_EQ(num_pages, dm.GetNumWrites());
+  EXPECT_EQ(num_pages - 2, dm.GetNumWritesSaved());
+  char buf[BUSTUB_PAGE_SIZE];
+  for (size_t i = 0; i < num_pages; i++) {
+    dm.ReadPage(i, buf);
+    EXPECT_STREQ(pages[i].data(), buf);
+  }
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_P(AsyncDiskManagerTest, FailureTest) {
+  DiskManager dm("test.db");
+  AsyncDiskManager async_dm(&dm, 4, GetParam());
+  char page[BUSTUB_PAGE_SIZE] = "page 0";
+  char buf[BUSTUB_PAGE_SIZE];
+  EXPECT_TRUE(async_dm.WritePage(0, page).get());
+
+  // Both backends report failed I/O: with the database file closed, every request fails.
+  dm.ShutDown();
+  EXPECT_FALSE(async_dm.ReadPage(0, buf).get());
+  EXPECT_FALSE(async_dm.WritePage(0, page).get());
+  EXPECT_FALSE(async_dm.WritePages(0, {page, page}).get());
+  EXPECT_FALSE(dm.ReadPage(0, buf));
+}
+
+// NOLINTNEXTLINE
+TEST_P(AsyncDiskManagerTest, TablespaceTest) {
+  DiskManager dm("test.db");
+  tablespace_id_t tablespace = dm.CreateTablespace("test_ts.db");
+  AsyncDiskManager async_dm(&dm, 4, GetParam());
+  char page[BUSTUB_PAGE_SIZE] = "tablespace page";
+  char buf[BUSTUB_PAGE_SIZE];
+  page_id_t page_id = dm.AllocateExtent(2, tablespace);
+
+  // Requests go to the file of the page's tablespace.
+  EXPECT_TRUE(async_dm.WritePages(page_id, {page, page}).get());
+  EXPECT_TRUE(async_dm.ReadPage(page_id + 1, buf).get());
+  EXPECT_STREQ("tablespace page", buf);
+  EXPECT_TRUE(dm.ReadPage(page_id, buf));
+  EXPECT_STREQ("tablespace page", buf);
+  EXPECT_TRUE(dm.ReadPage(DiskManager::GetLocalPageId(page_id), buf));
+  EXPECT_STREQ("", buf);
+
+  // Requests for a dropped tablespace fail.
+  EXPECT_TRUE(dm.DropTablespace(tablespace));
+  EXPECT_FALSE(async_dm.ReadPage(page_id, buf).get());
+  EXPECT_FALSE(async_dm.WritePage(page_id, page).get());
+}
+
+INSTANTIATE_TEST_SUITE_P(IoUringOrWorkers, AsyncDiskManagerTest, ::testing::Bool());
+
+// NOLINTNEXTLINE
+TEST(AsyncDiskManagerMemoryTest, WorkerFallbackTest) {
+  // A disk manager without a database file is always served by the worker threads.
+  DiskManagerUnlimitedMemory dm;
+  AsyncDiskManager async_dm(&dm);
+  EXPECT_FALSE(async_dm.UsesIoUring());
+  ReadWritePages(&dm, &async_dm, 64);
+}
+
+}  // namespace bustub
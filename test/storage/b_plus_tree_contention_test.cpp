@@ -7,6 +7,7 @@
 #include <functional>
 #include <future>  // NOLINT
 #include <iostream>
+#include <memory>
 #include <thread>  // NOLINT
 
 #include "buffer/buffer_pool_manager.h"
@@ -24,8 +25,9 @@ bool BPlusTreeLockBenchmarkCall(size_t num_threads, int leaf_node_size, bool wit
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
-  auto *disk_manager = new DiskManagerMemory(256 << 10);  // 1GB
-  auto *bpm = new BufferPoolManager(64, disk_manager);
+  // The tree gives its unused pages back to the disk manager when it is destroyed.
+  auto disk_manager = std::make_unique<DiskManagerMemory>((1 << 30) / BUSTUB_PAGE_SIZE);  // 1GB
+  auto *bpm = new BufferPoolManager(64, disk_manager.get());
 
   // create and fetch header_page
   page_id_t page_id;
@@ -70,7 +72,6 @@ bool BPlusTreeLockBenchmarkCall(size_t num_threads, int leaf_node_size, bool wit
   }
 
   bpm->UnpinPage(HEADER_PAGE_ID, true);
-  delete disk_manager;
   delete bpm;
 
   return success;
@@ -168,4 +169,57 @@ TEST(BPlusTreeContentionTest, BPlusTreeContentionBenchmark2) {  // NOLINT
             << std::endl;
 }
 
+TEST(BPlusTreeContentionTest, BPlusTreeReadScalingBenchmark) {  // NOLINT
+  std::cout << "This test will see how point lookup throughput scales with the number of reader threads." << std::endl;
+
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto disk_manager = std::make_unique<DiskManagerMemory>((1 << 30) / BUSTUB_PAGE_SIZE);  // 1GB
+  auto *bpm = new BufferPoolManager(256, disk_manager.get());
+  bpm->SetSwizzleFraction(0.25);
+
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm, comparator, 10, 10);
+
+  const int64_t num_keys = 2000;
+  GenericKey<8> index_key;
+  RID rid;
+  for (int64_t key = 0; key < num_keys; key++) {
+    rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid);
+  }
+
+  const int64_t lookups_per_thread = 20000;
+  std::cout << "<<< BEGIN3" << std::endl;
+  for (size_t num_threads = 1; num_threads <= 8; num_threads *= 2) {
+    std::vector<std::thread> threads;
+    auto clock_start = std::chrono::system_clock::now();
+    for (size_t i = 0; i < num_threads; i++) {
+      threads.emplace_back([&tree, i, num_keys, lookups_per_thread]() {
+        GenericKey<8> index_key;
+        std::vector<RID> result;
+        for (int64_t n = 0; n < lookups_per_thread; n++) {
+          index_key.SetFromInteger((n * 7919 + static_cast<int64_t>(i) * 104729) % num_keys);
+          result.clear();
+          ASSERT_TRUE(tree.GetValue(index_key, &result));
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    auto clock_end = std::chrono::system_clock::now();
+    auto dur = std::chrono::duration_cast<std::chrono::milliseconds>(clock_end - clock_start);
+    std::cout << num_threads << " threads: " << num_threads * lookups_per_thread * 1000 / std::max<int64_t>(dur.count(), 1)
+              << " lookups/s" << std::endl;
+  }
+  std::cout << ">>> END3" << std::endl;
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
 }  // namespace bustub
@@ -186,4 +186,107 @@ TEST(BPlusTreeTests, InsertTest3) {
   delete transaction;
   delete bpm;
 }
+TEST(BPlusTreeTests, BatchedIteratorTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  ASSERT_EQ(page_id, HEADER_PAGE_ID);
+
+  // Small nodes, so that the leaves span several parents.
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", header_page->GetPageId(), bpm.get(), comparator, 3,
+                                                           4);
+  GenericKey<8> index_key;
+  RID rid;
+  const int64_t num_keys = 500;
+  for (int64_t key = num_keys - 1; key >= 0; key--) {
+    rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid);
+  }
+
+  // Scenario: Walking the leaves in batches visits every key once, in order, from any start key.
+  for (int64_t start_key : {int64_t{0}, int64_t{1}, int64_t{250}, num_keys - 1}) {
+    int64_t current_key = start_key;
+    index_key.SetFromInteger(start_key);
+    for (auto iterator = tree.Begin(index_key); !iterator.IsEnd(); ++iterator) {
+      EXPECT_EQ(current_key, (*iterator).second.GetSlotNum());
+      current_key++;
+    }
+    EXPECT_EQ(num_keys, current_key);
+  }
+
+  // Scenario: Once the iterators are gone, no leaf stays pinned, so every frame can be taken by new pages.
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 1; i < bpm->GetPoolSize(); i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    page_ids.push_back(page_id);
+  }
+  for (auto new_page_id : page_ids) {
+    bpm->UnpinPage(new_page_id, false);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+}
+
+TEST(BPlusTreeTests, SwizzledLookupTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  bpm->SetSwizzleFraction(0.25);
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", header_page->GetPageId(), bpm.get(), comparator, 3,
+                                                           4);
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  GenericKey<8> index_key;
+  RID rid;
+  auto *transaction = new Transaction(0);
+
+  const int64_t num_keys = 200;
+  for (int64_t key = 0; key < num_keys; key++) {
+    rid.Set(static_cast<int32_t>(key >> 32), static_cast<int>(key & 0xFFFFFFFF));
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.Insert(index_key, rid, transaction));
+  }
+
+  // Lookups stay correct while the header and internal pages get swizzled and cooled. The second round finds the
+  // upper levels swizzled, so most of its fetches bypass the page table.
+  std::vector<RID> rids;
+  uint64_t page_table_fetches = 0;
+  for (int round = 0; round < 2; round++) {
+    page_table_fetches = bpm->GetFetchHits(AccessType::Unknown) + bpm->GetFetchMisses(AccessType::Unknown);
+    for (int64_t key = 0; key < num_keys; key++) {
+      rids.clear();
+      index_key.SetFromInteger(key);
+      ASSERT_TRUE(tree.GetValue(index_key, &rids));
+      ASSERT_EQ(rids.size(), 1);
+      ASSERT_EQ(rids[0].GetSlotNum(), key & 0xFFFFFFFF);
+    }
+    page_table_fetches =
+        bpm->GetFetchHits(AccessType::Unknown) + bpm->GetFetchMisses(AccessType::Unknown) - page_table_fetches;
+  }
+  EXPECT_LT(page_table_fetches, num_keys * 3);
+
+  // Inserting through the regular path still works with swizzled pages in the pool.
+  for (int64_t key = num_keys; key < num_keys * 2; key++) {
+    rid.Set(static_cast<int32_t>(key >> 32), static_cast<int>(key & 0xFFFFFFFF));
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.Insert(index_key, rid, transaction));
+    rids.clear();
+    ASSERT_TRUE(tree.GetValue(index_key, &rids));
+    ASSERT_EQ(rids[0].GetSlotNum(), key & 0xFFFFFFFF);
+  }
+  delete transaction;
+}
+
 }  // namespace bustub
@@ -0,0 +1,200 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_disk_manager_test.cpp
+//
+// Identification: test/storage/compressed_disk_manager_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/exception.h"
+#include "gtest/gtest.h"
+#include "storage/disk/compressed_disk_manager.h"
+#include "storage/disk/page_codec.h"
+
+namespace bustub {
+
+class CompressedDiskManagerTest : public ::testing::Test {
+ protected:
+  // This function is called before every test.
+  void SetUp() override {
+    remove("test.db");
+    remove("test.log");
+    remove("test_ts.db");
+  }
+
+  // This function is called after every test.
+  void TearDown() override {
+    remove("test.db");
+    remove("test.log");
+    remove("test_ts.db");
+  };
+};
+
+/** Fill a page with `count` random bytes, followed by zeros. */
+static void FillRandom(char *data, size_t count, std::mt19937 *rng) {
+  memset(data, 0, BUSTUB_PAGE_SIZE);
+  for (size_t i = 0; i < count; i++) {
+    data[i] = static_cast<char>((*rng)());
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(PageCodecTest, RoundTripTest) {
+  std::mt19937 rng(7);
+  char page[BUSTUB_PAGE_SIZE];
+  char compressed[2 * BUSTUB_PAGE_SIZE];
+  char decompressed[BUSTUB_PAGE_SIZE];
+
+  // Scenario: Zeros, repeated values and a partly random page compress and decompress to the same bytes.
+  for (size_t random_bytes : {0, 1, 17, 100, 1000, 3000}) {
+    FillRandom(page, random_bytes, &rng);
+    for (size_t i = random_bytes; i < BUSTUB_PAGE_SIZE; i += 64) {
+      std::snprintf(page + i, std::min<size_t>(64, BUSTUB_PAGE_SIZE - i), "tuple %zu, state=active", i % 512);
+    }
+    size_t size = PageCodec::Compress(page, BUSTUB_PAGE_SIZE, compressed, sizeof(compressed));
+    ASSERT_GT(size, 0);
+    EXPECT_LT(size, BUSTUB_PAGE_SIZE);
+    ASSERT_TRUE(PageCodec::Decompress(compressed, size, decompressed, BUSTUB_PAGE_SIZE));
+    EXPECT_EQ(0, memcmp(page, decompressed, BUSTUB_PAGE_SIZE));
+  }
+
+  // Scenario: Random data does not fit in less than its own size, but still round-trips with room to spare.
+  FillRandom(page, BUSTUB_PAGE_SIZE, &rng);
+  EXPECT_EQ(0, PageCodec::Compress(page, BUSTUB_PAGE_SIZE, compressed, BUSTUB_PAGE_SIZE - 1));
+  size_t size = PageCodec::Compress(page, BUSTUB_PAGE_SIZE, compressed, sizeof(compressed));
+  ASSERT_GT(size, 0);
+  ASSERT_TRUE(PageCodec::Decompress(compressed, size, decompressed, BUSTUB_PAGE_SIZE));
+  EXPECT_EQ(0, memcmp(page, decompressed, BUSTUB_PAGE_SIZE));
+
+  // Scenario: Truncated or mislabelled input is rejected rather than read out of bounds.
+  memset(page, 'x', BUSTUB_PAGE_SIZE);
+  size = PageCodec::Compress(page, BUSTUB_PAGE_SIZE, compressed, sizeof(compressed));
+  ASSERT_GT(size, 0);
+  EXPECT_FALSE(PageCodec::Decompress(compressed, size / 2, decompressed, BUSTUB_PAGE_SIZE));
+  EXPECT_FALSE(PageCodec::Decompress(compressed, size, decompressed, BUSTUB_PAGE_SIZE - 1));
+}
+
+// NOLINTNEXTLINE
+TEST_F(CompressedDiskManagerTest, ReadWritePageTest) {
+  std::mt19937 rng(42);
+  char buf[BUSTUB_PAGE_SIZE];
+  char data[BUSTUB_PAGE_SIZE];
+  std::string db_file("test.db");
+
+  CompressedDiskManager dm(db_file);
+  // Scenario: A page that was never written reads as zeros.
+  dm.ReadPage(0, buf);
+  EXPECT_EQ(BUSTUB_PAGE_SIZE, std::count(buf, buf + BUSTUB_PAGE_SIZE, 0));
+
+  // Scenario: A mostly empty page takes one slot unit, a random page is stored raw.
+  FillRandom(data, 100, &rng);
+  EXPECT_TRUE(dm.WritePage(0, data));
+  EXPECT_EQ(CompressedDiskManager::SLOT_UNIT, dm.GetNumSlotBytes());
+  EXPECT_TRUE(dm.ReadPage(0, buf));
+  EXPECT_EQ(0, memcmp(data, buf, BUSTUB_PAGE_SIZE));
+
+  FillRandom(data, BUSTUB_PAGE_SIZE, &rng);
+  EXPECT_TRUE(dm.WritePage(1, data));
+  EXPECT_TRUE(dm.ReadPage(1, buf));
+  EXPECT_EQ(0, memcmp(data, buf, BUSTUB_PAGE_SIZE));
+  EXPECT_GT(dm.GetNumSlotBytes(), BUSTUB_PAGE_SIZE);
+
+  // Scenario: Page 0 outgrows its slot and moves; its old slot is reused by the next page of that size.
+  FillRandom(data, 2000, &rng);
+  EXPECT_TRUE(dm.WritePage(0, data));
+  EXPECT_TRUE(dm.ReadPage(0, buf));
+  EXPECT_EQ(0, memcmp(data, buf, BUSTUB_PAGE_SIZE));
+  int file_size = std::max(0, static_cast<int>(std::ifstream(db_file, std::ios::binary | std::ios::ate).tellg()));
+  FillRandom(data, 10, &rng);
+  EXPECT_TRUE(dm.WritePage(2, data));
+  EXPECT_EQ(file_size, static_cast<int>(std::ifstream(db_file, std::ios::binary | std::ios::ate).tellg()));
+  EXPECT_TRUE(dm.ReadPage(2, buf));
+  EXPECT_EQ(0, memcmp(data, buf, BUSTUB_PAGE_SIZE));
+
+  EXPECT_LT(dm.GetNumBytesRead(), 3 * BUSTUB_PAGE_SIZE);
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(CompressedDiskManagerTest, ReopenTest) {
+  char buf[BUSTUB_PAGE_SIZE];
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  {
+    CompressedDiskManager dm(db_file);
+    for (int i = 0; i < 10; i++) {
+      page_id_t page_id = dm.AllocatePage();
+      EXPECT_EQ(i, page_id);
+      std::snprintf(data, sizeof(data), "page %d", page_id);
+      EXPECT_TRUE(dm.WritePage(page_id, data));
+    }
+    // Rewritten pages keep their newest contents, deallocated ones lose theirs.
+    std::snprintf(data, sizeof(data), "page 3, rewritten with a longer string");
+    EXPECT_TRUE(dm.WritePage(3, data));
+    dm.DeallocatePage(5);
+    dm.DeallocateExtent(7, 2);
+    dm.ShutDown();
+  }
+
+  // Scenario: The indirection map and the free pages are rebuilt from the slots of the file.
+  CompressedDiskManager dm(db_file);
+  EXPECT_EQ(10, dm.GetNextPageId());
+  EXPECT_EQ(3, dm.GetNumFreePages());
+  dm.ReadPage(2, buf);
+  EXPECT_STREQ("page 2", buf);
+  dm.ReadPage(3, buf);
+  EXPECT_STREQ("page 3, rewritten with a longer string", buf);
+  dm.ReadPage(5, buf);
+  EXPECT_STREQ("", buf);
+  EXPECT_EQ(5, dm.AllocatePage());
+  EXPECT_EQ(7, dm.AllocatePage());
+  dm.ShutDown();
+
+  // Scenario: A file of plain pages is refused.
+  remove(db_file.c_str());
+  { DiskManager plain(db_file); }
+  EXPECT_THROW(CompressedDiskManager{db_file}, Exception);
+}
+
+// NOLINTNEXTLINE
+TEST_F(CompressedDiskManagerTest, BufferPoolTest) {
+  std::string db_file("test.db");
+  const size_t num_pages = 64;
+  {
+    CompressedDiskManager dm(db_file);
+    auto ts = dm.CreateTablespace("test_ts.db");
+    BufferPoolManager bpm(8, &dm);
+    std::vector<page_id_t> page_ids;
+    // Scenario: Pages round-trip through a buffer pool much smaller than the data, in both tablespaces.
+    for (size_t i = 0; i < num_pages; i++) {
+      page_id_t page_id = i % 2 == 0 ? dm.AllocatePage() : dm.AllocatePage(ts);
+      auto guard = bpm.FetchPageWrite(page_id);
+      std::snprintf(guard.GetDataMut(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+      page_ids.push_back(page_id);
+    }
+    for (auto page_id : page_ids) {
+      auto guard = bpm.FetchPageRead(page_id);
+      EXPECT_EQ("page " + std::to_string(page_id), std::string(guard.GetData()));
+    }
+    bpm.FlushAllPages();
+    EXPECT_LT(dm.GetNumSlotBytes(), num_pages / 2 * BUSTUB_PAGE_SIZE / 4);
+    dm.ShutDown();
+  }
+  EXPECT_LT(std::ifstream("test_ts.db", std::ios::binary | std::ios::ate).tellg(),
+            num_pages / 2 * BUSTUB_PAGE_SIZE / 4);
+}
+
+}  // namespace bustub
@@ -10,11 +10,18 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
 #include <cstring>
+#include <fstream>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "common/exception.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/extent_allocator.h"
 
 namespace bustub {
 
@@ -24,12 +31,16 @@ class DiskManagerTest : public ::testing::Test {
   void SetUp() override {
     remove("test.db");
     remove("test.log");
+    remove("test.warm");
+    remove("test_ts.db");
   }
 
   // This function is called after every test.
   void TearDown() override {
     remove("test.db");
     remove("test.log");
+    remove("test.warm");
+    remove("test_ts.db");
   };
 };
 
@@ -72,6 +83,367 @@ TEST_F(DiskManagerTest, ReadWriteLogTest) {
   dm.ShutDown();
 }
 
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, ConcurrentReadWritePageTest) {
+  const int num_threads = 8;
+  const int pages_per_thread = 32;
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file);
+
+  // Every thread writes and reads back its own pages, interleaved with the others.
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&dm, tid]() {
+      char buf[BUSTUB_PAGE_SIZE];
+      char data[BUSTUB_PAGE_SIZE] = {0};
+      for (int i = 0; i < pages_per_thread; i++) {
+        page_id_t page_id = i * num_threads + tid;
+        std::snprintf(data, sizeof(data), "page %d", page_id);
+        dm.WritePage(page_id, data);
+        dm.ReadPage(page_id, buf);
+        EXPECT_STREQ(data, buf);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(num_threads * pages_per_thread, dm.GetNumWrites());
+
+  char buf[BUSTUB_PAGE_SIZE];
+  dm.ReadPage(num_threads * pages_per_thread - 1, buf);
+  EXPECT_STREQ("page 255", buf);
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, DirectIoTest) {
+  alignas(DIRECT_IO_ALIGNMENT) char aligned[BUSTUB_PAGE_SIZE] = {0};
+  char buf[BUSTUB_PAGE_SIZE + 1] = {0};
+  char *unaligned = buf + 1;
+  std::string db_file("test.db");
+  {
+    DiskManager dm(db_file, true);
+    for (page_id_t page_id = 0; page_id < 4; page_id++) {
+      EXPECT_EQ(page_id, dm.AllocatePage());
+    }
+    // Aligned buffers go straight to the file, unaligned ones are copied through an aligned buffer.
+    std::strncpy(aligned, "aligned", sizeof(aligned));
+    dm.WritePage(0, aligned);
+    std::strncpy(unaligned, "unaligned", BUSTUB_PAGE_SIZE);
+    dm.WritePage(1, unaligned);
+    dm.WritePage(3, unaligned);
+    dm.DeallocatePage(2);
+
+    dm.ReadPage(1, aligned);
+    EXPECT_STREQ("unaligned", aligned);
+    dm.ReadPage(0, unaligned);
+    EXPECT_STREQ("aligned", unaligned);
+    // Past the end of the file.
+    dm.ReadPage(10, aligned);
+    EXPECT_EQ(0, aligned[0]);
+    dm.ShutDown();
+  }
+
+  // Direct and buffered I/O share the file format.
+  DiskManager dm(db_file);
+  EXPECT_FALSE(dm.IsDirectIo());
+  EXPECT_EQ(1, dm.GetNumFreePages());
+  dm.ReadPage(1, aligned);
+  EXPECT_STREQ("unaligned", aligned);
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, WritePagesTest) {
+  const page_id_t first_page_id = DiskManager::PAGES_PER_FREE_MAP - 4;
+  const size_t num_pages = 8;
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  std::vector<std::vector<char>> pages(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<const char *> pages_data;
+  for (size_t i = 0; i < num_pages; i++) {
+    std::snprintf(pages[i].data(), BUSTUB_PAGE_SIZE, "page %zu", first_page_id + i);
+    pages_data.push_back(pages[i].data());
+  }
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file);
+
+  // The run is split at the bitmap page between its two halves.
+  dm.WritePages(first_page_id, pages_data);
+  EXPECT_EQ(num_pages, dm.GetNumWrites());
+  EXPECT_EQ(num_pages - 2, dm.GetNumWritesSaved());
+  for (size_t i = 0; i < num_pages; i++) {
+    dm.ReadPage(first_page_id + i, buf);
+    EXPECT_STREQ(pages[i].data(), buf);
+  }
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, FreePageMapTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  {
+    auto dm = DiskManager(db_file);
+    for (page_id_t page_id = 0; page_id < 10; page_id++) {
+      EXPECT_EQ(page_id, dm.AllocatePage());
+      std::snprintf(data, sizeof(data), "page %d", page_id);
+      dm.WritePage(page_id, data);
+    }
+    dm.DeallocatePage(5);
+    dm.DeallocatePage(3);
+    dm.DeallocatePage(3);  // deallocating twice is harmless
+    EXPECT_EQ(2, dm.GetNumFreePages());
+    // The lowest free pages are reused before the database grows.
+    EXPECT_EQ(3, dm.AllocatePage());
+    EXPECT_EQ(5, dm.AllocatePage());
+    EXPECT_EQ(10, dm.AllocatePage());
+    EXPECT_EQ(0, dm.GetNumFreePages());
+    dm.DeallocatePage(7);
+    dm.ShutDown();
+  }
+
+  // The free-page map survives a restart, and the bitmap pages do not shift the data pages.
+  auto dm = DiskManager(db_file);
+  EXPECT_EQ(10, dm.GetNextPageId());  // page 10 was never written
+  EXPECT_EQ(1, dm.GetNumFreePages());
+  for (page_id_t page_id : {0, 6, 9}) {
+    dm.ReadPage(page_id, buf);
+    std::snprintf(data, sizeof(data), "page %d", page_id);
+    EXPECT_STREQ(data, buf);
+  }
+  EXPECT_EQ(7, dm.AllocatePage());
+  EXPECT_EQ(10, dm.AllocatePage());
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, AllocateExtentTest) {
+  auto dm = DiskManager("test.db");
+  EXPECT_EQ(0, dm.AllocatePage());
+  EXPECT_EQ(1, dm.AllocateExtent(8));
+  EXPECT_EQ(9, dm.GetNextPageId());
+  for (page_id_t page_id : {2, 3, 5, 6, 7, 8}) {
+    dm.DeallocatePage(page_id);
+  }
+  // A run of free pages is reused once it is long enough, otherwise the database grows.
+  EXPECT_EQ(9, dm.AllocateExtent(5));
+  EXPECT_EQ(5, dm.AllocateExtent(4));
+  EXPECT_EQ(2, dm.GetNumFreePages());
+  EXPECT_EQ(2, dm.AllocatePage());
+
+  // Extents are handed out page by page, and a new one is reserved when the current one is used up.
+  ExtentAllocator table(4);
+  ExtentAllocator index(4);
+  std::vector<page_id_t> table_pages;
+  std::vector<page_id_t> index_pages;
+  for (int i = 0; i < 6; i++) {
+    table_pages.push_back(table.AllocatePage(&dm));
+    index_pages.push_back(index.AllocatePage(&dm));
+  }
+  EXPECT_EQ(std::vector<page_id_t>({14, 15, 16, 17, 22, 23}), table_pages);
+  EXPECT_EQ(std::vector<page_id_t>({18, 19, 20, 21, 26, 27}), index_pages);
+  EXPECT_EQ(2, table.GetNumExtents());
+
+  // An unused page goes back to the extent.
+  table.ReleasePage(&dm, 23);
+  EXPECT_EQ(23, table.AllocatePage(&dm));
+
+  // The pages of an extent that were never used are freed with the allocator.
+  EXPECT_EQ(1, dm.GetNumFreePages());
+  {
+    ExtentAllocator dropped(4);
+    EXPECT_EQ(30, dropped.AllocatePage(&dm));
+  }
+  EXPECT_EQ(4, dm.GetNumFreePages());
+  EXPECT_EQ(31, dm.AllocateExtent(3));
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, FreePageMapManyGroupsTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  // Pages on both sides of a bitmap page.
+  page_id_t last_page_id = DiskManager::PAGES_PER_FREE_MAP + 1;
+  {
+    auto dm = DiskManager(db_file);
+    for (page_id_t page_id = 0; page_id <= last_page_id; page_id++) {
+      dm.AllocatePage();
+    }
+    for (page_id_t page_id : {DiskManager::PAGES_PER_FREE_MAP - 1, DiskManager::PAGES_PER_FREE_MAP, last_page_id}) {
+      std::snprintf(data, sizeof(data), "page %d", page_id);
+      dm.WritePage(page_id, data);
+    }
+    dm.DeallocatePage(DiskManager::PAGES_PER_FREE_MAP);
+    dm.ShutDown();
+  }
+  auto dm = DiskManager(db_file);
+  EXPECT_EQ(last_page_id + 1, dm.GetNextPageId());
+  EXPECT_EQ(1, dm.GetNumFreePages());
+  for (page_id_t page_id : {DiskManager::PAGES_PER_FREE_MAP - 1, last_page_id}) {
+    dm.ReadPage(page_id, buf);
+    std::snprintf(data, sizeof(data), "page %d", page_id);
+    EXPECT_STREQ(data, buf);
+  }
+  EXPECT_EQ(DiskManager::PAGES_PER_FREE_MAP, dm.AllocatePage());
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, CompactTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file);
+  for (page_id_t page_id = 0; page_id < 20; page_id++) {
+    dm.AllocatePage();
+    std::snprintf(data, sizeof(data), "page %d", page_id);
+    dm.WritePage(page_id, data);
+  }
+  dm.DeallocatePage(4);
+  for (page_id_t page_id = 12; page_id < 20; page_id++) {
+    dm.DeallocatePage(page_id);
+  }
+  EXPECT_EQ(9, dm.GetNumFreePages());
+
+  // Only the trailing free pages are dropped; the header page, the bitmap page and pages 0 to 11 remain.
+  EXPECT_EQ(8, dm.Compact());
+  EXPECT_EQ(0, dm.Compact());
+  EXPECT_EQ(12, dm.GetNextPageId());
+  EXPECT_EQ(1, dm.GetNumFreePages());
+  struct stat stat_buf;
+  ASSERT_EQ(0, stat(db_file.c_str(), &stat_buf));
+  EXPECT_EQ(14 * BUSTUB_PAGE_SIZE, stat_buf.st_size);
+  dm.ReadPage(11, buf);
+  EXPECT_STREQ("page 11", buf);
+
+  EXPECT_EQ(4, dm.AllocatePage());
+  EXPECT_EQ(12, dm.AllocatePage());
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, WarmManifestTest) {
+  std::string db_file("test.db");
+  {
+    DiskManager dm(db_file);
+    EXPECT_TRUE(dm.ReadWarmManifest().empty());
+    dm.WriteWarmManifest({7, 3, 11, 0});
+    EXPECT_EQ(std::vector<page_id_t>({7, 3, 11, 0}), dm.ReadWarmManifest());
+    dm.ShutDown();
+  }
+
+  // The manifest outlives the disk manager, and a newer one replaces it.
+  DiskManager dm(db_file);
+  EXPECT_EQ(std::vector<page_id_t>({7, 3, 11, 0}), dm.ReadWarmManifest());
+  dm.WriteWarmManifest({5});
+  EXPECT_EQ(std::vector<page_id_t>({5}), dm.ReadWarmManifest());
+
+  // A truncated manifest is ignored.
+  truncate("test.warm", 10);
+  EXPECT_TRUE(dm.ReadWarmManifest().empty());
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, FileHeaderTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = "page 0";
+  std::string db_file("test.db");
+  {
+    auto dm = DiskManager(db_file);
+    dm.WritePage(dm.AllocatePage(), data);
+    dm.ShutDown();
+  }
+  // A file written by this version opens again.
+  {
+    auto dm = DiskManager(db_file);
+    EXPECT_EQ(1, dm.GetNextPageId());
+    dm.ReadPage(0, buf);
+    EXPECT_STREQ("page 0", buf);
+    dm.ShutDown();
+  }
+
+  // A file that starts with a data page, as written before the header existed, is refused rather than misread.
+  remove(db_file.c_str());
+  {
+    std::ofstream old_file(db_file, std::ios::binary);
+    old_file.write(data, BUSTUB_PAGE_SIZE);
+  }
+  EXPECT_THROW(DiskManager{db_file}, Exception);
+
+  // So is a file of another format version.
+  remove(db_file.c_str());
+  {
+    uint32_t header[4] = {0x42445442, 999, BUSTUB_PAGE_SIZE, DiskManager::PAGES_PER_FREE_MAP};
+    std::memcpy(buf, header, sizeof(header));
+    std::ofstream new_file(db_file, std::ios::binary);
+    new_file.write(buf, BUSTUB_PAGE_SIZE);
+  }
+  EXPECT_THROW(DiskManager{db_file}, Exception);
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, TablespaceTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = "tablespace page";
+  char main_data[BUSTUB_PAGE_SIZE] = "database page";
+  struct stat stat_buf;
+  {
+    auto dm = DiskManager("test.db");
+    tablespace_id_t tablespace = dm.CreateTablespace("test_ts.db");
+    EXPECT_EQ(1, tablespace);
+
+    // Pages of a tablespace are numbered from 0 within its own file.
+    page_id_t page_id = dm.AllocatePage(tablespace);
+    EXPECT_EQ(tablespace, DiskManager::GetTablespaceId(page_id));
+    EXPECT_EQ(0, DiskManager::GetLocalPageId(page_id));
+    EXPECT_EQ(DiskManager::MakePageId(tablespace, 1), dm.AllocateExtent(4, tablespace));
+    EXPECT_EQ(DiskManager::MakePageId(tablespace, 5), dm.GetNextPageId(tablespace));
+    EXPECT_EQ(0, dm.AllocatePage());
+    EXPECT_EQ(1, dm.GetNextPageId());
+
+    EXPECT_TRUE(dm.WritePage(page_id, data));
+    EXPECT_TRUE(dm.WritePage(0, main_data));
+    EXPECT_TRUE(dm.ReadPage(page_id, buf));
+    EXPECT_STREQ("tablespace page", buf);
+    EXPECT_TRUE(dm.ReadPage(0, buf));
+    EXPECT_STREQ("database page", buf);
+
+    // Freed pages of a tablespace are reused within it.
+    dm.DeallocatePage(page_id);
+    EXPECT_EQ(page_id, dm.AllocatePage(tablespace));
+    dm.ShutDown();
+  }
+  {
+    // The file of a tablespace keeps its pages when it is opened again.
+    auto dm = DiskManager("test.db");
+    tablespace_id_t tablespace = dm.CreateTablespace("test_ts.db");
+    EXPECT_EQ(DiskManager::MakePageId(tablespace, 1), dm.GetNextPageId(tablespace));
+    EXPECT_TRUE(dm.ReadPage(DiskManager::MakePageId(tablespace, 0), buf));
+    EXPECT_STREQ("tablespace page", buf);
+
+    // Dropping a tablespace deletes its file, and its pages are gone.
+    EXPECT_TRUE(dm.DropTablespace(tablespace));
+    EXPECT_NE(0, stat("test_ts.db", &stat_buf));
+    EXPECT_FALSE(dm.ReadPage(DiskManager::MakePageId(tablespace, 0), buf));
+    EXPECT_FALSE(dm.WritePage(DiskManager::MakePageId(tablespace, 0), data));
+    EXPECT_THROW(dm.AllocatePage(tablespace), Exception);
+    EXPECT_FALSE(dm.DropTablespace(tablespace));
+    EXPECT_FALSE(dm.DropTablespace(DEFAULT_TABLESPACE));
+
+    // The database file is untouched, and the id is free for the next tablespace.
+    EXPECT_TRUE(dm.ReadPage(0, buf));
+    EXPECT_STREQ("database page", buf);
+    EXPECT_EQ(tablespace, dm.CreateTablespace("test_ts.db"));
+    EXPECT_EQ(DiskManager::MakePageId(tablespace, 0), dm.GetNextPageId(tablespace));
+    dm.ShutDown();
+  }
+}
+
 // NOLINTNEXTLINE
 TEST_F(DiskManagerTest, ThrowBadFileTest) { EXPECT_THROW(DiskManager("dev/null\\/foo/bar/baz/test.db"), Exception); }
 
@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// mmap_disk_manager_test.cpp
+//
+// Identification: test/storage/mmap_disk_manager_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/mmap_disk_manager.h"
+
+namespace bustub {
+
+class MmapDiskManagerTest : public ::testing::Test {
+ protected:
+  // This function is called before every test.
+  void SetUp() override {
+    remove("test.db");
+    remove("test.log");
+  }
+
+  // This function is called after every test.
+  void TearDown() override {
+    remove("test.db");
+    remove("test.log");
+  };
+};
+
+// NOLINTNEXTLINE
+TEST_F(MmapDiskManagerTest, ReadWritePageTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  {
+    DiskManager dm(db_file);
+    for (page_id_t page_id = 0; page_id < 4; page_id++) {
+      std::snprintf(data, sizeof(data), "page %d", page_id);
+      dm.WritePage(page_id, data);
+    }
+    dm.ShutDown();
+  }
+
+  MmapDiskManager dm(db_file);
+  EXPECT_EQ(6 * BUSTUB_PAGE_SIZE, dm.GetMappedSize());  // the header page, the bitmap page and the 4 data pages
+  dm.ReadPage(2, buf);
+  EXPECT_STREQ("page 2", buf);
+  const char *mapped = dm.GetMappedPage(3);
+  ASSERT_NE(nullptr, mapped);
+  EXPECT_STREQ("page 3", mapped);
+
+  // Writes show through the mapping, and pages past its end extend it.
+  std::strncpy(data, "rewritten", sizeof(data));
+  dm.WritePage(3, data);
+  EXPECT_STREQ("rewritten", mapped);
+  EXPECT_EQ(nullptr, dm.GetMappedPage(6));
+  dm.WritePage(6, data);
+  dm.ReadPage(6, buf);
+  EXPECT_STREQ("rewritten", buf);
+  EXPECT_EQ(9 * BUSTUB_PAGE_SIZE, dm.GetMappedSize());
+  // The pointers into the mapping stay valid as it grows.
+  EXPECT_STREQ("rewritten", mapped);
+
+  // A page that was never written reads as zeros.
+  std::memset(buf, 'x', sizeof(buf));
+  dm.ReadPage(100, buf);
+  EXPECT_EQ(0, buf[0]);
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(MmapDiskManagerTest, BufferPoolTest) {
+  std::string db_file("test.db");
+  MmapDiskManager dm(db_file);
+  {
+    BufferPoolManager bpm(4, &dm);
+    for (int i = 0; i < 16; i++) {
+      page_id_t page_id;
+      auto guard = bpm.NewPageGuarded(&page_id);
+      std::snprintf(guard.GetDataMut(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    }
+    bpm.FlushAllPages();
+    // Scans read ahead through the mapping.
+    bpm.SetReadAheadWindow(8);
+    for (page_id_t page_id = 0; page_id < 16; page_id++) {
+      auto guard = bpm.FetchPageRead(page_id, AccessType::Scan);
+      EXPECT_EQ("page " + std::to_string(page_id), std::string(guard.GetData()));
+    }
+  }
+  EXPECT_STREQ("page 15", dm.GetMappedPage(15));
+  dm.ShutDown();
+}
+
+}  // namespace bustub
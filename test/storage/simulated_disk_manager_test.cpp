@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// simulated_disk_manager_test.cpp
+//
+// Identification: test/storage/simulated_disk_manager_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <sstream>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/disk/simulated_disk_manager.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(SimulatedDiskManagerTest, ReadWritePageTest) {
+  SimulatedDiskManager dm(DiskModel{std::chrono::microseconds(10)});
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  std::strncpy(data, "A test string.", sizeof(data));
+
+  dm.WritePage(3, data);
+  dm.ReadPage(3, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+}
+
+// NOLINTNEXTLINE
+TEST(SimulatedDiskManagerTest, ParseDiskModelTest) {
+  DiskModel model;
+  EXPECT_TRUE(ParseDiskModel("hdd", &model));
+  EXPECT_EQ(model.parallelism_, 1);
+  EXPECT_TRUE(ParseDiskModel("SSD,latency_us=80,parallelism=4,bandwidth_mbps=400,sigma=0,sequential_factor=0.25",
+                             &model));
+  EXPECT_EQ(model.latency_, std::chrono::microseconds(80));
+  EXPECT_EQ(model.parallelism_, 4);
+  EXPECT_EQ(model.bandwidth_, static_cast<size_t>(400) << 20);
+  EXPECT_EQ(model.latency_sigma_, 0);
+  EXPECT_EQ(model.sequential_factor_, 0.25);
+  EXPECT_TRUE(ParseDiskModel("none", &model));
+  EXPECT_EQ(model.latency_, std::chrono::microseconds(0));
+
+  EXPECT_FALSE(ParseDiskModel("tape", &model));
+  EXPECT_FALSE(ParseDiskModel("ssd,latency_us", &model));
+  EXPECT_FALSE(ParseDiskModel("ssd,latency_us=fast", &model));
+  EXPECT_FALSE(ParseDiskModel("ssd,rpm=7200", &model));
+}
+
+// NOLINTNEXTLINE
+TEST(SimulatedDiskManagerTest, ParallelismTest) {
+  const auto latency = std::chrono::milliseconds(20);
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  SimulatedDiskManager dm;
+  for (page_id_t page_id = 0; page_id < 4; page_id++) {
+    dm.WritePage(page_id * 2, buf);
+  }
+
+  auto read_concurrently = [&]() {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (page_id_t page_id = 0; page_id < 4; page_id++) {
+      threads.emplace_back([&dm, page_id] {
+        char page[BUSTUB_PAGE_SIZE];
+        dm.ReadPage(page_id * 2, page);
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    return std::chrono::steady_clock::now() - start;
+  };
+
+  // One I/O at a time, the four reads queue behind each other.
+  dm.SetDiskModel(DiskModel{latency, 0, 1, 0, 1});
+  EXPECT_GE(read_concurrently(), 4 * latency);
+
+  // Two at a time, they complete in two rounds.
+  dm.SetDiskModel(DiskModel{latency, 0, 1, 0, 2});
+  auto elapsed = read_concurrently();
+  EXPECT_GE(elapsed, 2 * latency);
+  EXPECT_LT(elapsed, 4 * latency);
+}
+
+// NOLINTNEXTLINE
+TEST(SimulatedDiskManagerTest, IoTraceTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  SimulatedDiskManager dm;
+  for (page_id_t page_id = 0; page_id < 8; page_id++) {
+    dm.WritePage(page_id, buf);
+  }
+
+  // Sequential I/O only pays a tenth of the latency.
+  dm.SetDiskModel(DiskModel{std::chrono::milliseconds(10), 0, 0.1, 0, 1});
+  dm.StartIoTrace();
+  auto start = std::chrono::steady_clock::now();
+  for (page_id_t page_id = 0; page_id < 8; page_id++) {
+    dm.ReadPage(page_id, buf);
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  dm.WritePage(5, buf);
+  auto trace = dm.StopIoTrace();
+
+  ASSERT_EQ(trace.size(), 9);
+  for (page_id_t page_id = 0; page_id < 8; page_id++) {
+    EXPECT_EQ(trace[page_id].page_id_, page_id);
+    EXPECT_FALSE(trace[page_id].is_write_);
+    EXPECT_EQ(trace[page_id].sequential_, page_id != 0);
+  }
+  EXPECT_TRUE(trace[8].is_write_);
+  EXPECT_FALSE(trace[8].sequential_);
+  EXPECT_GE(trace[0].service_us_, 10000);
+  EXPECT_GE(elapsed, std::chrono::microseconds(10000 + 7 * 1000));
+  EXPECT_LT(elapsed, std::chrono::microseconds(8 * 10000));
+
+  std::stringstream ss;
+  WriteIoTrace(ss, trace);
+  std::string line;
+  std::getline(ss, line);
+  EXPECT_EQ(line.substr(line.find(' ') + 1, 11), "0 read rand");
+}
+
+}  // namespace bustub
@@ -13,14 +13,18 @@
 #include <algorithm>
 #include <cstdio>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
+#include "common/exception.h"
 #include "gtest/gtest.h"
 #include "logging/common.h"
+#include "storage/disk/disk_manager_memory.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 // NOLINTNEXTLINE
@@ -61,4 +65,69 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(TupleTest, TableScanTest) {
+  Column col1{"a", TypeId::INTEGER};
+  Column col2{"b", TypeId::VARCHAR, 100};
+  Schema schema{{col1, col2}};
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+  TableHeap table(bpm.get());
+
+  // about 40 pages of tuples, whatever the page size
+  const int num_tuples = BUSTUB_PAGE_SIZE / 2;
+  std::vector<RID> rids;
+  for (int i = 0; i < num_tuples; ++i) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(50, 'x'))};
+    rids.push_back(*table.InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, Tuple{values, &schema}));
+  }
+  std::vector<page_id_t> page_ids;
+  for (const auto &rid : rids) {
+    if (page_ids.empty() || page_ids.back() != rid.GetPageId()) {
+      page_ids.push_back(rid.GetPageId());
+    }
+  }
+  ASSERT_GT(page_ids.size(), bpm->GetScanBatchSize() * 2);
+
+  // Scenario: A scan returns every tuple in insertion order.
+  auto stats = bpm->GetStats();
+  int count = 0;
+  for (auto iter = table.MakeIterator(); !iter.IsEnd(); ++iter) {
+    ASSERT_LT(count, num_tuples);
+    EXPECT_EQ(rids[count], iter.GetRID());
+    auto [meta, tuple] = iter.GetTuple();
+    EXPECT_EQ(count, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+    EXPECT_EQ(rids[count], tuple.GetRid());
+    count++;
+  }
+  EXPECT_EQ(num_tuples, count);
+
+  // Scenario: The scan pins its pages in batches, so it fetches every page about once instead of once per tuple.
+  auto scan_stats = bpm->GetStats();
+  auto scan_fetches = scan_stats.hits_[static_cast<size_t>(AccessType::Scan)] +
+                      scan_stats.misses_[static_cast<size_t>(AccessType::Scan)] -
+                      stats.hits_[static_cast<size_t>(AccessType::Scan)] -
+                      stats.misses_[static_cast<size_t>(AccessType::Scan)];
+  EXPECT_LE(scan_fetches, page_ids.size() + 1);
+
+  // Scenario: A scan that stops early releases its pins when the iterator goes away.
+  {
+    auto iter = table.MakeIterator();
+    ++iter;
+  }
+  std::vector<page_id_t> new_page_ids;
+  page_id_t page_id;
+  for (size_t i = 0; i < bpm->GetPoolSize(); i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    new_page_ids.push_back(page_id);
+  }
+
+  // Scenario: A scan that finds no free frame for its page throws instead of aborting.
+  EXPECT_THROW(table.MakeEagerIterator(), Exception);
+  for (auto new_page_id : new_page_ids) {
+    bpm->UnpinPage(new_page_id, false);
+  }
+}
+
 }  // namespace bustub
@@ -12,6 +12,7 @@
 
 #include <cstdio>
 #include <iostream>
+#include <memory>
 
 #include "buffer/buffer_pool_manager.h"
 #include "common/logger.h"
@@ -72,8 +73,8 @@ auto main(int argc, char **argv) -> int {
 
   GenericComparator<8> comparator(key_schema.get());
 
-  auto *disk_manager = new DiskManager("test.db");
-  auto *bpm = new BufferPoolManager(100, disk_manager);
+  auto disk_manager = std::make_unique<DiskManager>("test.db");
+  auto *bpm = new BufferPoolManager(100, disk_manager.get());
   // create and fetch header_page
   page_id_t page_id;
   auto header_page = bpm->NewPage(&page_id);
@@ -135,7 +136,6 @@ auto main(int argc, char **argv) -> int {
   bpm->UnpinPage(header_page->GetPageId(), true);
   delete bpm;
   delete transaction;
-  delete disk_manager;
   remove("test.db");
   remove("test.log");
 
@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <chrono>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <mutex>  // NOLINT
@@ -6,20 +8,23 @@
 #include <sstream>
 #include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include <cpp_random_distributions/zipfian_int_distribution.h>
 
 #include "argparse/argparse.hpp"
 #include "binder/binder.h"
+#include "buffer/access_trace.h"
 #include "buffer/buffer_pool_manager.h"
-#include "buffer/lru_k_replacer.h"
+#include "buffer/replacer.h"
 #include "common/config.h"
 #include "common/exception.h"
 #include "common/util/string_util.h"
 #include "fmt/core.h"
 #include "fmt/std.h"
 #include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/simulated_disk_manager.h"
 
 #include <sys/time.h>
 
@@ -104,12 +109,21 @@ struct BpmMetrics {
 auto main(int argc, char **argv) -> int {
   using bustub::AccessType;
   using bustub::BufferPoolManager;
-  using bustub::DiskManagerUnlimitedMemory;
+  using bustub::SimulatedDiskManager;
   using bustub::page_id_t;
 
   argparse::ArgumentParser program("bustub-bpm-bench");
   program.add_argument("--duration").help("run bpm bench for n milliseconds");
   program.add_argument("--latency").help("set disk latency to n milliseconds");
+  program.add_argument("--instances").help("split the buffer pool into n independently latched partitions");
+  program.add_argument("--read-ahead").help("prefetch n pages ahead of the scan threads");
+  program.add_argument("--page-cleaner").help("run the page cleaner, keeping this fraction of frames clean");
+  program.add_argument("--policy").help("replacement policy of the buffer pool: lru-k, clock, 2q or arc");
+  program.add_argument("--trace-out").help("record the page accesses of the benchmark into this trace file");
+  program.add_argument("--disk-model")
+      .help("simulate a disk: nvme, ssd or hdd, with overrides such as ssd,latency_us=80,parallelism=4");
+  program.add_argument("--disk-trace-out").help("record the disk I/Os of the benchmark into this trace file");
+  program.add_argument("--resize").help("resize the buffer pool to n frames halfway through the benchmark");
 
   try {
     program.parse_args(argc, argv);
@@ -129,12 +143,33 @@ auto main(int argc, char **argv) -> int {
     latency_ms = std::stoi(program.get("--latency"));
   }
 
-  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
-  auto bpm = std::make_unique<BufferPoolManager>(BUSTUB_BPM_SIZE, disk_manager.get(), LRU_K_SIZE);
+  size_t bpm_instances = 1;
+  if (program.present("--instances")) {
+    bpm_instances = std::stoi(program.get("--instances"));
+  }
+
+  if (program.present("--policy") &&
+      !bustub::ParseReplacementPolicy(program.get("--policy"), &bustub::replacement_policy)) {
+    std::cerr << "unknown replacement policy: " << program.get("--policy") << std::endl;
+    return 1;
+  }
+
+  bustub::DiskModel disk_model;
+  if (program.present("--disk-model") && !bustub::ParseDiskModel(program.get("--disk-model"), &disk_model)) {
+    std::cerr << "invalid disk model: " << program.get("--disk-model") << std::endl;
+    return 1;
+  }
+
+  auto disk_manager = std::make_unique<SimulatedDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManager>(BUSTUB_BPM_SIZE, disk_manager.get(), LRU_K_SIZE, nullptr,
+                                                 bpm_instances);
   std::vector<page_id_t> page_ids;
 
-  fmt::print(stderr, "[info] total_page={}, duration_ms={}, latency_ms={}, lru_k_size={}, bpm_size={}\n",
-             BUSTUB_PAGE_CNT, duration_ms, latency_ms, LRU_K_SIZE, BUSTUB_BPM_SIZE);
+  fmt::print(stderr,
+             "[info] total_page={}, duration_ms={}, latency_ms={}, lru_k_size={}, bpm_size={}, bpm_instances={}, "
+             "policy={}\n",
+             BUSTUB_PAGE_CNT, duration_ms, latency_ms, LRU_K_SIZE, BUSTUB_BPM_SIZE, bpm_instances,
+             bustub::ReplacementPolicyName(bpm->GetReplacementPolicy()));
 
   for (size_t i = 0; i < BUSTUB_PAGE_CNT; i++) {
     page_id_t page_id;
@@ -151,6 +186,23 @@ auto main(int argc, char **argv) -> int {
 
   // enable disk latency after creating all pages
   disk_manager->SetLatency(latency_ms);
+  disk_manager->SetDiskModel(disk_model);
+
+  if (program.present("--read-ahead")) {
+    bpm->SetReadAheadWindow(std::stoi(program.get("--read-ahead")));
+  }
+
+  if (program.present("--page-cleaner")) {
+    bpm->StartPageCleaner(std::stod(program.get("--page-cleaner")));
+  }
+
+  if (program.present("--trace-out")) {
+    bpm->StartAccessTrace();
+  }
+
+  if (program.present("--disk-trace-out")) {
+    disk_manager->StartIoTrace();
+  }
 
   fmt::print(stderr, "[info] benchmark start\n");
 
@@ -222,11 +274,51 @@ auto main(int argc, char **argv) -> int {
     }));
   }
 
+  if (program.present("--resize")) {
+    size_t new_size = std::stoul(program.get("--resize"));
+    threads.emplace_back([&bpm, duration_ms, new_size] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(duration_ms / 2));
+      auto start = std::chrono::steady_clock::now();
+      bool resized = bpm->ResizePool(new_size);
+      auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+      fmt::print(stderr, "[info] resized to {} frames ({}) in {} us\n", bpm->GetPoolSize(),
+                 resized ? "done" : "gave up on a pinned frame", elapsed.count());
+    });
+  }
+
   for (auto &thread : threads) {
     thread.join();
   }
 
   total_metrics.Report();
+  if (program.present("--trace-out")) {
+    auto trace = bpm->StopAccessTrace();
+    std::ofstream out(program.get("--trace-out"));
+    bustub::WriteAccessTrace(out, trace);
+    fmt::print(stderr, "[info] recorded {} page accesses to {}\n", trace.size(), program.get("--trace-out"));
+  }
+  if (program.present("--disk-trace-out")) {
+    auto trace = disk_manager->StopIoTrace();
+    std::ofstream out(program.get("--disk-trace-out"));
+    bustub::WriteIoTrace(out, trace);
+    fmt::print(stderr, "[info] recorded {} disk I/Os to {}\n", trace.size(), program.get("--disk-trace-out"));
+  }
+  bpm->StopPageCleaner();
+  auto stats = bpm->GetStats();
+  fmt::print(stderr, "[info] foreground_writes={}, background_writes={}, evictions={}, pin_waits={}\n",
+             stats.foreground_writes_, stats.background_writes_, stats.evictions_, stats.pin_waits_);
+  fmt::print(stderr, "[info] read_ahead_window={}, read_ahead_pages={}, read_ahead_hits={}\n",
+             stats.read_ahead_window_, stats.read_ahead_pages_, stats.read_ahead_hits_);
+  for (auto [name, access_type] : {std::pair{"scan", AccessType::Scan}, std::pair{"get", AccessType::Get}}) {
+    auto hits = stats.hits_[static_cast<size_t>(access_type)];
+    auto misses = stats.misses_[static_cast<size_t>(access_type)];
+    fmt::print(stderr, "[info] {}: hits={}, misses={}, hit_rate={:.3f}\n", name, hits, misses,
+               hits / static_cast<double>(std::max<uint64_t>(hits + misses, 1)));
+  }
+  fmt::print(stderr, "[info] miss latency: mean={:.1f}us, p50<{}us, p99<{}us\n", stats.miss_latency_.MeanUs(),
+             stats.miss_latency_.PercentileUs(50), stats.miss_latency_.PercentileUs(99));
+  fmt::print(stderr, "[info] write latency: mean={:.1f}us, p50<{}us, p99<{}us\n", stats.write_latency_.MeanUs(),
+             stats.write_latency_.PercentileUs(50), stats.write_latency_.PercentileUs(99));
 
   return 0;
 }
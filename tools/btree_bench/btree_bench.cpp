@@ -1,4 +1,5 @@
 #include <chrono>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <mutex>  // NOLINT
@@ -20,6 +21,7 @@
 #include "common/util/string_util.h"
 #include "fmt/format.h"
 #include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/simulated_disk_manager.h"
 #include "storage/index/b_plus_tree.h"
 #include "storage/index/generic_key.h"
 #include "test_util.h"
@@ -114,11 +116,15 @@ auto KeyWillChange(size_t key) -> bool { return key % 5 == 0; }
 auto main(int argc, char **argv) -> int {
   using bustub::AccessType;
   using bustub::BufferPoolManager;
-  using bustub::DiskManagerUnlimitedMemory;
+  using bustub::SimulatedDiskManager;
   using bustub::page_id_t;
 
   argparse::ArgumentParser program("bustub-btree-bench");
   program.add_argument("--duration").help("run btree bench for n milliseconds");
+  program.add_argument("--swizzle").help("let up to this fraction of the buffer pool be swizzled");
+  program.add_argument("--disk-model")
+      .help("simulate a disk: nvme, ssd or hdd, with overrides such as ssd,latency_us=80,parallelism=4");
+  program.add_argument("--disk-trace-out").help("record the disk I/Os of the benchmark into this trace file");
 
   try {
     program.parse_args(argc, argv);
@@ -133,8 +139,17 @@ auto main(int argc, char **argv) -> int {
     duration_ms = std::stoi(program.get("--duration"));
   }
 
-  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  bustub::DiskModel disk_model;
+  if (program.present("--disk-model") && !bustub::ParseDiskModel(program.get("--disk-model"), &disk_model)) {
+    std::cerr << "invalid disk model: " << program.get("--disk-model") << std::endl;
+    return 1;
+  }
+
+  auto disk_manager = std::make_unique<SimulatedDiskManager>();
   auto bpm = std::make_unique<BufferPoolManager>(BUSTUB_BPM_SIZE, disk_manager.get(), LRU_K_SIZE);
+  if (program.present("--swizzle")) {
+    bpm->SetSwizzleFraction(std::stod(program.get("--swizzle")));
+  }
 
   fmt::print(stderr, "[info] total_keys={}, duration_ms={}, lru_k_size={}, bpm_size={}\n", TOTAL_KEYS, duration_ms,
              LRU_K_SIZE, BUSTUB_BPM_SIZE);
@@ -157,6 +172,12 @@ auto main(int argc, char **argv) -> int {
     index.Insert(index_key, rid, nullptr);
   }
 
+  // simulate the disk only after loading the index
+  disk_manager->SetDiskModel(disk_model);
+  if (program.present("--disk-trace-out")) {
+    disk_manager->StartIoTrace();
+  }
+
   fmt::print(stderr, "[info] benchmark start\n");
 
   BTreeTotalMetrics total_metrics;
@@ -262,6 +283,14 @@ auto main(int argc, char **argv) -> int {
   }
 
   total_metrics.Report();
+  if (program.present("--disk-trace-out")) {
+    auto trace = disk_manager->StopIoTrace();
+    std::ofstream out(program.get("--disk-trace-out"));
+    bustub::WriteIoTrace(out, trace);
+    fmt::print(stderr, "[info] recorded {} disk I/Os to {}\n", trace.size(), program.get("--disk-trace-out"));
+  }
+  fmt::print(stderr, "[info] swizzled_fetches={}, page_table_hits={}, page_table_misses={}\n",
+             bpm->GetSwizzledFetches(), bpm->GetFetchHits(AccessType::Unknown), bpm->GetFetchMisses(AccessType::Unknown));
 
   return 0;
 }
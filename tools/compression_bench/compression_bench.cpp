@@ -0,0 +1,202 @@
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "fmt/core.h"
+#include "storage/disk/compressed_disk_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/table_page.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/tuple.h"
+#include "type/value_factory.h"
+
+namespace {
+
+const size_t DEFAULT_TUPLE_CNT = 500000;
+const size_t DEFAULT_BPM_SIZE = 256;
+/** Frames of the buffer pool that loads the table, enough to hold it all. */
+const size_t LOAD_BPM_SIZE = 16384;
+
+const std::array<const char *, 4> STATUSES = {"active", "inactive", "pending", "shipped"};
+const std::array<const char *, 8> CITIES = {"Pittsburgh", "Boston",  "Seattle", "Austin",
+                                            "Chicago",    "Atlanta", "Denver",  "Portland"};
+
+/** An orders table of small integers and repetitive strings, the kind of data page compression is for. */
+auto MakeSchema() -> bustub::Schema {
+  return bustub::Schema({bustub::Column{"id", bustub::TypeId::INTEGER},
+                         bustub::Column{"customer", bustub::TypeId::INTEGER},
+                         bustub::Column{"quantity", bustub::TypeId::INTEGER},
+                         bustub::Column{"status", bustub::TypeId::VARCHAR, 16},
+                         bustub::Column{"city", bustub::TypeId::VARCHAR, 16}});
+}
+
+/** Load `tuple_cnt` tuples into a table heap and flush them. @return the first page of the table */
+auto LoadTable(bustub::DiskManager *disk_manager, const bustub::Schema &schema, size_t tuple_cnt) -> bustub::page_id_t {
+  bustub::BufferPoolManager bpm(LOAD_BPM_SIZE, disk_manager);
+  bustub::TableHeap table(&bpm);
+  std::mt19937 rng(42);
+  for (size_t i = 0; i < tuple_cnt; i++) {
+    std::vector<bustub::Value> values{
+        bustub::ValueFactory::GetIntegerValue(static_cast<int32_t>(i)),
+        bustub::ValueFactory::GetIntegerValue(static_cast<int32_t>(rng() % 1000)),
+        bustub::ValueFactory::GetIntegerValue(static_cast<int32_t>(rng() % 10)),
+        bustub::ValueFactory::GetVarcharValue(STATUSES[rng() % STATUSES.size()]),
+        bustub::ValueFactory::GetVarcharValue(CITIES[rng() % CITIES.size()])};
+    table.InsertTuple(bustub::TupleMeta{bustub::INVALID_TXN_ID, bustub::INVALID_TXN_ID, false},
+                      bustub::Tuple{values, &schema});
+  }
+  bpm.FlushAllPages();
+  return table.GetFirstPageId();
+}
+
+/** Drop the pages of a file from the OS page cache, so that the next scan has to read them from disk. */
+void DropPageCache(const std::string &file_name) {
+  int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  fdatasync(fd);
+  posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  close(fd);
+}
+
+struct ScanResult {
+  size_t pages_{0};
+  size_t tuples_{0};
+  double seconds_{0};
+};
+
+/** Scan the table through a buffer pool smaller than it, reading one column of every tuple. */
+auto Scan(bustub::DiskManager *disk_manager, const bustub::Schema &schema, bustub::page_id_t first_page_id,
+          size_t bpm_size) -> ScanResult {
+  bustub::BufferPoolManager bpm(bpm_size, disk_manager);
+  ScanResult result;
+  int64_t sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (auto page_id = first_page_id; page_id != bustub::INVALID_PAGE_ID;) {
+    auto guard = bpm.FetchPageRead(page_id, bustub::AccessType::Scan);
+    const auto *page = guard.As<bustub::TablePage>();
+    for (uint32_t slot = 0; slot < page->GetNumTuples(); slot++) {
+      auto [meta, tuple] = page->GetTuple(bustub::RID(page_id, slot));
+      sum += tuple.GetValue(&schema, 2).GetAs<int32_t>();
+      result.tuples_++;
+    }
+    result.pages_++;
+    page_id = page->GetNextPageId();
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  result.seconds_ = elapsed.count();
+  if (sum < 0) {
+    throw std::runtime_error("invalid data");
+  }
+  return result;
+}
+
+auto FileSize(const std::string &file_name) -> size_t {
+  FILE *file = std::fopen(file_name.c_str(), "rb");
+  if (file == nullptr) {
+    return 0;
+  }
+  std::fseek(file, 0, SEEK_END);
+  auto size = static_cast<size_t>(std::ftell(file));
+  std::fclose(file);
+  return size;
+}
+
+void RemoveDatabase(const std::string &db_file) {
+  std::remove(db_file.c_str());
+  std::remove((db_file.substr(0, db_file.rfind('.')) + ".log").c_str());
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-compression-bench");
+  program.add_description(
+      "Compare table scans over a plain and a compressed database file. The cold scan starts with the file out of "
+      "the OS page cache and pays for I/O, the warm scan right after it pays for decompression only; the break-even "
+      "bandwidth is the device speed below which the saved I/O outweighs the decompression.");
+  program.add_argument("--file").default_value(std::string("compression_bench.db")).help("the database file to create");
+  program.add_argument("--tuples").help("number of tuples in the table");
+  program.add_argument("--bpm-size").help("number of frames in the buffer pool of the scans");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  auto db_file = program.get<std::string>("--file");
+  size_t tuple_cnt = DEFAULT_TUPLE_CNT;
+  if (program.present("--tuples")) {
+    tuple_cnt = std::stoi(program.get("--tuples"));
+  }
+  size_t bpm_size = DEFAULT_BPM_SIZE;
+  if (program.present("--bpm-size")) {
+    bpm_size = std::stoi(program.get("--bpm-size"));
+  }
+
+  fmt::print(stderr, "[info] file={}, tuples={}, bpm_size={}\n", db_file, tuple_cnt, bpm_size);
+  auto schema = MakeSchema();
+
+  fmt::print("<<< BEGIN\n");
+  std::array<double, 2> warm_seconds{};
+  std::array<double, 2> bytes_per_page{};
+  for (bool compressed : {false, true}) {
+    RemoveDatabase(db_file);
+    std::unique_ptr<bustub::DiskManager> disk_manager;
+    if (compressed) {
+      disk_manager = std::make_unique<bustub::CompressedDiskManager>(db_file);
+    } else {
+      disk_manager = std::make_unique<bustub::DiskManager>(db_file);
+    }
+    std::string mode = compressed ? "compressed" : "plain";
+    auto start = std::chrono::steady_clock::now();
+    auto first_page_id = LoadTable(disk_manager.get(), schema, tuple_cnt);
+    std::chrono::duration<double> load = std::chrono::steady_clock::now() - start;
+
+    DropPageCache(db_file);
+    auto *compressed_disk_manager = dynamic_cast<bustub::CompressedDiskManager *>(disk_manager.get());
+    size_t bytes_read = compressed ? compressed_disk_manager->GetNumBytesRead() : 0;
+    auto cold = Scan(disk_manager.get(), schema, first_page_id, bpm_size);
+    bytes_read = compressed ? compressed_disk_manager->GetNumBytesRead() - bytes_read
+                            : cold.pages_ * bustub::BUSTUB_PAGE_SIZE;
+    auto warm = Scan(disk_manager.get(), schema, first_page_id, bpm_size);
+    warm_seconds[compressed] = warm.seconds_ / warm.pages_;
+    bytes_per_page[compressed] = static_cast<double>(bytes_read) / cold.pages_;
+
+    fmt::print("{} file size: {} bytes, {:.1f} bytes/tuple, load {:.0f} tuples/s\n", mode, FileSize(db_file),
+               static_cast<double>(FileSize(db_file)) / tuple_cnt, tuple_cnt / load.count());
+    fmt::print("{} cold scan: {:.0f} tuples/s, {:.1f} bytes read/tuple\n", mode, cold.tuples_ / cold.seconds_,
+               static_cast<double>(bytes_read) / cold.tuples_);
+    fmt::print("{} warm scan: {:.0f} tuples/s\n", mode, warm.tuples_ / warm.seconds_);
+    disk_manager->ShutDown();
+  }
+  double saved_bytes = bytes_per_page[0] - bytes_per_page[1];
+  double extra_seconds = warm_seconds[1] - warm_seconds[0];
+  fmt::print("compression ratio: {:.2f}\n", bytes_per_page[0] / bytes_per_page[1]);
+  if (extra_seconds > 0) {
+    fmt::print("break-even bandwidth: {:.0f} MB/s\n", saved_bytes / extra_seconds / 1e6);
+  } else {
+    fmt::print("break-even bandwidth: none, decompression was free\n");
+  }
+  fmt::print(">>> END\n");
+
+  RemoveDatabase(db_file);
+  return 0;
+}
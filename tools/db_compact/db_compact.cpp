@@ -0,0 +1,51 @@
+#include <iostream>
+#include <string>
+
+#include <sys/stat.h>
+
+#include "argparse/argparse.hpp"
+#include "common/config.h"
+#include "fmt/core.h"
+#include "storage/disk/disk_manager.h"
+
+namespace {
+
+auto FileSize(const std::string &file_name) -> int64_t {
+  struct stat stat_buf;
+  return stat(file_name.c_str(), &stat_buf) == 0 ? static_cast<int64_t>(stat_buf.st_size) : -1;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-db-compact");
+  program.add_description("Truncate the free pages at the end of a database file. The database must not be in use.");
+  program.add_argument("file").help("the database file to compact");
+  program.add_argument("--dry-run").default_value(false).implicit_value(true).help("only report the free pages");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  auto file_name = program.get<std::string>("file");
+  if (FileSize(file_name) < 0) {
+    fmt::print(stderr, "[error] {} does not exist\n", file_name);
+    return 1;
+  }
+
+  bustub::DiskManager disk_manager(file_name);
+  fmt::print("{}: {} bytes, {} pages, {} free\n", file_name, FileSize(file_name), disk_manager.GetNextPageId(),
+             disk_manager.GetNumFreePages());
+  if (!program.get<bool>("--dry-run")) {
+    auto dropped = disk_manager.Compact();
+    fmt::print("dropped {} trailing free pages: {} bytes, {} pages, {} free\n", dropped, FileSize(file_name),
+               disk_manager.GetNextPageId(), disk_manager.GetNumFreePages());
+  }
+  disk_manager.ShutDown();
+  return 0;
+}
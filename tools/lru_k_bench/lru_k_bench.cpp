@@ -0,0 +1,246 @@
+#include <chrono>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <cpp_random_distributions/zipfian_int_distribution.h>
+
+#include "argparse/argparse.hpp"
+#include "buffer/lru_k_replacer.h"
+#include "common/config.h"
+#include "fmt/core.h"
+
+#include <sys/time.h>
+
+auto ClockMs() -> uint64_t {
+  struct timeval tm;
+  gettimeofday(&tm, nullptr);
+  return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
+}
+
+namespace {
+
+using bustub::AccessType;
+using bustub::frame_id_t;
+
+/**
+ * The previous LRU-K replacer, kept as the baseline: a heap-allocated std::list history per frame, a history list in
+ * first-access order, a cache list kept sorted by linear insertion, and evictions that skip pinned frames.
+ */
+class ListLRUKReplacer {
+ public:
+  struct Node {
+    Node(size_t k, frame_id_t fid) : k_(k), fid_(fid) {}
+    Node() = default;
+
+    std::list<size_t> history_;
+    size_t access_count_{0};
+    size_t k_;
+    frame_id_t fid_;
+    bool is_evictable_{false};
+    Node *next_{nullptr};
+    Node *pre_{nullptr};
+  };
+
+  ListLRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {
+    head1_->next_ = tail1_;
+    tail1_->pre_ = head1_;
+    head2_->next_ = tail2_;
+    tail2_->pre_ = head2_;
+  }
+
+  ~ListLRUKReplacer() {
+    for (auto &[fid, node] : node_store_) {
+      delete node;
+    }
+    delete head1_;
+    delete head2_;
+    delete tail1_;
+    delete tail2_;
+  }
+
+  auto Evict(frame_id_t *frame_id) -> bool {
+    std::lock_guard<std::mutex> my_lock(latch_);
+    Node *evict_node = nullptr;
+    for (auto p = head1_->next_; p != tail1_ && evict_node == nullptr; p = p->next_) {
+      if (p->is_evictable_) {
+        evict_node = p;
+      }
+    }
+    for (auto p = head2_->next_; p != tail2_ && evict_node == nullptr; p = p->next_) {
+      if (p->is_evictable_) {
+        evict_node = p;
+      }
+    }
+    if (evict_node == nullptr) {
+      return false;
+    }
+    *frame_id = evict_node->fid_;
+    RemoveNode(evict_node);
+    node_store_.erase(*frame_id);
+    delete evict_node;
+    evictable_size_--;
+    return true;
+  }
+
+  void RecordAccess(frame_id_t frame_id, [[maybe_unused]] AccessType access_type = AccessType::Unknown) {
+    std::lock_guard<std::mutex> my_lock(latch_);
+    auto iter = node_store_.find(frame_id);
+    if (iter == node_store_.end()) {
+      auto node = new Node(k_, frame_id);
+      node->history_.push_back(current_timestamp_++);
+      node->access_count_++;
+      InsertNode(tail1_->pre_, node);
+      node_store_[frame_id] = node;
+      return;
+    }
+    Node *node = iter->second;
+    node->history_.push_back(current_timestamp_++);
+    node->access_count_++;
+    if (node->access_count_ == k_) {
+      RemoveNode(node);
+      InsertNode(tail2_->pre_, node);
+    } else if (node->access_count_ > k_) {
+      node->history_.pop_front();
+      RemoveNode(node);
+      Node *p = head2_->next_;
+      for (; p != tail2_; p = p->next_) {
+        if (node->history_.front() < p->history_.front()) {
+          break;
+        }
+      }
+      InsertNode(p->pre_, node);
+    }
+  }
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) {
+    std::lock_guard<std::mutex> my_lock(latch_);
+    auto iter = node_store_.find(frame_id);
+    if (iter == node_store_.end()) {
+      return;
+    }
+    Node *node = iter->second;
+    if (node->is_evictable_ != set_evictable) {
+      node->is_evictable_ = set_evictable;
+      evictable_size_ += set_evictable ? 1 : -1;
+    }
+  }
+
+ private:
+  static void RemoveNode(const Node *node) {
+    node->pre_->next_ = node->next_;
+    node->next_->pre_ = node->pre_;
+  }
+
+  static void InsertNode(Node *left, Node *right) {
+    right->next_ = left->next_;
+    right->pre_ = left;
+    left->next_ = right;
+    right->next_->pre_ = right;
+  }
+
+  std::unordered_map<frame_id_t, Node *> node_store_;
+  size_t current_timestamp_{0};
+  size_t evictable_size_{0};
+  size_t replacer_size_;
+  size_t k_;
+  std::mutex latch_;
+  Node *head1_{new Node()};
+  Node *head2_{new Node()};
+  Node *tail1_{new Node()};
+  Node *tail2_{new Node()};
+};
+
+/**
+ * Drive a replacer the way a buffer pool does: every access pins and unpins a frame, and a miss evicts a victim whose
+ * frame then receives the new page. Pages are drawn from a zipfian distribution over `num_pages` pages.
+ * @return the elapsed time in milliseconds
+ */
+template <typename Replacer>
+auto RunWorkload(Replacer *replacer, size_t num_frames, size_t num_pages, size_t num_ops) -> uint64_t {
+  std::mt19937 gen(15445);
+  zipfian_int_distribution<size_t> dist(0, num_pages - 1, 0.8);
+  std::unordered_map<size_t, frame_id_t> page_table;
+  std::vector<size_t> frame_page(num_frames);
+  page_table.reserve(num_frames);
+
+  auto start = ClockMs();
+  for (size_t i = 0; i < num_ops; ++i) {
+    size_t page = dist(gen);
+    frame_id_t frame_id;
+    auto iter = page_table.find(page);
+    if (iter != page_table.end()) {
+      frame_id = iter->second;
+    } else if (page_table.size() < num_frames) {
+      frame_id = static_cast<frame_id_t>(page_table.size());
+    } else {
+      replacer->Evict(&frame_id);
+      page_table.erase(frame_page[frame_id]);
+    }
+    page_table[page] = frame_id;
+    frame_page[frame_id] = page;
+    replacer->RecordAccess(frame_id, AccessType::Get);
+    replacer->SetEvictable(frame_id, false);
+    replacer->SetEvictable(frame_id, true);
+  }
+  return ClockMs() - start;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-lru-k-bench");
+  program.add_argument("--frames").help("number of frames tracked by the replacer");
+  program.add_argument("--pages").help("number of distinct pages accessed");
+  program.add_argument("--ops").help("number of page accesses");
+  program.add_argument("--k").help("lookback constant k");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t num_frames = 16384;
+  size_t num_pages = 0;
+  size_t num_ops = 1000000;
+  size_t k = bustub::LRUK_REPLACER_K;
+  if (program.present("--frames")) {
+    num_frames = std::stoul(program.get("--frames"));
+  }
+  if (program.present("--pages")) {
+    num_pages = std::stoul(program.get("--pages"));
+  }
+  if (program.present("--ops")) {
+    num_ops = std::stoul(program.get("--ops"));
+  }
+  if (program.present("--k")) {
+    k = std::stoul(program.get("--k"));
+  }
+  if (num_pages == 0) {
+    num_pages = num_frames * 4;
+  }
+
+  fmt::print(stderr, "[info] frames={}, pages={}, ops={}, k={}\n", num_frames, num_pages, num_ops, k);
+
+  {
+    ListLRUKReplacer replacer(num_frames, k);
+    auto elapsed = RunWorkload(&replacer, num_frames, num_pages, num_ops);
+    fmt::print("list: {} ms, {:.1f} ns/op\n", elapsed, elapsed * 1e6 / num_ops);
+  }
+  {
+    bustub::LRUKReplacer replacer(num_frames, k);
+    auto elapsed = RunWorkload(&replacer, num_frames, num_pages, num_ops);
+    fmt::print("heap: {} ms, {:.1f} ns/op\n", elapsed, elapsed * 1e6 / num_ops);
+  }
+
+  return 0;
+}
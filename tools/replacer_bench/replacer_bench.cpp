@@ -0,0 +1,183 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <cpp_random_distributions/zipfian_int_distribution.h>
+
+#include "argparse/argparse.hpp"
+#include "buffer/access_trace.h"
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+#include "fmt/core.h"
+
+namespace {
+
+using bustub::AccessType;
+using bustub::frame_id_t;
+using bustub::page_id_t;
+using bustub::PageAccess;
+using bustub::ReplacementPolicy;
+
+/**
+ * Generate a trace whose mix of point lookups and scans shifts over time: phases with mostly zipfian gets over
+ * `num_pages` pages alternate with phases where half of the accesses continue a sequential scan over all pages.
+ */
+auto GenerateTrace(size_t num_pages, size_t num_ops, size_t phase_length) -> std::vector<PageAccess> {
+  std::mt19937 gen(15445);
+  zipfian_int_distribution<page_id_t> dist(0, static_cast<page_id_t>(num_pages) - 1, 0.8);
+  std::uniform_real_distribution<double> coin(0, 1);
+  std::vector<PageAccess> trace;
+  trace.reserve(num_ops);
+  page_id_t scan_cursor = 0;
+  for (size_t i = 0; i < num_ops; ++i) {
+    double scan_fraction = (i / phase_length) % 2 == 0 ? 0.1 : 0.5;
+    if (coin(gen) < scan_fraction) {
+      trace.push_back({scan_cursor, AccessType::Scan});
+      scan_cursor = (scan_cursor + 1) % static_cast<page_id_t>(num_pages);
+    } else {
+      trace.push_back({dist(gen), AccessType::Get});
+    }
+  }
+  return trace;
+}
+
+struct ReplayResult {
+  uint64_t hits_{0};
+  uint64_t misses_{0};
+  uint64_t elapsed_ns_{0};
+};
+
+/**
+ * Replay a trace against a replacer the way a single-partition buffer pool drives it: every access pins and unpins a
+ * frame, and a miss takes a free frame or evicts a victim whose frame then receives the page.
+ */
+auto Replay(bustub::FrameReplacer *replacer, size_t num_frames, const std::vector<PageAccess> &trace) -> ReplayResult {
+  ReplayResult result;
+  std::unordered_map<page_id_t, frame_id_t> page_table;
+  std::vector<page_id_t> frame_page(num_frames, bustub::INVALID_PAGE_ID);
+  page_table.reserve(num_frames);
+
+  auto start = std::chrono::steady_clock::now();
+  for (const auto &access : trace) {
+    frame_id_t frame_id;
+    auto iter = page_table.find(access.page_id_);
+    if (iter != page_table.end()) {
+      frame_id = iter->second;
+      result.hits_++;
+    } else {
+      result.misses_++;
+      if (page_table.size() < num_frames) {
+        frame_id = static_cast<frame_id_t>(page_table.size());
+      } else {
+        BUSTUB_ENSURE(replacer->Evict(&frame_id), "every frame is unpinned between accesses");
+        page_table.erase(frame_page[frame_id]);
+      }
+      page_table[access.page_id_] = frame_id;
+      frame_page[frame_id] = access.page_id_;
+    }
+    replacer->RecordAccess(frame_id, access.access_type_, access.page_id_);
+    replacer->SetEvictable(frame_id, false);
+    replacer->SetEvictable(frame_id, true);
+  }
+  result.elapsed_ns_ = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+                           .count();
+  return result;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-replacer-bench");
+  program.add_argument("--trace").help("replay the page accesses of this trace file instead of a generated trace");
+  program.add_argument("--write-trace").help("write the replayed trace to this file");
+  program.add_argument("--policy").help("only replay against this policy: lru-k, clock, 2q or arc");
+  program.add_argument("--frames").help("number of frames of the simulated buffer pool");
+  program.add_argument("--k").help("lookback constant k of LRU-K");
+  program.add_argument("--pages").help("number of distinct pages of the generated trace");
+  program.add_argument("--ops").help("number of page accesses of the generated trace");
+  program.add_argument("--phase").help("number of accesses before the generated trace shifts its scan/get mix");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t num_frames = 1024;
+  size_t k = bustub::LRUK_REPLACER_K;
+  size_t num_pages = 0;
+  size_t num_ops = 1000000;
+  size_t phase_length = 100000;
+  if (program.present("--frames")) {
+    num_frames = std::stoul(program.get("--frames"));
+  }
+  if (program.present("--k")) {
+    k = std::stoul(program.get("--k"));
+  }
+  if (program.present("--pages")) {
+    num_pages = std::stoul(program.get("--pages"));
+  }
+  if (program.present("--ops")) {
+    num_ops = std::stoul(program.get("--ops"));
+  }
+  if (program.present("--phase")) {
+    phase_length = std::stoul(program.get("--phase"));
+  }
+  if (num_pages == 0) {
+    num_pages = num_frames * 8;
+  }
+
+  std::vector<ReplacementPolicy> policies = {ReplacementPolicy::LRUK, ReplacementPolicy::Clock,
+                                             ReplacementPolicy::TwoQueue, ReplacementPolicy::ARC};
+  if (program.present("--policy")) {
+    ReplacementPolicy policy;
+    if (!bustub::ParseReplacementPolicy(program.get("--policy"), &policy)) {
+      std::cerr << "unknown replacement policy: " << program.get("--policy") << std::endl;
+      return 1;
+    }
+    policies = {policy};
+  }
+
+  std::vector<PageAccess> trace;
+  if (program.present("--trace")) {
+    std::ifstream in(program.get("--trace"));
+    if (!in) {
+      std::cerr << "cannot open trace " << program.get("--trace") << std::endl;
+      return 1;
+    }
+    trace = bustub::ReadAccessTrace(in);
+    fmt::print(stderr, "[info] trace={}, accesses={}, frames={}, k={}\n", program.get("--trace"), trace.size(),
+               num_frames, k);
+  } else {
+    trace = GenerateTrace(num_pages, num_ops, phase_length);
+    fmt::print(stderr, "[info] generated trace: pages={}, ops={}, phase={}, frames={}, k={}\n", num_pages, num_ops,
+               phase_length, num_frames, k);
+  }
+  if (program.present("--write-trace")) {
+    std::ofstream out(program.get("--write-trace"));
+    bustub::WriteAccessTrace(out, trace);
+  }
+  if (trace.empty()) {
+    std::cerr << "the trace is empty" << std::endl;
+    return 1;
+  }
+
+  for (auto policy : policies) {
+    auto replacer = bustub::MakeReplacer(policy, num_frames, k);
+    auto result = Replay(replacer.get(), num_frames, trace);
+    fmt::print("{:>6}: hit_rate={:.4f}, hits={}, misses={}, {:.1f} ns/op\n", bustub::ReplacementPolicyName(policy),
+               static_cast<double>(result.hits_) / static_cast<double>(trace.size()), result.hits_, result.misses_,
+               static_cast<double>(result.elapsed_ns_) / static_cast<double>(trace.size()));
+  }
+
+  return 0;
+}
@@ -0,0 +1,111 @@
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "fmt/core.h"
+#include "storage/disk/disk_manager.h"
+
+namespace {
+
+const size_t DEFAULT_PAGE_CNT = 25600;
+const size_t DEFAULT_BPM_SIZE = 1024;
+
+/** Write `page_cnt` pages, each stamped with its page id, into a fresh database file. */
+void CreateDatabase(const std::string &db_file, size_t page_cnt) {
+  bustub::DiskManager disk_manager(db_file);
+  alignas(bustub::DIRECT_IO_ALIGNMENT) char data[bustub::BUSTUB_PAGE_SIZE] = {0};
+  for (size_t i = 0; i < page_cnt; i++) {
+    bustub::page_id_t page_id = disk_manager.AllocatePage();
+    std::snprintf(data, sizeof(data), "%d", page_id);
+    disk_manager.WritePage(page_id, data);
+  }
+  disk_manager.ShutDown();
+}
+
+/** Drop the pages of a file from the OS page cache, so that the next scan has to read them from disk. */
+void DropPageCache(const std::string &file_name) {
+  int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  fdatasync(fd);
+  posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  close(fd);
+}
+
+/** Fetch every page in order through a buffer pool smaller than the database. @return pages per second */
+auto Scan(bustub::BufferPoolManager *bpm, size_t page_cnt) -> double {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < page_cnt; i++) {
+    auto page_id = static_cast<bustub::page_id_t>(i);
+    auto guard = bpm->FetchPageRead(page_id, bustub::AccessType::Scan);
+    if (std::stoi(guard.GetData()) != page_id) {
+      throw std::runtime_error("invalid data");
+    }
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return page_cnt / elapsed.count();
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-scan-io-bench");
+  program.add_description(
+      "Compare the throughput of sequential scans over a database file with buffered and O_DIRECT I/O. A cold scan "
+      "starts with the file out of the OS page cache, a warm scan follows right after it.");
+  program.add_argument("--file").default_value(std::string("scan_io_bench.db")).help("the database file to create");
+  program.add_argument("--pages").help("number of pages in the database");
+  program.add_argument("--bpm-size").help("number of frames in the buffer pool");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  auto db_file = program.get<std::string>("--file");
+  size_t page_cnt = DEFAULT_PAGE_CNT;
+  if (program.present("--pages")) {
+    page_cnt = std::stoi(program.get("--pages"));
+  }
+  size_t bpm_size = DEFAULT_BPM_SIZE;
+  if (program.present("--bpm-size")) {
+    bpm_size = std::stoi(program.get("--bpm-size"));
+  }
+
+  fmt::print(stderr, "[info] file={}, total_page={}, bpm_size={}\n", db_file, page_cnt, bpm_size);
+  CreateDatabase(db_file, page_cnt);
+
+  fmt::print("<<< BEGIN\n");
+  for (bool direct_io : {false, true}) {
+    bustub::DiskManager disk_manager(db_file, direct_io);
+    std::string mode = disk_manager.IsDirectIo() ? "direct" : "buffered";
+    if (direct_io && !disk_manager.IsDirectIo()) {
+      fmt::print(stderr, "[warn] O_DIRECT is not supported here, the direct scans are buffered\n");
+    }
+    {
+      auto bpm = std::make_unique<bustub::BufferPoolManager>(bpm_size, &disk_manager);
+      DropPageCache(db_file);
+      fmt::print("{} cold scan: {:.0f} pages/s\n", mode, Scan(bpm.get(), page_cnt));
+      fmt::print("{} warm scan: {:.0f} pages/s\n", mode, Scan(bpm.get(), page_cnt));
+    }
+    disk_manager.ShutDown();
+  }
+  fmt::print(">>> END\n");
+
+  std::remove(db_file.c_str());
+  std::remove((db_file.substr(0, db_file.rfind('.')) + ".log").c_str());
+  return 0;
+}
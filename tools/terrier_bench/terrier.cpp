@@ -1,4 +1,5 @@
 #include <chrono>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <mutex>  // NOLINT
@@ -6,6 +7,7 @@
 #include <sstream>
 #include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include "argparse/argparse.hpp"
@@ -17,6 +19,7 @@
 #include "concurrency/transaction_manager.h"
 #include "fmt/core.h"
 #include "fmt/std.h"
+#include "storage/disk/simulated_disk_manager.h"
 #include "terrier_bench_config.h"
 
 #include <sys/time.h>
@@ -141,6 +144,9 @@ auto main(int argc, char **argv) -> int {
   program.add_argument("--force-create-index").help("create index in terrier bench");
   program.add_argument("--force-enable-update").help("use update statement in terrier bench");
   program.add_argument("--nft").help("number of NFTs in the bench");
+  program.add_argument("--disk-model")
+      .help("simulate a disk: nvme, ssd or hdd, with overrides such as ssd,latency_us=80,parallelism=4");
+  program.add_argument("--disk-trace-out").help("record the disk I/Os of the benchmark into this trace file");
 
   size_t bustub_nft_num = 10;
 
@@ -152,7 +158,15 @@ auto main(int argc, char **argv) -> int {
     return 1;
   }
 
-  auto bustub = std::make_unique<bustub::BustubInstance>();
+  bustub::DiskModel disk_model;
+  if (program.present("--disk-model") && !bustub::ParseDiskModel(program.get("--disk-model"), &disk_model)) {
+    std::cerr << "invalid disk model: " << program.get("--disk-model") << std::endl;
+    return 1;
+  }
+
+  auto disk_manager = std::make_unique<bustub::SimulatedDiskManager>();
+  auto *simulated_disk = disk_manager.get();
+  auto bustub = std::make_unique<bustub::BustubInstance>(std::move(disk_manager));
   auto writer = bustub::SimpleStreamWriter(std::cerr);
 
   // create schema
@@ -234,6 +248,12 @@ auto main(int argc, char **argv) -> int {
     }
   }
 
+  // simulate the disk only after loading the data
+  simulated_disk->SetDiskModel(disk_model);
+  if (program.present("--disk-trace-out")) {
+    simulated_disk->StartIoTrace();
+  }
+
   std::cerr << "x: benchmark start" << std::endl;
 
   std::vector<std::thread> threads;
@@ -476,6 +496,13 @@ auto main(int argc, char **argv) -> int {
     thread.join();
   }
 
+  if (program.present("--disk-trace-out")) {
+    auto trace = simulated_disk->StopIoTrace();
+    std::ofstream out(program.get("--disk-trace-out"));
+    bustub::WriteIoTrace(out, trace);
+    std::cerr << "x: recorded " << trace.size() << " disk I/Os to " << program.get("--disk-trace-out") << std::endl;
+  }
+
   {
     std::stringstream ss;
     auto writer = bustub::SimpleStreamWriter(ss, true);